@@ -23,13 +23,17 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <thread>
 #include <utility>
 #include <iterator>
 
 #include <wx/datetime.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
@@ -45,13 +49,24 @@
 #include "sg/scenegraph.h"
 #include "filename_resolver.h"
 #include "3d_plugin_manager.h"
+#include "3d_render_data_file.h"
 #include "plugins/3dapi/ifsg_api.h"
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
+// name of the file, in the cache directory, holding the metadata and hash of model files
+#define CACHE_INDEX_FILE "file_index.txt"
+#define CACHE_INDEX_HEADER "# KiCad 3D model file index v1"
+
 static wxCriticalSection lock3D_cache;
 
+// protects the file index, which is used by the model loading threads
+static wxCriticalSection lock3D_fileIndex;
+
+// writing a cache file renames the scene graph nodes; one file is written at a time
+static wxCriticalSection lock3D_cacheWrite;
+
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
     for( int i = 0; i < 20; ++i )
@@ -71,6 +86,36 @@ static bool checkTag( const char* aTag, void* aPluginMgrPtr )
     return pp->CheckTag( aTag );
 }
 
+// reads the PluginName:Version string stored after the version tag of a cache file
+static std::string readCachePluginInfo( const wxString& aFileName )
+{
+    #ifdef WIN32
+    std::ifstream file( aFileName.wc_str(), std::ios_base::in | std::ios_base::binary );
+    #else
+    std::ifstream file( aFileName.ToUTF8(), std::ios_base::in | std::ios_base::binary );
+    #endif
+
+    std::string versionTag;
+    std::string pluginInfo;
+
+    // the file starts with "(version tag)(plugin info)"
+    if( file.get() != '(' || !std::getline( file, versionTag, ')' )
+        || file.get() != '(' || !std::getline( file, pluginInfo, ')' ) )
+        return std::string();
+
+    return pluginInfo;
+}
+
+// the key of a model in the cache map; the normal level of detail is keyed by the
+// file name alone
+static wxString cacheKey( const wxString& aFileName, int aLevel )
+{
+    if( aLevel == S3D::LOD_NORMAL )
+        return aFileName;
+
+    return aFileName + wxString::Format( wxT( "#lod%d" ), aLevel );
+}
+
 static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 {
     unsigned char uc;
@@ -104,6 +149,35 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
     return wxString::FromUTF8Unchecked( sha1 );
 }
 
+static bool sha1FromString( const std::string& aString, unsigned char* aSHA1Sum )
+{
+    if( aString.size() != 40 )
+        return false;
+
+    for( int i = 0; i < 20; ++i )
+    {
+        unsigned char uc = 0;
+
+        for( int j = 0; j < 2; ++j )
+        {
+            char c = aString[i * 2 + j];
+
+            uc <<= 4;
+
+            if( c >= '0' && c <= '9' )
+                uc |= c - '0';
+            else if( c >= 'a' && c <= 'f' )
+                uc |= c - 'a' + 10;
+            else
+                return false;
+        }
+
+        aSHA1Sum[i] = uc;
+    }
+
+    return true;
+}
+
 
 class S3D_CACHE_ENTRY
 {
@@ -112,7 +186,7 @@ private:
     S3D_CACHE_ENTRY( const S3D_CACHE_ENTRY& source );
     S3D_CACHE_ENTRY& operator=( const S3D_CACHE_ENTRY& source );
 
-    wxString m_CacheBaseName;  // base name of cache file (a SHA1 digest)
+    wxString m_CacheBaseName;  // base name of cache file (a SHA1 digest and the level)
 
 public:
     S3D_CACHE_ENTRY();
@@ -121,11 +195,17 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // free the render data, allocated or mapped from a render data file
+    void FreeRenderData( void );
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    S3D_RENDER_DATA_FILE* renderFile;   // mapped render data file, if renderData is in it
+    bool          scenePending; // true if sceneData was not loaded yet (renderData was mapped)
+    int           level;        // level of detail (one of S3D::LOD)
 };
 
 
@@ -133,6 +213,9 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    renderFile = NULL;
+    scenePending = false;
+    level = S3D::LOD_NORMAL;
     memset( sha1sum, 0, 20 );
 }
 
@@ -142,6 +225,19 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
+    FreeRenderData();
+}
+
+
+void S3D_CACHE_ENTRY::FreeRenderData( void )
+{
+    if( NULL != renderFile )
+    {
+        delete renderFile;
+        renderFile = NULL;
+        renderData = NULL;
+    }
+
     if( NULL != renderData )
         S3D::Destroy3DModel( &renderData );
 }
@@ -171,8 +267,15 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
 const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 {
     if( m_CacheBaseName.empty() )
+    {
         m_CacheBaseName = sha1ToWXString( sha1sum );
 
+        // the normal level keeps the names of the cache files written before the
+        // levels of detail were introduced
+        if( level != S3D::LOD_NORMAL )
+            m_CacheBaseName << wxString::Format( wxT( "-lod%d" ), level );
+    }
+
     return m_CacheBaseName;
 }
 
@@ -180,6 +283,7 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 S3D_CACHE::S3D_CACHE()
 {
     m_DirtyCache = false;
+    m_FileIndexLoaded = false;
     m_FNResolver = new FILENAME_RESOLVER;
     m_Plugins = new S3D_PLUGIN_MANAGER;
 
@@ -200,7 +304,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderDataOnly, int aLevel )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -217,8 +322,9 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
 
     // check cache if file is already loaded
     wxCriticalSectionLocker lock( lock3D_cache );
+    int level = getLevel( full3Dpath, aLevel );
     std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    mi = m_CacheMap.find( cacheKey( full3Dpath, level ) );
 
     if( mi != m_CacheMap.end() )
     {
@@ -232,7 +338,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
             if( fmdate != mi->second->modTime )
             {
                 unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
+                getFileHash( full3Dpath, hashSum );
                 mi->second->modTime = fmdate;
 
                 if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
@@ -250,13 +356,20 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
                     mi->second->sceneData = NULL;
                 }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
-
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                mi->second->FreeRenderData();
+                mi->second->scenePending = false;
+                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
+                                                                mi->second->pluginInfo, level );
             }
         }
 
+        // the render data was read from the render data file, without the scene data
+        if( !aRenderDataOnly && mi->second->scenePending )
+        {
+            mi->second->scenePending = false;
+            loadSceneData( full3Dpath, mi->second );
+        }
+
         if( NULL != aCachePtr )
             *aCachePtr = mi->second;
 
@@ -264,7 +377,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aRenderDataOnly, level );
 }
 
 
@@ -274,56 +387,36 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aRenderDataOnly, int aLevel )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
 
-    unsigned char sha1sum[20];
+    S3D_CACHE_ENTRY* ep = addCacheEntry( aFileName, aLevel );
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
-    {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
+    if( NULL == ep )
+        return NULL;
 
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            #ifdef DEBUG
-            do {
-                std::ostringstream ostr;
-                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-                ostr << " * [BUG] duplicate entry in map file; key = '";
-                ostr << aFileName.ToUTF8() << "'";
-                wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
-            } while( 0 );
-            #endif
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
+    if( aCachePtr )
+        *aCachePtr = ep;
 
-        }
+    loadCacheEntry( aFileName, ep, aRenderDataOnly );
+
+    return ep->sceneData;
+}
 
-        return NULL;
-    }
 
+S3D_CACHE_ENTRY* S3D_CACHE::addCacheEntry( const wxString& aFileName, int aLevel )
+{
     S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
     m_CacheList.push_back( ep );
     wxFileName fname( aFileName );
     ep->modTime = fname.GetModificationTime();
+    ep->level = aLevel;
 
     if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
+                               ( cacheKey( aFileName, aLevel ), ep ) ).second == false )
     {
         #ifdef DEBUG
         do {
@@ -340,23 +433,56 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
         return NULL;
     }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return ep;
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
-    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+int S3D_CACHE::getLevel( const wxString& aFileName, int aLevel )
+{
+    if( aLevel == S3D::LOD_NORMAL || aLevel < 0 || aLevel >= S3D::LOD_END
+        || !m_Plugins->HasLevelsOfDetail( aFileName ) )
+        return S3D::LOD_NORMAL;
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    return aLevel;
+}
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+void S3D_CACHE::loadCacheEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                                bool aRenderDataOnly )
+{
+    unsigned char sha1sum[20];
 
-    return ep->sceneData;
+    // just in case we can't get a hash digest (for example, on access issues)
+    // or we do not have a configured cache file directory, the entry is left
+    // empty to prevent further attempts at loading the file
+    if( !getFileHash( aFileName, sha1sum ) || m_CacheDir.empty() )
+        return;
+
+    aCacheItem->SetSHA1( sha1sum );
+
+    if( aRenderDataOnly && loadRenderData( aCacheItem ) )
+    {
+        aCacheItem->scenePending = true;
+        return;
+    }
+
+    loadSceneData( aFileName, aCacheItem );
+}
+
+
+void S3D_CACHE::loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
+
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo,
+                                                     aCacheItem->level );
+
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 }
 
 
@@ -428,6 +554,148 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
 }
 
 
+bool S3D_CACHE::getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxStructStat fileStat;
+
+    if( aFileName.empty() || NULL == aSHA1Sum || wxStat( aFileName, &fileStat ) != 0 )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    FILE_METADATA meta;
+    meta.size = fileStat.st_size;
+    meta.modTime = fileStat.st_mtime;
+    meta.inode = fileStat.st_ino;
+
+    {
+        wxCriticalSectionLocker lock( lock3D_fileIndex );
+
+        loadFileIndex();
+
+        std::map< wxString, FILE_METADATA, rsort_wxString >::iterator mi;
+        mi = m_FileIndex.find( aFileName );
+
+        if( mi != m_FileIndex.end() && mi->second.size == meta.size
+            && mi->second.modTime == meta.modTime && mi->second.inode == meta.inode )
+        {
+            memcpy( aSHA1Sum, mi->second.sha1sum, 20 );
+            return true;
+        }
+    }
+
+    // the file is new or was modified; its content has to be hashed
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    memcpy( meta.sha1sum, aSHA1Sum, 20 );
+
+    wxCriticalSectionLocker lock( lock3D_fileIndex );
+    m_FileIndex[aFileName] = meta;
+    m_DirtyCache = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadFileIndex()
+{
+    if( m_FileIndexLoaded || m_CacheDir.empty() )
+        return;
+
+    m_FileIndexLoaded = true;
+
+    wxString fname = m_CacheDir + wxT( CACHE_INDEX_FILE );
+
+    if( !wxFileName::FileExists( fname ) )
+        return;
+
+    #ifdef WIN32
+    std::ifstream file( fname.wc_str() );
+    #else
+    std::ifstream file( fname.ToUTF8() );
+    #endif
+
+    std::string line;
+
+    if( !std::getline( file, line ) || line != CACHE_INDEX_HEADER )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] ignoring invalid file index '%s'\n",
+            fname.GetData() );
+        return;
+    }
+
+    // each line holds: sha1 size mtime inode path
+    while( std::getline( file, line ) )
+    {
+        std::istringstream istr( line );
+        std::string sha1;
+        std::string path;
+        FILE_METADATA meta;
+
+        if( !( istr >> sha1 >> meta.size >> meta.modTime >> meta.inode ) )
+            continue;
+
+        if( !sha1FromString( sha1, meta.sha1sum ) )
+            continue;
+
+        istr.ignore( 1 );   // separator
+
+        if( !std::getline( istr, path ) || path.empty() )
+            continue;
+
+        m_FileIndex[wxString::FromUTF8( path.c_str() )] = meta;
+    }
+}
+
+
+bool S3D_CACHE::saveFileIndex()
+{
+    wxCriticalSectionLocker lock( lock3D_fileIndex );
+
+    if( !m_DirtyCache || m_CacheDir.empty() )
+        return true;
+
+    wxString fname = m_CacheDir + wxT( CACHE_INDEX_FILE );
+    wxString tmpname = fname + wxT( ".tmp" );
+
+    // write to a temporary file first so an interrupted write can't leave
+    // a truncated index behind
+    {
+        #ifdef WIN32
+        std::ofstream file( tmpname.wc_str(), std::ios_base::out | std::ios_base::trunc );
+        #else
+        std::ofstream file( tmpname.ToUTF8(), std::ios_base::out | std::ios_base::trunc );
+        #endif
+
+        if( !file.is_open() )
+        {
+            wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write file index '%s'\n",
+                tmpname.GetData() );
+            return false;
+        }
+
+        file << CACHE_INDEX_HEADER << "\n";
+
+        std::map< wxString, FILE_METADATA, rsort_wxString >::const_iterator mi;
+
+        for( mi = m_FileIndex.begin(); mi != m_FileIndex.end(); ++mi )
+        {
+            file << sha1ToWXString( mi->second.sha1sum ).ToUTF8() << " ";
+            file << mi->second.size << " " << mi->second.modTime << " ";
+            file << mi->second.inode << " " << mi->first.ToUTF8() << "\n";
+        }
+
+        if( !file.good() )
+            return false;
+    }
+
+    if( !wxRenameFile( tmpname, fname, true ) )
+        return false;
+
+    m_DirtyCache = false;
+    return true;
+}
+
+
 bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     wxString bname = aCacheItem->GetCacheBaseName();
@@ -467,6 +735,9 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL == aCacheItem->sceneData )
         return false;
 
+    // keep the plugin info, which is written to the render data file
+    aCacheItem->pluginInfo = readCachePluginInfo( fname );
+
     return true;
 }
 
@@ -534,11 +805,56 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    wxCriticalSectionLocker lock( lock3D_cacheWrite );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
 
 
+bool S3D_CACHE::loadRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dr" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    std::string pluginInfo;
+    S3D_RENDER_DATA_FILE* file = S3D_RENDER_DATA_FILE::Read( fname, pluginInfo );
+
+    if( NULL == file )
+        return false;
+
+    // the model has to be loaded again if it was written by another version of the plugin
+    if( !checkTag( pluginInfo.c_str(), m_Plugins ) )
+    {
+        delete file;
+        return false;
+    }
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->pluginInfo = pluginInfo;
+    aCacheItem->renderFile = file;
+    aCacheItem->renderData = file->GetModel();
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    // without the plugin info the file could not be checked when it is read
+    if( NULL == aCacheItem->renderData || NULL != aCacheItem->renderFile
+        || aCacheItem->pluginInfo.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dr" );
+
+    return S3D_RENDER_DATA_FILE::Write( fname, *aCacheItem->renderData,
+                                        aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -750,6 +1066,8 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters( void ) const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    saveFileIndex();
+
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -778,10 +1096,79 @@ void S3D_CACHE::ClosePlugins( void )
 }
 
 
-S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
+void S3D_CACHE::LoadModels( const std::vector< wxString >& aModelFiles, int aLevel )
+{
+    std::vector< std::pair< wxString, S3D_CACHE_ENTRY* > > toLoad;
+
+    {
+        wxCriticalSectionLocker lock( lock3D_cache );
+
+        for( const wxString& modelFile : aModelFiles )
+        {
+            wxString full3Dpath = m_FNResolver->ResolvePath( modelFile );
+
+            if( full3Dpath.empty() )
+                continue;
+
+            int level = getLevel( full3Dpath, aLevel );
+
+            // models which are requested twice or are already in the cache are skipped;
+            // GetModel() checks the cached ones for modifications
+            if( m_CacheMap.find( cacheKey( full3Dpath, level ) ) != m_CacheMap.end() )
+                continue;
+
+            S3D_CACHE_ENTRY* ep = addCacheEntry( full3Dpath, level );
+
+            if( ep )
+                toLoad.push_back( std::make_pair( full3Dpath, ep ) );
+        }
+    }
+
+    if( toLoad.empty() )
+        return;
+
+    // The plugins need the C locale. It is switched once for all the threads,
+    // as setlocale() must not be called while other threads are parsing files
+    LOCALE_IO toggle;
+
+    size_t parallelThreadCount = std::max( std::thread::hardware_concurrency(), 2U );
+    parallelThreadCount = std::min( parallelThreadCount, toLoad.size() );
+
+    std::atomic<size_t> nextItem( 0 );
+    std::vector<std::thread> loadWorkers;
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        loadWorkers.push_back( std::thread( [&]()
+        {
+            for( size_t i = nextItem.fetch_add( 1 ); i < toLoad.size();
+                 i = nextItem.fetch_add( 1 ) )
+            {
+                S3D_CACHE_ENTRY* ep = toLoad[i].second;
+
+                loadCacheEntry( toLoad[i].first, ep, true );
+
+                if( NULL == ep->renderData && NULL != ep->sceneData )
+                {
+                    ep->renderData = S3D::GetModel( ep->sceneData );
+                    saveRenderData( ep );
+                }
+            }
+        } ) );
+    }
+
+    for( auto& worker : loadWorkers )
+        worker.join();
+}
+
+
+S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName, int aLevel )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    SCENEGRAPH* sp = load( aModelFileName, &cp, true, aLevel );
+
+    if( cp && cp->renderData )
+        return cp->renderData;
 
     if( !sp )
         return NULL;
@@ -800,11 +1187,9 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
         return NULL;
     }
 
-    if( cp->renderData )
-        return cp->renderData;
-
     S3DMODEL* mp = S3D::GetModel( sp );
     cp->renderData = mp;
+    saveRenderData( cp );
 
     return mp;
 }
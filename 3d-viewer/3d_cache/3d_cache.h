@@ -31,11 +31,13 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <wx/string.h>
 #include "kicad_string.h"
 #include "filename_resolver.h"
 #include "3d_info.h"
 #include "plugins/3dapi/c3dmodel.h"
+#include "plugins/3d/3d_lod.h"
 
 
 class  PGM_BASE;
@@ -44,15 +46,26 @@ class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
+class  S3D_RENDER_DATA_FILE;
 
 
 class S3D_CACHE
 {
 private:
+    /// metadata and hash of a model file, used to avoid hashing unchanged files
+    struct FILE_METADATA
+    {
+        long long     size;         // file size in bytes
+        long long     modTime;      // modification time, seconds since the epoch
+        long long     inode;        // file serial number (0 if not supported)
+        unsigned char sha1sum[20];
+    };
+
     /// cache entries
     std::list< S3D_CACHE_ENTRY* > m_CacheList;
 
-    /// mapping of file names to cache names and data
+    /// mapping of file names to cache names and data; the entries of the levels
+    /// of detail other than S3D::LOD_NORMAL have a suffix appended to the file name
     std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString > m_CacheMap;
 
     /// object to resolve file names
@@ -61,7 +74,13 @@ private:
     /// plugin manager
     S3D_PLUGIN_MANAGER* m_Plugins;
 
-    /// set true if the cache needs to be updated
+    /// metadata and hash of the model files, persisted in the cache directory
+    std::map< wxString, FILE_METADATA, rsort_wxString > m_FileIndex;
+
+    /// set true once the file index was read from the cache directory
+    bool m_FileIndexLoaded;
+
+    /// set true if the cache (file index) needs to be updated
     bool m_DirtyCache;
 
     /// 3D cache directory
@@ -81,10 +100,31 @@ private:
      *
      * @param[in]   aFileName   file name (full or partial path)
      * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aRenderDataOnly true if only the render data is needed; the scene
+     *                          data is not loaded if the render data is in the cache
+     * @param[in]   aLevel      level of detail of the model, as returned by getLevel()
      * @return      SCENEGRAPH object associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aRenderDataOnly = false, int aLevel = S3D::LOD_NORMAL );
+
+    // add an empty cache entry for a file name and level of detail; returns NULL if
+    // the entry already exists
+    S3D_CACHE_ENTRY* addCacheEntry( const wxString& aFileName, int aLevel = S3D::LOD_NORMAL );
+
+    // returns the level of detail a model file is cached at: aLevel if the plugin
+    // loading the file supports levels of detail, S3D::LOD_NORMAL otherwise, so the
+    // models which are the same at all levels are cached once
+    int getLevel( const wxString& aFileName, int aLevel );
+
+    // load the render data or the scene data of a cache entry from the cache files,
+    // or the scene data with the plugins
+    void loadCacheEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                         bool aRenderDataOnly = false );
+
+    // load the scene data of a cache entry from the cache file or with the plugins
+    void loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -97,14 +137,40 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function getFileHash
+     * retrieves the SHA1 hash of the given file; the hash is only calculated
+     * if the size, modification time or inode of the file differ from the
+     * ones recorded in the file index
+     *
+     * @param[in]   aFileName   file name (full path)
+     * @param[out]  aSHA1Sum    a 20 byte character array to hold the SHA1 hash
+     * @retval      true        success
+     * @retval      false       failure
+     */
+    bool getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum );
+
+    // read the file index from the cache directory
+    void loadFileIndex();
+
+    // write the file index to the cache directory, if it was modified
+    bool saveFileIndex();
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // map the render data of a model from a render data file
+    bool loadRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save the render data of a model to a render data file
+    bool saveRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderDataOnly = false, int aLevel = S3D::LOD_NORMAL );
 
 public:
     S3D_CACHE();
@@ -196,9 +262,24 @@ public:
      * into an S3D_MODEL structure for display by a renderer
      *
      * @param aModelFileName is the full path to the model to be loaded
+     * @param aLevel is the level of detail (one of S3D::LOD); the levels of a
+     * model are cached separately
      * @return is a pointer to the render data or NULL if not available
      */
-    S3DMODEL* GetModel( const wxString& aModelFileName );
+    S3DMODEL* GetModel( const wxString& aModelFileName, int aLevel = S3D::LOD_NORMAL );
+
+    /**
+     * Function LoadModels
+     * loads the scene and render data of a list of models with several threads,
+     * so the following calls to GetModel() return them from the cache. Each file
+     * is loaded once, however many times it is listed; the files which are already
+     * in the cache are left to GetModel().
+     *
+     * @param aModelFiles is the list of partial or full paths of the models to load
+     * @param aLevel is the level of detail (one of S3D::LOD) to load the models at
+     */
+    void LoadModels( const std::vector< wxString >& aModelFiles,
+                     int aLevel = S3D::LOD_NORMAL );
 
     wxString GetModelHash( const wxString& aModelFileName );
 };
@@ -485,7 +485,35 @@ std::list< wxString > const* S3D_PLUGIN_MANAGER::GetFileFilters( void ) const
 }
 
 
-SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::string& aPluginInfo )
+bool S3D_PLUGIN_MANAGER::HasLevelsOfDetail( const wxString& aFileName )
+{
+    wxFileName raw( aFileName );
+    wxString ext = raw.GetExt();
+
+    #ifdef WIN32
+    ext.LowerCase();
+    #endif
+
+    std::pair < std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator,
+        std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator > items;
+
+    items = m_ExtMap.equal_range( ext );
+
+    // these calls may reopen the plugins
+    wxCriticalSectionLocker lock( m_pluginLock );
+
+    for( auto sL = items.first; sL != items.second; ++sL )
+    {
+        if( sL->second->CanRender() && sL->second->HasLevelsOfDetail() )
+            return true;
+    }
+
+    return false;
+}
+
+
+SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::string& aPluginInfo,
+                                             int aLevel )
 {
     wxFileName raw( aFileName );
     wxString ext = raw.GetExt();
@@ -504,13 +532,35 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
-        if( sL->second->CanRender() )
+        KICAD_PLUGIN_LDR_3D* plugin = sL->second;
+        bool canRender;
+        bool threadSafe;
+
         {
-            SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
+            // these calls may reopen the plugin
+            wxCriticalSectionLocker lock( m_pluginLock );
+            canRender = plugin->CanRender();
+            threadSafe = canRender && plugin->IsThreadSafe();
+        }
+
+        if( canRender )
+        {
+            SCENEGRAPH* sp;
+
+            if( threadSafe )
+            {
+                sp = plugin->Load( aFileName.ToUTF8(), aLevel );
+            }
+            else
+            {
+                wxCriticalSectionLocker lock( m_loadLock );
+                sp = plugin->Load( aFileName.ToUTF8(), aLevel );
+            }
 
             if( NULL != sp )
             {
-                sL->second->GetPluginInfo( aPluginInfo );
+                wxCriticalSectionLocker lock( m_pluginLock );
+                plugin->GetPluginInfo( aPluginInfo );
                 return sp;
             }
         }
@@ -563,6 +613,8 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     pname = tname.substr( 0, cpos );
     std::string ptag;   // tag from the plugin
 
+    wxCriticalSectionLocker lock( m_pluginLock );
+
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pS = m_Plugins.begin();
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pE = m_Plugins.end();
 
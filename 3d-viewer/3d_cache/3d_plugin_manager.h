@@ -33,6 +33,8 @@
 #include <list>
 #include <string>
 #include <wx/string.h>
+#include <wx/thread.h>
+#include "plugins/3d/3d_lod.h"
 
 class wxWindow;
 class KICAD_PLUGIN_LDR_3D;
@@ -50,6 +52,12 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// protects the plugin loaders, which may be reopened when models are loaded
+    wxCriticalSection m_pluginLock;
+
+    /// serializes the model loads of plugins which are not thread safe
+    wxCriticalSection m_loadLock;
+
     /// load plugins
     void loadPlugins( void );
 
@@ -82,7 +90,23 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const;
 
-    SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
+    /**
+     * Function HasLevelsOfDetail
+     * returns true if a plugin able to render the given file loads it
+     * differently at each level of detail
+     */
+    bool HasLevelsOfDetail( const wxString& aFileName );
+
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin able to render it; it may be called
+     * from several threads at once, the loads of plugins which are not thread
+     * safe are serialized
+     *
+     * @param aLevel is the level of detail (one of S3D::LOD) passed to the plugin
+     */
+    SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo,
+                             int aLevel = S3D::LOD_NORMAL );
 
     /**
      * Function ClosePlugins
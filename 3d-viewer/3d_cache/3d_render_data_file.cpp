@@ -0,0 +1,319 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_render_data_file.cpp
+ */
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include "streamwrapper.h"
+#include "3d_render_data_file.h"
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+// File layout, all the values in the byte order of the machine which wrote the file:
+//   FILE_HEADER
+//   plugin info string, padded to a multiple of 4 bytes
+//   SMATERIAL[materialsSize]
+//   MESH_HEADER[meshesSize]
+//   for each mesh: positions, normals, texture coordinates (optional),
+//   colors (optional), face indexes
+// Every item has a size multiple of 4 bytes, so the arrays are aligned for
+// direct use when the file is mapped at a page boundary.
+
+static const char     FILE_MAGIC[8] = { 'K', 'I', 'C', 'A', 'D', '3', 'D', 'R' };
+static const uint32_t FILE_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+enum MESH_FLAGS
+{
+    MESH_HAS_TEXCOORDS = 1,
+    MESH_HAS_COLORS = 2
+};
+
+struct FILE_HEADER
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint32_t pluginInfoSize;
+    uint32_t materialsSize;
+    uint32_t meshesSize;
+    uint32_t reserved;
+};
+
+struct MESH_HEADER
+{
+    uint32_t vertexSize;
+    uint32_t faceIdxSize;
+    uint32_t materialIdx;
+    uint32_t flags;
+};
+
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "unexpected SFVEC2F layout" );
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "unexpected SFVEC3F layout" );
+static_assert( sizeof( SMATERIAL ) == 14 * sizeof( float ), "unexpected SMATERIAL layout" );
+
+
+static uint64_t padded( uint64_t aSize )
+{
+    return ( aSize + 3 ) & ~(uint64_t) 3;
+}
+
+
+static uint64_t meshDataSize( const MESH_HEADER& aMesh )
+{
+    uint64_t vertexBytes = 2 * sizeof( SFVEC3F );
+
+    if( aMesh.flags & MESH_HAS_TEXCOORDS )
+        vertexBytes += sizeof( SFVEC2F );
+
+    if( aMesh.flags & MESH_HAS_COLORS )
+        vertexBytes += sizeof( SFVEC3F );
+
+    return vertexBytes * aMesh.vertexSize + sizeof( unsigned int ) * (uint64_t) aMesh.faceIdxSize;
+}
+
+
+S3D_RENDER_DATA_FILE::S3D_RENDER_DATA_FILE()
+{
+    m_model.m_MeshesSize = 0;
+    m_model.m_Meshes = NULL;
+    m_model.m_MaterialsSize = 0;
+    m_model.m_Materials = NULL;
+}
+
+
+S3D_RENDER_DATA_FILE::~S3D_RENDER_DATA_FILE()
+{
+    delete [] m_model.m_Meshes;
+}
+
+
+bool S3D_RENDER_DATA_FILE::Write( const wxString& aFileName, const S3DMODEL& aModel,
+                                  const std::string& aPluginInfo )
+{
+    std::vector< MESH_HEADER > meshes( aModel.m_MeshesSize );
+
+    FILE_HEADER header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, FILE_MAGIC, sizeof( header.magic ) );
+    header.version = FILE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.pluginInfoSize = aPluginInfo.size();
+    header.materialsSize = aModel.m_MaterialsSize;
+    header.meshesSize = aModel.m_MeshesSize;
+    header.fileSize = sizeof( FILE_HEADER ) + padded( aPluginInfo.size() )
+                      + sizeof( SMATERIAL ) * (uint64_t) aModel.m_MaterialsSize
+                      + sizeof( MESH_HEADER ) * (uint64_t) aModel.m_MeshesSize;
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+
+        meshes[i].vertexSize = mesh.m_VertexSize;
+        meshes[i].faceIdxSize = mesh.m_FaceIdxSize;
+        meshes[i].materialIdx = mesh.m_MaterialIdx;
+        meshes[i].flags = ( mesh.m_Texcoords ? MESH_HAS_TEXCOORDS : 0 )
+                          | ( mesh.m_Color ? MESH_HAS_COLORS : 0 );
+
+        header.fileSize += meshDataSize( meshes[i] );
+    }
+
+    // the file is written under a temporary name, so the threads loading models never
+    // map a partially written file
+    wxString tmpName = wxFileName::CreateTempFileName( aFileName );
+
+    if( tmpName.empty() )
+        return false;
+
+    bool ok;
+
+    {
+        OPEN_OSTREAM( output, tmpName.ToUTF8() );
+
+        const char padding[4] = { 0, 0, 0, 0 };
+
+        output.write( (const char*) &header, sizeof( header ) );
+        output.write( aPluginInfo.data(), aPluginInfo.size() );
+        output.write( padding, padded( aPluginInfo.size() ) - aPluginInfo.size() );
+        output.write( (const char*) aModel.m_Materials,
+                      sizeof( SMATERIAL ) * aModel.m_MaterialsSize );
+
+        if( !meshes.empty() )
+            output.write( (const char*) &meshes[0], sizeof( MESH_HEADER ) * meshes.size() );
+
+        for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+        {
+            const SMESH& mesh = aModel.m_Meshes[i];
+
+            output.write( (const char*) mesh.m_Positions, sizeof( SFVEC3F ) * mesh.m_VertexSize );
+            output.write( (const char*) mesh.m_Normals, sizeof( SFVEC3F ) * mesh.m_VertexSize );
+
+            if( mesh.m_Texcoords )
+                output.write( (const char*) mesh.m_Texcoords,
+                              sizeof( SFVEC2F ) * mesh.m_VertexSize );
+
+            if( mesh.m_Color )
+                output.write( (const char*) mesh.m_Color, sizeof( SFVEC3F ) * mesh.m_VertexSize );
+
+            output.write( (const char*) mesh.m_FaceIdx,
+                          sizeof( unsigned int ) * mesh.m_FaceIdxSize );
+        }
+
+        ok = !output.fail();
+        CLOSE_STREAM( output );
+    }
+
+    if( !ok || !wxRenameFile( tmpName, aFileName, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write render data '%s'\n",
+            aFileName.GetData() );
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    return true;
+}
+
+
+S3D_RENDER_DATA_FILE* S3D_RENDER_DATA_FILE::Read( const wxString& aFileName,
+                                                  std::string& aPluginInfo )
+{
+    std::unique_ptr< S3D_RENDER_DATA_FILE > file( new S3D_RENDER_DATA_FILE );
+
+    try
+    {
+        using namespace boost::interprocess;
+
+        // the name is converted as in Write(), not with the current locale
+        OPEN_FILE_MAPPING( mapping, aFileName.ToUTF8(), read_only );
+
+        // the pages are copied on write, the model data can be modified in memory
+        mapped_region region( mapping, copy_on_write );
+
+        file->m_region.swap( region );
+    }
+    catch( const boost::interprocess::interprocess_exception& e )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot map render data '%s': %s\n",
+            aFileName.GetData(), e.what() );
+        return NULL;
+    }
+
+    if( !file->parse( aPluginInfo ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] ignoring invalid render data '%s'\n",
+            aFileName.GetData() );
+        return NULL;
+    }
+
+    return file.release();
+}
+
+
+bool S3D_RENDER_DATA_FILE::parse( std::string& aPluginInfo )
+{
+    char* base = (char*) m_region.get_address();
+    uint64_t size = m_region.get_size();
+    uint64_t offset = 0;
+
+    // returns the next aBytes of the file or NULL if the file is too short
+    auto take = [&]( uint64_t aBytes ) -> char*
+    {
+        if( aBytes > size - offset )
+            return NULL;
+
+        char* data = base + offset;
+        offset += aBytes;
+
+        return data;
+    };
+
+    const FILE_HEADER* header = (const FILE_HEADER*) take( sizeof( FILE_HEADER ) );
+
+    if( !header || memcmp( header->magic, FILE_MAGIC, sizeof( header->magic ) )
+        || header->version != FILE_VERSION || header->byteOrder != BYTE_ORDER_MARK
+        || header->fileSize != size )
+        return false;
+
+    const char* pluginInfo = take( padded( header->pluginInfoSize ) );
+    SMATERIAL* materials = (SMATERIAL*) take( sizeof( SMATERIAL ) * header->materialsSize );
+    const MESH_HEADER* meshes =
+            (const MESH_HEADER*) take( sizeof( MESH_HEADER ) * header->meshesSize );
+
+    if( !pluginInfo || !materials || !meshes )
+        return false;
+
+    aPluginInfo.assign( pluginInfo, header->pluginInfoSize );
+
+    m_model.m_Materials = materials;
+    m_model.m_MaterialsSize = header->materialsSize;
+    m_model.m_Meshes = new SMESH[header->meshesSize];
+    m_model.m_MeshesSize = header->meshesSize;
+
+    for( uint32_t i = 0; i < header->meshesSize; ++i )
+    {
+        const MESH_HEADER& meshHeader = meshes[i];
+        SMESH& mesh = m_model.m_Meshes[i];
+        const uint64_t vertexSize = meshHeader.vertexSize;
+
+        if( meshHeader.materialIdx >= header->materialsSize )
+            return false;
+
+        mesh.m_VertexSize = meshHeader.vertexSize;
+        mesh.m_FaceIdxSize = meshHeader.faceIdxSize;
+        mesh.m_MaterialIdx = meshHeader.materialIdx;
+        mesh.m_Positions = (SFVEC3F*) take( sizeof( SFVEC3F ) * vertexSize );
+        mesh.m_Normals = (SFVEC3F*) take( sizeof( SFVEC3F ) * vertexSize );
+        mesh.m_Texcoords = NULL;
+        mesh.m_Color = NULL;
+
+        if( meshHeader.flags & MESH_HAS_TEXCOORDS )
+            mesh.m_Texcoords = (SFVEC2F*) take( sizeof( SFVEC2F ) * vertexSize );
+
+        if( meshHeader.flags & MESH_HAS_COLORS )
+            mesh.m_Color = (SFVEC3F*) take( sizeof( SFVEC3F ) * vertexSize );
+
+        mesh.m_FaceIdx = (unsigned int*) take( sizeof( unsigned int ) * meshHeader.faceIdxSize );
+
+        if( !mesh.m_Positions || !mesh.m_Normals || !mesh.m_FaceIdx
+            || ( ( meshHeader.flags & MESH_HAS_TEXCOORDS ) && !mesh.m_Texcoords )
+            || ( ( meshHeader.flags & MESH_HAS_COLORS ) && !mesh.m_Color ) )
+            return false;
+    }
+
+    return offset == size;
+}
@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_render_data_file.h
+ * defines the binary cache file holding the render data (S3DMODEL) of a model
+ *
+ * The file stores the materials and the per mesh vertex, normal, texture
+ * coordinate, color and index arrays contiguously, in the layout used in
+ * memory, so a cached model is memory mapped and handed to the renderers
+ * without reading the scene graph and converting it.
+ */
+
+#ifndef RENDER_DATA_FILE_3D_H
+#define RENDER_DATA_FILE_3D_H
+
+#include <string>
+#include <boost/interprocess/mapped_region.hpp>
+#include <wx/string.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+
+class S3D_RENDER_DATA_FILE
+{
+private:
+    /// the mapped file; the file itself is closed once mapped
+    boost::interprocess::mapped_region m_region;
+
+    /// the model; only the mesh list is allocated, the arrays point to the mapped file
+    S3DMODEL m_model;
+
+    S3D_RENDER_DATA_FILE();
+
+    // prohibit assignment and default copy constructor
+    S3D_RENDER_DATA_FILE( const S3D_RENDER_DATA_FILE& source );
+    S3D_RENDER_DATA_FILE& operator=( const S3D_RENDER_DATA_FILE& source );
+
+    // set up m_model from the mapped file; returns false if the file is not valid
+    bool parse( std::string& aPluginInfo );
+
+public:
+    ~S3D_RENDER_DATA_FILE();
+
+    /**
+     * Function Write
+     * writes the render data of a model to a file
+     *
+     * @param aFileName is the name of the file to write
+     * @param aModel is the model
+     * @param aPluginInfo is the name and version of the plugin which loaded the model
+     * @return true on success
+     */
+    static bool Write( const wxString& aFileName, const S3DMODEL& aModel,
+                       const std::string& aPluginInfo );
+
+    /**
+     * Function Read
+     * maps a render data file in memory
+     *
+     * @param aFileName is the name of the file to read
+     * @param aPluginInfo [out] is the name and version of the plugin which loaded the model
+     * @return the mapped file or NULL if the file can't be read or was written by
+     * another version of the file format
+     */
+    static S3D_RENDER_DATA_FILE* Read( const wxString& aFileName, std::string& aPluginInfo );
+
+    /**
+     * Function GetModel
+     * @return the model, which is valid as long as the file is mapped; its data
+     * can be modified, the changes are not written to the file
+     */
+    S3DMODEL* GetModel() { return &m_model; }
+};
+
+#endif  // RENDER_DATA_FILE_3D_H
@@ -61,6 +61,10 @@ CINFO3D_VISU::CINFO3D_VISU() :
     m_render_engine = RENDER_ENGINE_OPENGL_LEGACY;
     m_material_mode = MATERIAL_MODE_NORMAL;
 
+    m_buildStage = BUILD_STAGE_FINISHED;
+    m_buildStageReady = false;
+    m_buildCancel = false;
+
     m_boardPos = wxPoint();
     m_boardSize = wxSize();
     m_boardCenter = SFVEC3F( 0.0f );
@@ -116,6 +120,7 @@ CINFO3D_VISU::CINFO3D_VISU() :
 
 CINFO3D_VISU::~CINFO3D_VISU()
 {
+    CancelBuild();
     destroyLayers();
 }
 
@@ -272,6 +277,145 @@ void CINFO3D_VISU::InitSettings( REPORTER *aStatusTextReporter )
 {
     wxLogTrace( m_logTrace, wxT( "CINFO3D_VISU::InitSettings" ) );
 
+    CancelBuild();
+
+    createBoardDimensions();
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_startCreateBoardPolyTime = GetRunningMicroSecs();
+#endif
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Build board body" ) );
+
+    createBoardPolygon();
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_stopCreateBoardPolyTime = GetRunningMicroSecs();
+    unsigned stats_startCreateLayersTime = stats_stopCreateBoardPolyTime;
+#endif
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create layers" ) );
+
+    destroyLayers();
+
+    createCopperLayers( aStatusTextReporter );
+    processCopperLayers();
+
+    createTechLayers( aStatusTextReporter );
+    processTechLayers();
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_stopCreateLayersTime = GetRunningMicroSecs();
+
+    printf( "CINFO3D_VISU::InitSettings times\n" );
+    printf( "  CreateBoardPoly:          %.3f ms\n",
+            (float)( stats_stopCreateBoardPolyTime  - stats_startCreateBoardPolyTime  ) / 1e3 );
+    printf( "  CreateLayers and holes:   %.3f ms\n",
+            (float)( stats_stopCreateLayersTime     - stats_startCreateLayersTime     ) / 1e3 );
+    printf( "\n" );
+#endif
+}
+
+
+void CINFO3D_VISU::BeginBuild( REPORTER *aStatusTextReporter )
+{
+    wxLogTrace( m_logTrace, wxT( "CINFO3D_VISU::BeginBuild" ) );
+
+    CancelBuild();
+
+    createBoardDimensions();
+    destroyLayers();
+
+    m_buildStage = BUILD_STAGE_BOARD_BODY;
+
+    startBuildStage( aStatusTextReporter );
+}
+
+
+BUILD_STAGE CINFO3D_VISU::GetReadyBuildStage() const
+{
+    if( ( m_buildStage != BUILD_STAGE_FINISHED ) && m_buildStageReady )
+        return m_buildStage;
+
+    return BUILD_STAGE_FINISHED;
+}
+
+
+void CINFO3D_VISU::ContinueBuild( REPORTER *aStatusTextReporter )
+{
+    wxASSERT( GetReadyBuildStage() != BUILD_STAGE_FINISHED );
+
+    if( m_buildThread.joinable() )
+        m_buildThread.join();
+
+    m_buildStage = static_cast<BUILD_STAGE>( m_buildStage + 1 );
+
+    if( m_buildStage != BUILD_STAGE_FINISHED )
+        startBuildStage( aStatusTextReporter );
+}
+
+
+void CINFO3D_VISU::CancelBuild()
+{
+    if( m_buildThread.joinable() )
+    {
+        m_buildCancel = true;
+        m_buildThread.join();
+    }
+
+    m_buildCancel = false;
+    m_buildStageReady = false;
+    m_buildStage = BUILD_STAGE_FINISHED;
+}
+
+
+void CINFO3D_VISU::startBuildStage( REPORTER *aStatusTextReporter )
+{
+    m_buildStageReady = false;
+
+    // The board items are read here, on the calling thread, so the board
+    // can't be modified while they are converted.
+    switch( m_buildStage )
+    {
+    case BUILD_STAGE_BOARD_BODY:
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Build board body" ) );
+
+        createBoardPolygon();
+        break;
+
+    case BUILD_STAGE_COPPER:
+        createCopperLayers( aStatusTextReporter );
+        break;
+
+    case BUILD_STAGE_TECH_LAYERS:
+        createTechLayers( aStatusTextReporter );
+        break;
+
+    default:
+        wxFAIL_MSG( wxT( "CINFO3D_VISU::startBuildStage: invalid stage" ) );
+        return;
+    }
+
+    // The worker only uses the containers and polygons of this class
+    const BUILD_STAGE stage = m_buildStage;
+
+    m_buildThread = std::thread( [this, stage]()
+    {
+        if( stage == BUILD_STAGE_COPPER )
+            processCopperLayers();
+        else if( stage == BUILD_STAGE_TECH_LAYERS )
+            processTechLayers();
+
+        m_buildStageReady = true;
+    } );
+}
+
+
+void CINFO3D_VISU::createBoardDimensions()
+{
     // Calculates the board bounding box
     // First, use only the board outlines
     EDA_RECT bbbox = m_board->ComputeBoundingBox( true );
@@ -416,36 +560,6 @@ void CINFO3D_VISU::InitSettings( REPORTER *aStatusTextReporter )
     boardMax.z = m_layerZcoordTop[F_Adhes];
 
     m_boardBoudingBox = CBBOX( boardMin, boardMax );
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startCreateBoardPolyTime = GetRunningMicroSecs();
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build board body" ) );
-
-    createBoardPolygon();
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_stopCreateBoardPolyTime = GetRunningMicroSecs();
-    unsigned stats_startCreateLayersTime = stats_stopCreateBoardPolyTime;
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Create layers" ) );
-
-    createLayers( aStatusTextReporter );
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_stopCreateLayersTime = GetRunningMicroSecs();
-
-    printf( "CINFO3D_VISU::InitSettings times\n" );
-    printf( "  CreateBoardPoly:          %.3f ms\n",
-            (float)( stats_stopCreateBoardPolyTime  - stats_startCreateBoardPolyTime  ) / 1e3 );
-    printf( "  CreateLayers and holes:   %.3f ms\n",
-            (float)( stats_stopCreateLayersTime     - stats_startCreateLayersTime     ) / 1e3 );
-    printf( "\n" );
-#endif
 }
 
 
@@ -30,6 +30,8 @@
 #ifndef CINFO3D_VISU_H
 #define CINFO3D_VISU_H
 
+#include <atomic>
+#include <thread>
 #include <vector>
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer2d.h"
 #include "../3d_rendering/3d_render_raytracing/accelerators/ccontainer.h"
@@ -62,6 +64,15 @@ typedef std::map< PCB_LAYER_ID, SHAPE_POLY_SET *> MAP_POLY;
 /// -(RANGE_SCALE_3D/2) .. +(RANGE_SCALE_3D/2)
 #define RANGE_SCALE_3D 8.0f
 
+/// Stages of the board build, in the order they are made available to the renders
+enum BUILD_STAGE
+{
+    BUILD_STAGE_BOARD_BODY,     ///< board outline polygon
+    BUILD_STAGE_COPPER,         ///< copper layers, holes and vias
+    BUILD_STAGE_TECH_LAYERS,    ///< silkscreen, solder mask, paste and the other tech layers
+    BUILD_STAGE_FINISHED
+};
+
 
 /**
  *  Class CINFO3D_VISU
@@ -134,6 +145,41 @@ class CINFO3D_VISU
      */
     void InitSettings( REPORTER *aStatusTextReporter );
 
+    /**
+     * @brief BeginBuild - Starts a staged build of the board. The board items
+     * of each stage are read by the calling (UI) thread, the heavy geometry
+     * processing of the stage (polygon unions, BVH) is done on a worker thread.
+     * A running build is canceled.
+     * @param aStatusTextReporter: the pointer for the status reporter
+     */
+    void BeginBuild( REPORTER *aStatusTextReporter );
+
+    /**
+     * @brief GetReadyBuildStage - Get the stage of a staged build whose data
+     * was processed and can be used by the render
+     * @return the stage ready, or BUILD_STAGE_FINISHED if none
+     */
+    BUILD_STAGE GetReadyBuildStage() const;
+
+    /**
+     * @brief ContinueBuild - Starts the next stage of a staged build, it must
+     * be called once the data of the ready stage was used.
+     * @param aStatusTextReporter: the pointer for the status reporter
+     */
+    void ContinueBuild( REPORTER *aStatusTextReporter );
+
+    /**
+     * @brief CancelBuild - Stops the staged build, waiting for its worker thread.
+     * The data of the board is then incomplete until a new build.
+     */
+    void CancelBuild();
+
+    /**
+     * @brief GetBuildStage - Get the stage being built
+     * @return the stage, or BUILD_STAGE_FINISHED if there is no build running
+     */
+    BUILD_STAGE GetBuildStage() const { return m_buildStage; }
+
     /**
      * @brief BiuTo3Dunits - Board integer units To 3D units
      * @return the conversion factor to transform a position from the board to 3d units
@@ -418,10 +464,16 @@ class CINFO3D_VISU
     const MAP_POLY &GetPolyMapHoles_Outer() const { return m_layers_outer_holes_poly; }
 
  private:
+    void createBoardDimensions();
     void createBoardPolygon();
-    void createLayers( REPORTER *aStatusTextReporter );
+    void createCopperLayers( REPORTER *aStatusTextReporter );
+    void processCopperLayers();
+    void createTechLayers( REPORTER *aStatusTextReporter );
+    void processTechLayers();
     void destroyLayers();
 
+    void startBuildStage( REPORTER *aStatusTextReporter );
+
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
 
@@ -533,6 +585,21 @@ class CINFO3D_VISU
     MATERIAL_MODE       m_material_mode;
 
 
+    // Staged build
+
+    /// Stage being built, BUILD_STAGE_FINISHED if there is no build running
+    BUILD_STAGE         m_buildStage;
+
+    /// Worker thread processing the current stage
+    std::thread         m_buildThread;
+
+    /// Set when the data of the current stage was processed
+    std::atomic<bool>   m_buildStageReady;
+
+    /// Set to stop the processing of the current stage
+    std::atomic<bool>   m_buildCancel;
+
+
     // Pcb board position
 
     /// center board actual position in board units
@@ -135,21 +135,13 @@ void CINFO3D_VISU::destroyLayers()
 }
 
 
-void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+void CINFO3D_VISU::createCopperLayers( REPORTER *aStatusTextReporter )
 {
     // Number of segments to draw a circle using segments (used on countour zones
     // and text copper elements )
     const int    segcountforcircle = 12;
     const double correctionFactor  = GetCircleCorrectionFactor( segcountforcircle );
 
-    // segments to draw a circle to build texts. Is is used only to build
-    // the shape of each segment of the stroke font, therefore no need to have
-    // many segments per circle.
-    const int segcountInStrokeFont  = 12;
-    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
-
-    destroyLayers();
-
     // Build Copper layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
     // /////////////////////////////////////////////////////////////////////////
@@ -712,7 +704,7 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
             default:
                 wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
+                            wxT( "createCopperLayers: item type: %d not implemented" ),
                             item->Type() );
             break;
             }
@@ -768,7 +760,7 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
                 default:
                     wxLogTrace( m_logTrace,
-                                wxT( "createLayers: item type: %d not implemented" ),
+                                wxT( "createCopperLayers: item type: %d not implemented" ),
                                 item->Type() );
                 break;
                 }
@@ -856,31 +848,58 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
+
+    printf( "CINFO3D_VISU::createCopperLayers times\n" );
+    printf( "  Copper Layers:          %.3f ms\n",
+            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
+    printf( "Statistics:\n" );
+    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
+    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
+    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
+    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
+    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
+    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
+    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
+#endif
+}
+
+
+void CINFO3D_VISU::processCopperLayers()
+{
+    // It doesn't use the board, so it can run on a worker thread while the
+    // board is edited. It stops early when m_buildCancel is set.
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned start_Time = GetRunningMicroSecs();
+#endif
+
     // Simplify layer polygons
+    // Copper layers only have polygons if they are rendered with thickness
     // /////////////////////////////////////////////////////////////////////////
+    std::vector< SHAPE_POLY_SET *> layerPolys;
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
-
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    for( MAP_POLY::const_iterator ii = m_layers_poly.begin();
+         ii != m_layers_poly.end();
+         ++ii )
     {
-        const int nLayers = layer_id.size();
-
-        #pragma omp parallel for
-        for( signed int lIdx = 0; lIdx < nLayers; ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        if( IsCopperLayer( ii->first ) )
+            layerPolys.push_back( ii->second );
+    }
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+    const int nLayers = layerPolys.size();
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    #pragma omp parallel for
+    for( signed int lIdx = 0; lIdx < nLayers; ++lIdx )
+    {
+        if( m_buildCancel )
+            continue;
 
-            wxASSERT( layerPoly != NULL );
+        wxASSERT( layerPolys[lIdx] != NULL );
 
-            // This will make a union of all added contourns
-            layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
+        // This will make a union of all added contourns
+        layerPolys[lIdx]->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -890,33 +909,27 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
     // Simplify holes polygon contours
     // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
-
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    for( MAP_POLY::const_iterator ii = m_layers_outer_holes_poly.begin();
+         ii != m_layers_outer_holes_poly.end();
+         ++ii )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        if( m_buildCancel )
+            return;
 
-        if( m_layers_outer_holes_poly.find( curr_layer_id ) !=
-            m_layers_outer_holes_poly.end() )
-        {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        ii->second->Simplify( SHAPE_POLY_SET::PM_FAST );
 
-            wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                      m_layers_inner_holes_poly.end() );
+        wxASSERT( m_layers_inner_holes_poly.find( ii->first ) !=
+                  m_layers_inner_holes_poly.end() );
 
-            polyLayer = m_layers_inner_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
+        m_layers_inner_holes_poly.at( ii->first )->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
 #endif
-    // End Build Copper layers
 
+    if( m_buildCancel )
+        return;
 
     // This will make a union of all added contourns
     m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
@@ -925,10 +938,51 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
     //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
 
+    if( m_buildCancel )
+        return;
+
+    // Build BVH for holes and vias
+    // /////////////////////////////////////////////////////////////////////////
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
+    unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
 #endif
 
+    // The containers are independent, each one is built by a thread
+    std::vector< CBVHCONTAINER2D * > holesContainers;
+
+    holesContainers.push_back( &m_through_holes_inner );
+    holesContainers.push_back( &m_through_holes_outer );
+
+    for( MAP_CONTAINER_2D::iterator ii = m_layers_holes2D.begin();
+         ii != m_layers_holes2D.end();
+         ++ii )
+    {
+        holesContainers.push_back( (CBVHCONTAINER2D *)(ii->second) );
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for( signed int i = 0; i < (signed int)holesContainers.size(); ++i )
+        holesContainers[i]->BuildBVH();
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
+
+    printf( "CINFO3D_VISU::processCopperLayers times\n" );
+    printf( "  Holes BVH creation:     %.3f ms\n",
+            (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
+#endif
+}
+
+
+void CINFO3D_VISU::createTechLayers( REPORTER *aStatusTextReporter )
+{
+    // segments to draw a circle to build texts. Is is used only to build
+    // the shape of each segment of the stroke font, therefore no need to have
+    // many segments per circle.
+    const int segcountInStrokeFont  = 12;
+    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
+
     // Build Tech layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
     // /////////////////////////////////////////////////////////////////////////
@@ -1149,64 +1203,58 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
                                                              correctionFactorStroke );
             }
         }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
     // End Build Tech layers
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endTechLayersTime = GetRunningMicroSecs();
+
+    printf( "CINFO3D_VISU::createTechLayers times\n" );
+    printf( "  Tech Layers:            %.3f ms\n",
+            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
 #endif
+}
 
 
-    // Build BVH for holes and vias
-    // /////////////////////////////////////////////////////////////////////////
+void CINFO3D_VISU::processTechLayers()
+{
+    // It doesn't use the board, so it can run on a worker thread while the
+    // board is edited. It stops early when m_buildCancel is set.
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
-#endif
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
+    std::vector< SHAPE_POLY_SET *> layerPolys;
 
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
+    for( MAP_POLY::const_iterator ii = m_layers_poly.begin();
+         ii != m_layers_poly.end();
+         ++ii )
+    {
+        if( !IsCopperLayer( ii->first ) )
+            layerPolys.push_back( ii->second );
+    }
 
-    if( !m_layers_holes2D.empty() )
+    const int nLayers = layerPolys.size();
+
+    #pragma omp parallel for
+    for( signed int lIdx = 0; lIdx < nLayers; ++lIdx )
     {
-        for( MAP_CONTAINER_2D::iterator ii = m_layers_holes2D.begin();
-             ii != m_layers_holes2D.end();
-             ++ii )
-        {
-            ((CBVHCONTAINER2D *)(ii->second))->BuildBVH();
-        }
+        if( m_buildCancel )
+            continue;
+
+        // This will make a union of all added contours
+        layerPolys[lIdx]->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
 
+    if( m_buildCancel )
+        return;
+
     // We only need the Solder mask to initialize the BVH
     // because..?
-    if( (CBVHCONTAINER2D *)m_layers_container2D[B_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[B_Mask])->BuildBVH();
+    MAP_CONTAINER_2D::iterator mask = m_layers_container2D.find( B_Mask );
 
-    if( (CBVHCONTAINER2D *)m_layers_container2D[F_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[F_Mask])->BuildBVH();
+    if( mask != m_layers_container2D.end() )
+        mask->second->BuildBVH();
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
+    mask = m_layers_container2D.find( F_Mask );
 
-    printf( "CINFO3D_VISU::createLayers times\n" );
-    printf( "  Copper Layers:          %.3f ms\n",
-            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
-    printf( "  Holes BVH creation:     %.3f ms\n",
-            (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
-    printf( "  Tech Layers:            %.3f ms\n",
-            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
-    printf( "Statistics:\n" );
-    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
-    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
-    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
-    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
-    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
-    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
-    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
-#endif
+    if( mask != m_layers_container2D.end() )
+        mask->second->BuildBVH();
 }
@@ -229,6 +229,9 @@ void EDA_3D_CANVAS::GetScreenshot( wxImage &aDstImage )
 
 void EDA_3D_CANVAS::ReloadRequest( BOARD *aBoard , S3D_CACHE *aCachePointer )
 {
+    // Stop building the previous board state, it will be rebuilt on next redraw
+    m_settings.CancelBuild();
+
     if( aCachePointer != NULL )
         m_settings.Set3DCacheManager( aCachePointer );
 
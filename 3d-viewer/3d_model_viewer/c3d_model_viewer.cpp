@@ -154,7 +154,8 @@ void C3D_MODEL_VIEWER::Set3DModel(const wxString &aModelPathName)
 
     if( m_cacheManager )
     {
-        const S3DMODEL* model = m_cacheManager->GetModel( aModelPathName );
+        // the preview is small, a coarse tessellation is enough and loads faster
+        const S3DMODEL* model = m_cacheManager->GetModel( aModelPathName, S3D::LOD_PREVIEW );
 
         if( model )
             Set3DModel( (const S3DMODEL &)*model );
@@ -344,27 +344,128 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER *aStatusTextReporter )
     COBJECT2D_STATS::Instance().ResetStats();
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf("InitSettings...\n");
+    printf("BeginBuild...\n");
 #endif
 
-    unsigned stats_startReloadTime = GetRunningMicroSecs();
+    m_build_start_time = GetRunningMicroSecs();
+    m_build_in_progress = true;
 
-    m_settings.InitSettings( aStatusTextReporter );
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endReloadTime = GetRunningMicroSecs();
-#endif
+    // The board is built in stages, each one is loaded to openGL by
+    // load_build_stages() as soon as it is ready.
+    m_settings.BeginBuild( aStatusTextReporter );
 
     SFVEC3F camera_pos = m_settings.GetBoardCenter3DU();
     m_settings.CameraGet().SetBoardLookAtPos( camera_pos );
+}
+
+
+bool C3D_RENDER_OGL_LEGACY::load_build_stages( REPORTER *aStatusTextReporter )
+{
+    if( !m_build_in_progress )
+        return false;
+
+    // The build was canceled or redone by someone else (e.g. the raytracing
+    // render), so it has to be restarted.
+    if( m_settings.GetBuildStage() == BUILD_STAGE_FINISHED )
+    {
+        ReloadRequest();
+
+        return true;
+    }
+
+    const BUILD_STAGE stage = m_settings.GetReadyBuildStage();
+
+    if( stage == BUILD_STAGE_FINISHED )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Loading..." ) );
+
+        return true;
+    }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_start_OpenGL_Load_Time = GetRunningMicroSecs();
 #endif
 
+    switch( stage )
+    {
+    case BUILD_STAGE_BOARD_BODY:
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: board" ) );
+
+        load_board_body();
+        break;
+
+    case BUILD_STAGE_COPPER:
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: holes and vias" ) );
+
+        load_holes_and_vias();
+
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: copper layers" ) );
+
+        load_layers( true );
+        break;
+
+    case BUILD_STAGE_TECH_LAYERS:
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
+
+        load_layers( false );
+        break;
+
+    default:
+        break;
+    }
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    printf( "C3D_RENDER_OGL_LEGACY::load_build_stages stage %d: %.3f ms\n", (int)stage,
+            (float)( GetRunningMicroSecs() - stats_start_OpenGL_Load_Time ) / 1000.0f );
+#endif
+
+    // The data of this stage is no longer used, the next one can be built
+    m_settings.ContinueBuild( aStatusTextReporter );
+
+    if( m_settings.GetBuildStage() != BUILD_STAGE_FINISHED )
+        return true;
+
+    // Load 3D models
+    // /////////////////////////////////////////////////////////////////////////
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_start_models_Load_Time = GetRunningMicroSecs();
+#endif
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Loading 3D models" ) );
+
+    load_3D_models( aStatusTextReporter );
+
+    m_build_in_progress = false;
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    printf( "C3D_RENDER_OGL_LEGACY::load_build_stages times:\n" );
+    printf( "  Loading 3D models:        %.3f ms\n",
+            (float)( GetRunningMicroSecs() - stats_start_models_Load_Time ) / 1000.0f );
+    COBJECT2D_STATS::Instance().PrintStats();
+#endif
+
     if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: board" ) );
+    {
+        // Calculation time in seconds
+        const double calculation_time = (double)( GetRunningMicroSecs() -
+                                                  m_build_start_time ) / 1e6;
 
+        aStatusTextReporter->Report( wxString::Format( _( "Reload time %.3f s" ),
+                                                       calculation_time ) );
+    }
+
+    return true;
+}
+
+
+void C3D_RENDER_OGL_LEGACY::load_board_body()
+{
     // Create Board
     // /////////////////////////////////////////////////////////////////////////
 
@@ -429,13 +530,14 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER *aStatusTextReporter )
 
         delete layerTriangles;
     }
+}
+
 
+void C3D_RENDER_OGL_LEGACY::load_holes_and_vias()
+{
     // Create Through Holes and vias
     // /////////////////////////////////////////////////////////////////////////
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: holes and vias" ) );
-
     m_ogl_disp_list_through_holes_outer = generate_holes_display_list(
                 m_settings.GetThroughHole_Outer().GetList(),
                 m_settings.GetThroughHole_Outer_poly(),
@@ -528,19 +630,20 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER *aStatusTextReporter )
 
     // Generate vertical cylinders of vias and pads (copper)
     generate_3D_Vias_and_Pads();
+}
 
-    // Add layers maps
-    // /////////////////////////////////////////////////////////////////////////
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Load OpenGL: layers" ) );
 
+void C3D_RENDER_OGL_LEGACY::load_layers( bool aCopperLayers )
+{
     for( MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().begin();
          ii != m_settings.GetMapLayers().end();
          ++ii )
     {
         PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
 
+        if( IsCopperLayer( layer_id ) != aCopperLayers )
+            continue;
+
         if( !m_settings.Is3DLayerEnabled( layer_id ) )
             continue;
 
@@ -628,45 +731,6 @@ void C3D_RENDER_OGL_LEGACY::reload( REPORTER *aStatusTextReporter )
                                                                         layer_z_bot,
                                                                         layer_z_top );
     }// for each layer on map
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_end_OpenGL_Load_Time = GetRunningMicroSecs();
-#endif
-
-    // Load 3D models
-    // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_start_models_Load_Time = GetRunningMicroSecs();
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Loading 3D models" ) );
-
-    load_3D_models( aStatusTextReporter );
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_end_models_Load_Time = GetRunningMicroSecs();
-
-
-    printf( "C3D_RENDER_OGL_LEGACY::reload times:\n" );
-    printf( "  Reload board:             %.3f ms\n",
-            (float)( stats_endReloadTime        - stats_startReloadTime        ) / 1000.0f );
-    printf( "  Loading to openGL:        %.3f ms\n",
-            (float)( stats_end_OpenGL_Load_Time - stats_start_OpenGL_Load_Time ) / 1000.0f );
-    printf( "  Loading 3D models:        %.3f ms\n",
-            (float)( stats_end_models_Load_Time - stats_start_models_Load_Time ) / 1000.0f );
-    COBJECT2D_STATS::Instance().PrintStats();
-#endif
-
-    if( aStatusTextReporter )
-    {
-        // Calculation time in seconds
-        const double calculation_time = (double)( GetRunningMicroSecs() -
-                                                  stats_startReloadTime) / 1e6;
-
-        aStatusTextReporter->Report( wxString::Format( _( "Reload time %.3f s" ),
-                                                       calculation_time ) );
-    }
 }
 
 
@@ -930,6 +994,34 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
         (!m_settings.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models which are not in our map yet all at once, so the cache
+    // manager can read them in parallel
+    std::vector< wxString > modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( !model.m_Filename.empty() &&
+                m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    if( !modelFiles.empty() )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Loading 3D models" ) );
+
+        m_settings.Get3DCacheManager()->LoadModels( modelFiles );
+    }
+
+    // The display lists of a model are shared by all its instances, also when it is
+    // referenced by different file names (e.g. with and without a path alias)
+    std::map< const S3DMODEL*, C_OGL_3DMODEL* > loadedModels;
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -943,36 +1035,37 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
 
             while( sM != eM )
             {
-                if( !sM->m_Filename.empty() )
+                // Check if the model is not present in our cache map
+                // (Not already loaded in memory)
+                if( !sM->m_Filename.empty() &&
+                    m_3dmodel_map.find( sM->m_Filename ) == m_3dmodel_map.end() )
                 {
-                    if( aStatusTextReporter )
-                    {
-                        // Display the short filename of the 3D model loaded:
-                        // (the full name is usually too long to be displayed)
-                        wxFileName fn( sM->m_Filename );
-                        wxString msg;
-                        msg.Printf( _( "Loading %s" ), fn.GetFullName() );
-                        aStatusTextReporter->Report( msg );
-                    }
+                    // It is not present, try get it from cache
+                    const S3DMODEL *modelPtr =
+                            m_settings.Get3DCacheManager()->GetModel( sM->m_Filename );
 
-                    // Check if the model is not present in our cache map
-                    // (Not already loaded in memory)
-                    if( m_3dmodel_map.find( sM->m_Filename ) == m_3dmodel_map.end() )
+                    // only add it if the return is not NULL
+                    if( modelPtr )
                     {
-                        // It is not present, try get it from cache
-                        const S3DMODEL *modelPtr =
-                                m_settings.Get3DCacheManager()->GetModel( sM->m_Filename );
+                        C_OGL_3DMODEL*& ogl_model = loadedModels[ modelPtr ];
 
-                        // only add it if the return is not NULL
-                        if( modelPtr )
+                        if( !ogl_model )
                         {
-                            C_OGL_3DMODEL* ogl_model =
-                                    new C_OGL_3DMODEL( *modelPtr,
-                                                       m_settings.MaterialModeGet() );
-
-                            if( ogl_model )
-                                m_3dmodel_map[ sM->m_Filename ] = ogl_model;
+                            if( aStatusTextReporter )
+                            {
+                                // Display the short filename of the 3D model loaded:
+                                // (the full name is usually too long to be displayed)
+                                wxFileName fn( sM->m_Filename );
+                                wxString msg;
+                                msg.Printf( _( "Loading %s" ), fn.GetFullName() );
+                                aStatusTextReporter->Report( msg );
+                            }
+
+                            ogl_model = new C_OGL_3DMODEL( *modelPtr,
+                                                           m_settings.MaterialModeGet() );
                         }
+
+                        m_3dmodel_map[ sM->m_Filename ] = ogl_model;
                     }
                 }
 
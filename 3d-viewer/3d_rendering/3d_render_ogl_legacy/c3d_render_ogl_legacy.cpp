@@ -38,6 +38,8 @@
 
 #include <base_units.h>
 
+#include <set>
+
 /**
   * Scale convertion from 3d model units to pcb units
   */
@@ -68,6 +70,9 @@ C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( CINFO3D_VISU &aSettings ) :
     m_last_grid_type = GRID3D_NONE;
 
     m_3dmodel_map.clear();
+
+    m_build_in_progress = false;
+    m_build_start_time = 0;
 }
 
 
@@ -473,8 +478,6 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
 
     if( m_reloadRequested )
     {
-        wxBusyCursor dummy;
-
         if( aStatusTextReporter )
             aStatusTextReporter->Report( _( "Loading..." ) );
 
@@ -496,6 +499,10 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
         }
     }
 
+    // Display the stages of the board that are already built, and redraw
+    // while there are more to come
+    const bool isBuilding = load_build_stages( aStatusTextReporter );
+
     // Initial setup
     // /////////////////////////////////////////////////////////////////////////
     glDepthFunc( GL_LESS );
@@ -762,7 +769,7 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
     // /////////////////////////////////////////////////////////////////////////
     glViewport( 0, 0, m_windowSize.x, m_windowSize.y );
 
-    return false;
+    return isBuilding;
 }
 
 
@@ -883,13 +890,16 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
     m_triangles.clear();
 
 
+    // A model is shared by the file names resolving to it
+    std::set< C_OGL_3DMODEL* > models;
+
     for( MAP_3DMODEL::const_iterator ii = m_3dmodel_map.begin();
          ii != m_3dmodel_map.end();
          ++ii )
-    {
-        C_OGL_3DMODEL *pointer = static_cast<C_OGL_3DMODEL*>(ii->second);
+        models.insert( ii->second );
+
+    for( C_OGL_3DMODEL *pointer : models )
         delete pointer;
-    }
 
     m_3dmodel_map.clear();
 
@@ -1036,10 +1046,11 @@ void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
             if( !sM->m_Filename.empty() )
             {
                 // Check if the model is present in our cache map
-                if( m_3dmodel_map.find( sM->m_Filename ) != m_3dmodel_map.end() )
+                MAP_3DMODEL::const_iterator cached = m_3dmodel_map.find( sM->m_Filename );
+
+                if( cached != m_3dmodel_map.end() )
                 {
-                    // It is not present, try get it from cache
-                    const C_OGL_3DMODEL *modelPtr = m_3dmodel_map[ sM->m_Filename ];
+                    const C_OGL_3DMODEL *modelPtr = cached->second;
 
                     if( modelPtr )
                     {
@@ -73,6 +73,17 @@ private:
     bool initializeOpenGL();
     void reload( REPORTER *aStatusTextReporter );
 
+    /**
+     * @brief load_build_stages - Loads to openGL the stages of the board build
+     * that are ready, and the 3D models once the build is finished
+     * @return true while the build is in progress
+     */
+    bool load_build_stages( REPORTER *aStatusTextReporter );
+
+    void load_board_body();
+    void load_holes_and_vias();
+    void load_layers( bool aCopperLayers );
+
     void ogl_set_arrow_material();
 
     void ogl_free_all_display_lists();
@@ -106,6 +117,9 @@ private:
 
     MAP_3DMODEL m_3dmodel_map;
 
+    bool m_build_in_progress;       ///< the board build is not loaded yet
+    unsigned m_build_start_time;    ///< time the board build was started
+
 private:
     void generate_through_outer_holes();
     void generate_through_inner_holes();
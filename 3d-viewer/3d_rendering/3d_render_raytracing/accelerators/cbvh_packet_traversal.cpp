@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../shapes3D/ctriangle.h"
 #include <wx/debug.h>
 
 
@@ -45,48 +46,21 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
-                                        const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
-{
-    float hitT;
-
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
-            return ia;
-
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
-
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
-
-    return RAYPACKET_RAYS_PER_PACKET;
-}
-
-
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
-                                       const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
+///> Returns the index of the first ray of a mask, the mask must not be empty
+static inline unsigned int firstRay( uint64_t aMask )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+#if defined( __GNUC__ )
+    return __builtin_ctzll( aMask );
+#else
+    unsigned int i = 0;
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
+    while( !( ( aMask >> i ) & 1 ) )
+        ++i;
 
-    return ia + 1;
+    return i;
+#endif
 }
 
 
@@ -94,6 +68,8 @@ static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
 // http://cseweb.ucsd.edu/~ravir/whitted.pdf
 
 // Ranged Traversal
+// The bounding boxes and triangles are tested against the packet with the vectorised
+// kernels, the other objects are tested ray by ray for the rays hitting their node.
 bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                            HITINFO_PACKET *aHitInfoPacket ) const
 {
@@ -107,16 +83,28 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    // Current hit distance of each ray, in the layout used by the kernels
+    float tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        const uint64_t hits = RAYPACKET_IntersectBBox( aRayPacket.m_soa,
+                                                       &curCell->bounds.Min().x,
+                                                       &curCell->bounds.Max().x,
+                                                       tHit,
+                                                       ia );
 
-        if( ia < RAYPACKET_RAYS_PER_PACKET )
+        if( hits )
         {
+            ia = firstRay( hits );
+
             if( curCell->nPrimitives == 0 )
             {
                 StackNode &node = todo[todoOffset++];
@@ -127,28 +115,42 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
-
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
                     const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
 
-                    if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                    if( !aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                        continue;
+
+                    uint64_t rays = hits;
+
+                    if( obj->GetObjectType() == OBJ3D_TRIANGLE )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
-                        {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                        RAYPACKET_TRIANGLE triangle;
 
-                            if( hitted )
-                            {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
-                            }
+                        static_cast<const CTRIANGLE *>( obj )->GetPacketData( triangle );
+
+                        rays = RAYPACKET_IntersectTriangle( aRayPacket.m_soa,
+                                                            triangle,
+                                                            tHit,
+                                                            rays );
+                    }
+
+                    while( rays )
+                    {
+                        const unsigned int i = firstRay( rays );
+
+                        rays &= rays - 1;
+
+                        const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
+                                                            aHitInfoPacket[i].m_HitInfo );
+
+                        if( hitted )
+                        {
+                            anyHitted |= hitted;
+                            aHitInfoPacket[i].m_hitresult |= hitted;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                            tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
                         }
                     }
                 }
@@ -68,6 +68,8 @@
 
 #include "cbvh_pbrt.h"
 #include "../../../3d_fastmath.h"
+#include "../../../openmp_mutex.h"
+#include <algorithm>
 #include <vector>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
@@ -80,6 +82,9 @@
 #include <stdio.h>
 #endif
 
+/// Minimum number of primitives to split the build of a node between threads
+#define PARALLEL_BUILD_MIN_PRIMITIVES 1024
+
 // BVHAccel Local Declarations
 struct BVHPrimitiveInfo
 {
@@ -184,6 +189,23 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
 
     const int nPasses = nBits / bitsPerPass;
 
+    // Each pass counts and scatters chunks of the primitives in parallel. The chunks
+    // have consecutive ranges in each bucket, so the sort is stable as a serial one.
+    int nChunks = 1;
+
+#ifdef _OPENMP
+    if( v->size() > PARALLEL_BUILD_MIN_PRIMITIVES )
+        nChunks = omp_get_max_threads();
+#endif
+
+    const uint32_t chunkSize = ( v->size() + nChunks - 1 ) / nChunks;
+
+    const int nBuckets = 1 << bitsPerPass;
+    const int bitMask = (1 << bitsPerPass) - 1;
+
+    // Bucket counts, and then starting indexes, of each chunk
+    std::vector<int> chunkBuckets( nChunks * nBuckets );
+
     for( int pass = 0; pass < nPasses; ++pass )
     {
         // Perform one pass of radix sort, sorting _bitsPerPass_ bits
@@ -193,34 +215,53 @@ static void RadixSort( std::vector<MortonPrimitive> *v )
         std::vector<MortonPrimitive> &in  = (pass & 1) ? tempVector : *v;
         std::vector<MortonPrimitive> &out = (pass & 1) ? *v : tempVector;
 
-        // Count number of zero bits in array for current radix sort bit
-        const int nBuckets = 1 << bitsPerPass;
-        int bucketCount[nBuckets] = {0};
-        const int bitMask = (1 << bitsPerPass) - 1;
+        std::fill( chunkBuckets.begin(), chunkBuckets.end(), 0 );
 
-        for( uint32_t i = 0; i < in.size(); ++i )
+        // Count number of zero bits in array for current radix sort bit
+        #pragma omp parallel for if( nChunks > 1 )
+        for( int chunk = 0; chunk < nChunks; ++chunk )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
+            int *bucketCount = &chunkBuckets[chunk * nBuckets];
+            const uint32_t end = std::min<uint32_t>( in.size(), (chunk + 1) * chunkSize );
 
-            wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
+            for( uint32_t i = chunk * chunkSize; i < end; ++i )
+            {
+                const MortonPrimitive &mp = in[i];
+                int bucket = (mp.mortonCode >> lowBit) & bitMask;
 
-            ++bucketCount[bucket];
+                wxASSERT( (bucket >= 0) && (bucket < nBuckets) );
+
+                ++bucketCount[bucket];
+            }
         }
 
-        // Compute starting index in output array for each bucket
-        int startIndex[nBuckets];
-        startIndex[0] = 0;
+        // Compute starting index in output array for each bucket of each chunk
+        int startIndex = 0;
 
-        for( int i = 1; i < nBuckets; ++i )
-            startIndex[i] = startIndex[i - 1] + bucketCount[i - 1];
+        for( int bucket = 0; bucket < nBuckets; ++bucket )
+        {
+            for( int chunk = 0; chunk < nChunks; ++chunk )
+            {
+                const int count = chunkBuckets[chunk * nBuckets + bucket];
+
+                chunkBuckets[chunk * nBuckets + bucket] = startIndex;
+                startIndex += count;
+            }
+        }
 
         // Store sorted values in output array
-        for( uint32_t i = 0; i < in.size(); ++i )
+        #pragma omp parallel for if( nChunks > 1 )
+        for( int chunk = 0; chunk < nChunks; ++chunk )
         {
-            const MortonPrimitive &mp = in[i];
-            int bucket = (mp.mortonCode >> lowBit) & bitMask;
-            out[startIndex[bucket]++] = mp;
+            int *startIndexes = &chunkBuckets[chunk * nBuckets];
+            const uint32_t end = std::min<uint32_t>( in.size(), (chunk + 1) * chunkSize );
+
+            for( uint32_t i = chunk * chunkSize; i < end; ++i )
+            {
+                const MortonPrimitive &mp = in[i];
+                int bucket = (mp.mortonCode >> lowBit) & bitMask;
+                out[startIndexes[bucket]++] = mp;
+            }
         }
     }
 
@@ -234,7 +275,9 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
                       int aMaxPrimsInNode,
                       SPLITMETHOD aSplitMethod ) :
     m_maxPrimsInNode( std::min( 255, aMaxPrimsInNode ) ),
-    m_splitMethod( aSplitMethod )
+    m_splitMethod( aSplitMethod ),
+    m_buildNodes( NULL ),
+    m_buildNodesUsed( 0 )
 {
     if( aObjectContainer.GetList().empty() )
     {
@@ -269,17 +312,31 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    // Each leaf fills the range of the ordered primitives it was partitioned to,
+    // so the subtrees can be built in parallel
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
-    BVHBuildNode *root;
+    BVHBuildNode *root = NULL;
 
     if( m_splitMethod == SPLIT_HLBVH )
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+    {
+        // A binary tree with at least one primitive per leaf has less than 2n nodes
+        m_buildNodes = static_cast<BVHBuildNode *>( malloc( 2 * m_primitives.size() *
+                                                            sizeof( BVHBuildNode ) ) );
+        m_addresses_pointer_to_mm_free.push_back( m_buildNodes );
+
+#ifdef USE_OPENMP_TASKS
+        #pragma omp parallel if( m_primitives.size() > PARALLEL_BUILD_MIN_PRIMITIVES )
+#endif
+        {
+            #pragma omp single
+            root = recursiveBuild( primitiveInfo, 0, m_primitives.size(), orderedPrims );
+        }
+
+        totalNodes = m_buildNodesUsed;
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -445,10 +502,8 @@ struct BucketInfo
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
                                           CONST_VECTOR_OBJECT &orderedPrims )
 {
-    wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
     wxASSERT( end   >= 0 );
     wxASSERT( start != end );
@@ -456,11 +511,9 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     wxASSERT( start <= (int)primitiveInfo.size() );
     wxASSERT( end   <= (int)primitiveInfo.size() );
 
-    (*totalNodes)++;
+    BVHBuildNode *node = &m_buildNodes[m_buildNodesUsed++];
 
-    // !TODO: implement an memory Arena
-    BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    wxASSERT( (node - m_buildNodes) < (int)( 2 * primitiveInfo.size() ) );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -481,13 +534,13 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        int firstPrimOffset = start;
 
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -510,7 +563,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+            const int firstPrimOffset = start;
 
             for( int i = start; i < end; ++i )
             {
@@ -523,7 +576,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                 wxASSERT( obj != NULL );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
             node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -678,7 +731,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                        const int firstPrimOffset = start;
 
                         for( int i = start; i < end; ++i )
                         {
@@ -686,7 +739,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
                         node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
@@ -698,17 +751,23 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
             }
             }
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
+            BVHBuildNode *children[2];
+
+            // The subtrees work on separate ranges of the primitives, the first one is
+            // built by another thread if it is large enough
+#ifdef USE_OPENMP_TASKS
+            #pragma omp task shared( primitiveInfo, orderedPrims, children ) \
+                             if( nPrimitives > PARALLEL_BUILD_MIN_PRIMITIVES )
+#endif
+            children[0] = recursiveBuild( primitiveInfo, start, mid, orderedPrims );
+
+            children[1] = recursiveBuild( primitiveInfo, mid, end, orderedPrims );
+
+#ifdef USE_OPENMP_TASKS
+            #pragma omp taskwait
+#endif
+
+            node->InitInterior( dim, children[0], children[1] );
         }
     }
 
@@ -730,6 +789,7 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
     // Compute Morton indices of primitives
     std::vector<MortonPrimitive> mortonPrims( primitiveInfo.size() );
 
+    #pragma omp parallel for if( primitiveInfo.size() > PARALLEL_BUILD_MIN_PRIMITIVES )
     for( int i = 0; i < (int)primitiveInfo.size(); ++i )
     {
         // Initialize _mortonPrims[i]_ for _i_th primitive
@@ -800,10 +860,11 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
 
     // Create LBVHs for treelets in parallel
     int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
 
     orderedPrims.resize( m_primitives.size() );
 
+    #pragma omp parallel for schedule(dynamic) reduction(+:atomicTotal) \
+                             if( primitiveInfo.size() > PARALLEL_BUILD_MIN_PRIMITIVES )
     for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
     {
         // Generate _index_th LBVH treelet
@@ -814,6 +875,10 @@ BVHBuildNode *CBVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primit
 
         wxASSERT( tr.startIndex < (int)mortonPrims.size() );
 
+        // The treelets are consecutive ranges of the sorted primitives, and the
+        // leaves are emitted in order, so each treelet fills its own range
+        int orderedPrimsOffset = tr.startIndex;
+
         tr.buildNodes = emitLBVH( tr.buildNodes,
                                   primitiveInfo,
                                   &mortonPrims[tr.startIndex],
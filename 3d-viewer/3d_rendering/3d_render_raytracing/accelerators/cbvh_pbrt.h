@@ -71,6 +71,7 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include <atomic>
 #include <list>
 #include <stdint.h>
 
@@ -128,7 +129,6 @@ private:
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
                                   CONST_VECTOR_OBJECT &orderedPrims );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
@@ -161,6 +161,10 @@ private:
 
     std::list<void *> m_addresses_pointer_to_mm_free;
 
+    // Nodes of the recursive build, allocated by the threads building the subtrees
+    BVHBuildNode        *m_buildNodes;
+    std::atomic<int>    m_buildNodesUsed;
+
     // Partition traversal
     unsigned int m_I[RAYPACKET_RAYS_PER_PACKET];
 };
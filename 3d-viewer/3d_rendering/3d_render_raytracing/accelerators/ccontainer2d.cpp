@@ -28,6 +28,7 @@
  */
 
 #include "ccontainer2d.h"
+#include "../../../openmp_mutex.h"
 #include <vector>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
@@ -162,7 +163,6 @@ CBVHCONTAINER2D::CBVHCONTAINER2D() : CGENERICCONTAINER2D( OBJ2D_BVHCONTAINER )
 {
     m_isInitialized = false;
     m_bbox.Reset();
-    m_elements_to_delete.clear();
     m_Tree = NULL;
 }
 
@@ -239,17 +239,26 @@ bool CBVHCONTAINER2D::IsPointInside( const SFVEC2F &aPoint ) const
 }
 */
 
-void CBVHCONTAINER2D::destroy()
+void CBVHCONTAINER2D::recursiveDelete( BVH_CONTAINER_NODE_2D *aNode )
 {
-    for( std::list<BVH_CONTAINER_NODE_2D *>::iterator ii = m_elements_to_delete.begin();
-         ii != m_elements_to_delete.end();
-         ++ii )
+    if( aNode->m_Children[0] )
     {
-        delete *ii;
-        *ii = NULL;
+        recursiveDelete( aNode->m_Children[0] );
+        recursiveDelete( aNode->m_Children[1] );
     }
-    m_elements_to_delete.clear();
 
+    delete aNode;
+}
+
+
+void CBVHCONTAINER2D::destroy()
+{
+    // The nodes are created by the threads building the tree, so they are deleted
+    // from the tree instead of being tracked in a shared list
+    if( m_Tree )
+        recursiveDelete( m_Tree );
+
+    m_Tree = NULL;
     m_isInitialized = false;
 }
 
@@ -262,6 +271,9 @@ CBVHCONTAINER2D::~CBVHCONTAINER2D()
 
 #define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
 
+/// Minimum number of objects to build the subtrees of a node in parallel
+#define BVH_CONTAINER2D_MIN_OBJ_PER_TASK 512
+
 
 void CBVHCONTAINER2D::BuildBVH()
 {
@@ -276,7 +288,6 @@ void CBVHCONTAINER2D::BuildBVH()
     m_isInitialized = true;
     m_Tree = new BVH_CONTAINER_NODE_2D;
 
-    m_elements_to_delete.push_back( m_Tree );
     m_Tree->m_BBox = m_bbox;
 
     for( LIST_OBJECT2D::const_iterator ii = m_objects.begin();
@@ -286,7 +297,13 @@ void CBVHCONTAINER2D::BuildBVH()
         m_Tree->m_LeafList.push_back( static_cast<const COBJECT2D *>(*ii) );
     }
 
-    recursiveBuild_MIDDLE_SPLIT( m_Tree );
+#ifdef USE_OPENMP_TASKS
+    #pragma omp parallel if( m_objects.size() > BVH_CONTAINER2D_MIN_OBJ_PER_TASK )
+#endif
+    {
+        #pragma omp single
+        recursiveBuild_MIDDLE_SPLIT( m_Tree );
+    }
 }
 
 
@@ -324,8 +341,6 @@ void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeP
         // Create Leaf Nodes
         BVH_CONTAINER_NODE_2D *leftNode  = new BVH_CONTAINER_NODE_2D;
         BVH_CONTAINER_NODE_2D *rightNode = new BVH_CONTAINER_NODE_2D;
-        m_elements_to_delete.push_back( leftNode );
-        m_elements_to_delete.push_back( rightNode );
 
         leftNode->m_BBox.Reset();
         rightNode->m_BBox.Reset();
@@ -374,8 +389,16 @@ void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeP
         aNodeParent->m_Children[1] = rightNode;
         aNodeParent->m_LeafList.clear();
 
+#ifdef USE_OPENMP_TASKS
+        #pragma omp task if( leftNode->m_LeafList.size() > BVH_CONTAINER2D_MIN_OBJ_PER_TASK )
+#endif
         recursiveBuild_MIDDLE_SPLIT( leftNode );
+
         recursiveBuild_MIDDLE_SPLIT( rightNode );
+
+#ifdef USE_OPENMP_TASKS
+        #pragma omp taskwait
+#endif
     }
     else
     {
@@ -104,10 +104,10 @@ public:
 
 private:
     bool m_isInitialized;
-    std::list<BVH_CONTAINER_NODE_2D *> m_elements_to_delete;
     BVH_CONTAINER_NODE_2D   *m_Tree;
 
     void destroy();
+    static void recursiveDelete( BVH_CONTAINER_NODE_2D *aNode );
     void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent );
     void recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
                                             const CBBOX2D & aBBox,
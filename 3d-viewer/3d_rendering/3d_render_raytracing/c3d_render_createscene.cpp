@@ -34,6 +34,7 @@
 #include "shapes3D/clayeritem.h"
 #include "shapes3D/ccylinder.h"
 #include "shapes3D/ctriangle.h"
+#include "shapes3D/cinstance.h"
 #include "shapes2D/citemlayercsg2d.h"
 #include "shapes2D/cring2d.h"
 #include "shapes2D/cpolygon2d.h"
@@ -273,6 +274,7 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
 
     m_object_container.Clear();
     m_containerWithObjectsToDelete.Clear();
+    delete_model_accelerators();
 
 
     // Create and add the outline board
@@ -1199,6 +1201,28 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // The models cannot be loaded without a cache manager (e.g. when rendering offscreen
+    // from a tool not attached to a project)
+    if( !m_settings.Get3DCacheManager() )
+        return;
+
+    // Load all the displayed models at once, so the cache manager can read them in parallel
+    std::vector< wxString > modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+        {
+            for( const MODULE_3D_SETTINGS& model : module->Models() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    // the raytracer renders the finer tessellation of the models which support it
+    m_settings.Get3DCacheManager()->LoadModels( modelFiles, S3D::LOD_FINE );
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -1255,7 +1279,8 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
             {
                 // get it from cache
                 const S3DMODEL *modelPtr =
-                        m_settings.Get3DCacheManager()->GetModel( sM->m_Filename );
+                        m_settings.Get3DCacheManager()->GetModel( sM->m_Filename,
+                                                                  S3D::LOD_FINE );
 
                 // only add it if the return is not NULL
                 if( modelPtr )
@@ -1444,98 +1469,121 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
             }
         }
 
-        const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+        // The triangles of a model are created once, in model coordinates, and shared
+        // by all its instances
+        const bool mirrored = glm::determinant( glm::mat3( aModelMatrix ) ) < 0.0f;
+
+        MODEL_ACCELERATOR *&modelAccelerator =
+                m_model_accelerators[std::make_pair( a3DModel, mirrored )];
 
-        for( unsigned int mesh_i = 0;
-             mesh_i < a3DModel->m_MeshesSize;
-             ++mesh_i )
+        if( modelAccelerator == NULL )
         {
-            const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
-
-            // Validate the mesh pointers
-            wxASSERT( mesh.m_Positions != NULL );
-            wxASSERT( mesh.m_FaceIdx != NULL );
-            wxASSERT( mesh.m_Normals != NULL );
-            wxASSERT( mesh.m_FaceIdxSize > 0 );
-            wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
-
-
-            if( (mesh.m_Positions != NULL) &&
-                (mesh.m_Normals != NULL) &&
-                (mesh.m_FaceIdx != NULL) &&
-                (mesh.m_FaceIdxSize > 0) &&
-                (mesh.m_VertexSize > 0) &&
-                ((mesh.m_FaceIdxSize % 3) == 0) &&
-                (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
-            {
-                const CBLINN_PHONG_MATERIAL &blinn_material = (*materialVector)[mesh.m_MaterialIdx];
+            modelAccelerator = new MODEL_ACCELERATOR;
+            modelAccelerator->m_accelerator = NULL;
 
-                // Add all face triangles
-                for( unsigned int faceIdx = 0;
-                     faceIdx < mesh.m_FaceIdxSize;
-                     faceIdx += 3 )
+            for( unsigned int mesh_i = 0;
+                 mesh_i < a3DModel->m_MeshesSize;
+                 ++mesh_i )
+            {
+                const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
+
+                // Validate the mesh pointers
+                wxASSERT( mesh.m_Positions != NULL );
+                wxASSERT( mesh.m_FaceIdx != NULL );
+                wxASSERT( mesh.m_Normals != NULL );
+                wxASSERT( mesh.m_FaceIdxSize > 0 );
+                wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
+
+
+                if( (mesh.m_Positions != NULL) &&
+                    (mesh.m_Normals != NULL) &&
+                    (mesh.m_FaceIdx != NULL) &&
+                    (mesh.m_FaceIdxSize > 0) &&
+                    (mesh.m_VertexSize > 0) &&
+                    ((mesh.m_FaceIdxSize % 3) == 0) &&
+                    (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
                 {
-                    const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
-                    const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
-                    const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
+                    const CBLINN_PHONG_MATERIAL &blinn_material = (*materialVector)[mesh.m_MaterialIdx];
 
-                    wxASSERT( idx0 < mesh.m_VertexSize );
-                    wxASSERT( idx1 < mesh.m_VertexSize );
-                    wxASSERT( idx2 < mesh.m_VertexSize );
-
-                    if( ( idx0 < mesh.m_VertexSize ) &&
-                        ( idx1 < mesh.m_VertexSize ) &&
-                        ( idx2 < mesh.m_VertexSize ) )
+                    // Add all face triangles
+                    for( unsigned int faceIdx = 0;
+                         faceIdx < mesh.m_FaceIdxSize;
+                         faceIdx += 3 )
                     {
-                        const SFVEC3F &v0 = mesh.m_Positions[idx0];
-                        const SFVEC3F &v1 = mesh.m_Positions[idx1];
-                        const SFVEC3F &v2 = mesh.m_Positions[idx2];
-
-                        const SFVEC3F &n0 = mesh.m_Normals[idx0];
-                        const SFVEC3F &n1 = mesh.m_Normals[idx1];
-                        const SFVEC3F &n2 = mesh.m_Normals[idx2];
+                        const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
+                        const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
+                        const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
 
-                        // Transform vertex with the model matrix
-                        const SFVEC3F vt0 = SFVEC3F( aModelMatrix * glm::vec4( v0, 1.0f) );
-                        const SFVEC3F vt1 = SFVEC3F( aModelMatrix * glm::vec4( v1, 1.0f) );
-                        const SFVEC3F vt2 = SFVEC3F( aModelMatrix * glm::vec4( v2, 1.0f) );
+                        wxASSERT( idx0 < mesh.m_VertexSize );
+                        wxASSERT( idx1 < mesh.m_VertexSize );
+                        wxASSERT( idx2 < mesh.m_VertexSize );
 
-                        const SFVEC3F nt0 = glm::normalize( SFVEC3F( normalMatrix * n0 ) );
-                        const SFVEC3F nt1 = glm::normalize( SFVEC3F( normalMatrix * n1 ) );
-                        const SFVEC3F nt2 = glm::normalize( SFVEC3F( normalMatrix * n2 ) );
-
-                        CTRIANGLE *newTriangle = new  CTRIANGLE( vt0, vt2, vt1,
-                                                                 nt0, nt2, nt1 );
+                        if( ( idx0 < mesh.m_VertexSize ) &&
+                            ( idx1 < mesh.m_VertexSize ) &&
+                            ( idx2 < mesh.m_VertexSize ) )
+                        {
+                            const SFVEC3F &v0 = mesh.m_Positions[idx0];
+                            const SFVEC3F &v1 = mesh.m_Positions[idx1];
+                            const SFVEC3F &v2 = mesh.m_Positions[idx2];
 
+                            const SFVEC3F &n0 = mesh.m_Normals[idx0];
+                            const SFVEC3F &n1 = mesh.m_Normals[idx1];
+                            const SFVEC3F &n2 = mesh.m_Normals[idx2];
 
+                            // A mirroring model matrix reverses the winding of the
+                            // triangles in world coordinates, so restore it in the model
+                            CTRIANGLE *newTriangle = mirrored ?
+                                    new CTRIANGLE( v0, v1, v2, n0, n1, n2 ) :
+                                    new CTRIANGLE( v0, v2, v1, n0, n2, n1 );
 
-                        m_object_container.Add( newTriangle );
-                        newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
+                            modelAccelerator->m_triangles.Add( newTriangle );
+                            newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
 
-                        if( mesh.m_Color == NULL )
-                        {
-                            const SFVEC3F diffuseColor =
-                                a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
+                            if( mesh.m_Color == NULL )
+                            {
+                                const SFVEC3F diffuseColor =
+                                    a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
 
-                            if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
-                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
-                            else
-                                newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
-                        }
-                        else
-                        {
-                            if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
-                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
-                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
-                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
+                                if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
+                                    newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
+                                else
+                                    newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
+                            }
                             else
-                                newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
-                                                       ConvertSRGBToLinear( mesh.m_Color[idx1] ),
-                                                       ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
+                            {
+                                if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
+                                    newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
+                                                           ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
+                                                           ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
+                                else
+                                    newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
+                                                           ConvertSRGBToLinear( mesh.m_Color[idx1] ),
+                                                           ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
+                            }
                         }
                     }
                 }
             }
+
+            if( !modelAccelerator->m_triangles.GetList().empty() )
+                modelAccelerator->m_accelerator = new CBVH_PBRT( modelAccelerator->m_triangles );
         }
+
+        if( modelAccelerator->m_accelerator )
+            m_object_container.Add( new CINSTANCE( modelAccelerator->m_accelerator,
+                                                   modelAccelerator->m_triangles.GetBBox(),
+                                                   aModelMatrix ) );
     }
 }
+
+
+void C3D_RENDER_RAYTRACING::delete_model_accelerators()
+{
+    for( auto& modelAccelerator : m_model_accelerators )
+    {
+        delete modelAccelerator.second->m_accelerator;
+        delete modelAccelerator.second;
+    }
+
+    m_model_accelerators.clear();
+}
@@ -28,6 +28,7 @@
  */
 
 #include <GL/glew.h>
+#include <algorithm>
 #include <climits>
 
 #include "c3d_render_raytracing.h"
@@ -82,6 +83,8 @@ C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
     delete m_accelerator;
     m_accelerator = NULL;
 
+    delete_model_accelerators();
+
     delete m_outlineBoard2dObjects;
     m_outlineBoard2dObjects = NULL;
 
@@ -298,6 +301,71 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderOffscreen( const wxSize &aSize,
+                                             std::vector<unsigned char> &aOutRGBA,
+                                             REPORTER *aStatusTextReporter )
+{
+    if( (aSize.x <= 0) || (aSize.y <= 0) || !m_settings.GetBoard() )
+        return false;
+
+    m_windowSize = aSize;
+    m_settings.CameraGet().SetCurWindowSize( aSize );
+
+    // Reload board if it was requested
+    // /////////////////////////////////////////////////////////////////////////
+    if( m_reloadRequested )
+    {
+        const unsigned stats_startReloadTime = GetRunningMicroSecs();
+
+        reload( aStatusTextReporter );
+
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( wxString::Format( _( "Scene build time %.3f s" ),
+                                         (double)( GetRunningMicroSecs() -
+                                                   stats_startReloadTime ) / 1e6 ) );
+    }
+
+    // There is no window to center the image in, so the traced buffer is the
+    // image size rounded up to full ray packets and the extra pixels are cropped.
+    // /////////////////////////////////////////////////////////////////////////
+    m_realBufferSize = SFVEC2UI( (aSize.x + RAYPACKET_MASK) & RAYPACKET_INVMASK,
+                                 (aSize.y + RAYPACKET_MASK) & RAYPACKET_INVMASK );
+    m_xoffset = 0;
+    m_yoffset = 0;
+
+    initialize_render_buffers();
+
+    // Force Redraw() to recalculate the buffers if it is used after this render
+    m_oldWindowsSize = wxSize( 0, 0 );
+
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4 );
+
+    // The render state machine returns periodically to report the progress,
+    // the blocks are traced in parallel on each step
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( buffer.data(), aStatusTextReporter );
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    // Crop the image, the buffer rows are stored from bottom to top
+    // /////////////////////////////////////////////////////////////////////////
+    const unsigned int rowSize = aSize.x * 4;
+
+    aOutRGBA.resize( rowSize * aSize.y );
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const GLubyte *src = &buffer[( aSize.y - 1 - y ) * m_realBufferSize.x * 4];
+
+        std::copy( src, src + rowSize, aOutRGBA.begin() + y * rowSize );
+    }
+
+    return true;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -489,6 +557,20 @@ void C3D_RENDER_RAYTRACING::rt_final_color( GLubyte *ptrPBO,
 }
 
 
+/**
+ * @brief intersectHitObject - intersects a ray with the object of a previous hit.
+ * The objects of an instanced model are in model coordinates, so the instance is
+ * intersected instead.
+ */
+static bool intersectHitObject( const HITINFO &aHitInfo, const RAY &aRay, HITINFO &aOutHitInfo )
+{
+    if( aHitInfo.pHitInstance )
+        return aHitInfo.pHitInstance->Intersect( aRay, aOutHitInfo );
+
+    return aHitInfo.pHitObject->Intersect( aRay, aOutHitInfo );
+}
+
+
 static void HITINFO_PACKET_init( HITINFO_PACKET *aHitPacket )
 {
     // Initialize hitPacket with a "not hit" information
@@ -1538,11 +1620,11 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                     bool hitted = false;
 
                     if( hittedC )
-                        hitted = centerHitInfo.pHitObject->Intersect( rayLTC, hitInfoLTC );
+                        hitted = intersectHitObject( centerHitInfo, rayLTC, hitInfoLTC );
                     else
                         if( hitPacket[ iLT ].m_hitresult )
-                            hitted = hitPacket[ iLT ].m_HitInfo.pHitObject->Intersect( rayLTC,
-                                                                                       hitInfoLTC );
+                            hitted = intersectHitObject( hitPacket[ iLT ].m_HitInfo, rayLTC,
+                                                         hitInfoLTC );
 
                     if( hitted )
                         cLTC = CCOLORRGB( shadeHit( bgColorY, rayLTC, hitInfoLTC, false, 0, false ) );
@@ -1566,11 +1648,11 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                     bool hitted = false;
 
                     if( hittedC )
-                        hitted = centerHitInfo.pHitObject->Intersect( rayRTC, hitInfoRTC );
+                        hitted = intersectHitObject( centerHitInfo, rayRTC, hitInfoRTC );
                     else
                         if( hitPacket[ iRT ].m_hitresult )
-                            hitted = hitPacket[ iRT ].m_HitInfo.pHitObject->Intersect( rayRTC,
-                                                                                       hitInfoRTC );
+                            hitted = intersectHitObject( hitPacket[ iRT ].m_HitInfo, rayRTC,
+                                                         hitInfoRTC );
 
                     if( hitted )
                         cRTC = CCOLORRGB( shadeHit( bgColorY, rayRTC, hitInfoRTC, false, 0, false ) );
@@ -1594,11 +1676,11 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                     bool hitted = false;
 
                     if( hittedC )
-                        hitted = centerHitInfo.pHitObject->Intersect( rayLBC, hitInfoLBC );
+                        hitted = intersectHitObject( centerHitInfo, rayLBC, hitInfoLBC );
                     else
                         if( hitPacket[ iLB ].m_hitresult )
-                            hitted = hitPacket[ iLB ].m_HitInfo.pHitObject->Intersect( rayLBC,
-                                                                                       hitInfoLBC );
+                            hitted = intersectHitObject( hitPacket[ iLB ].m_HitInfo, rayLBC,
+                                                         hitInfoLBC );
 
                     if( hitted )
                         cLBC = CCOLORRGB( shadeHit( bgColorY, rayLBC, hitInfoLBC, false, 0, false ) );
@@ -1622,11 +1704,11 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                     bool hitted = false;
 
                     if( hittedC )
-                        hitted = centerHitInfo.pHitObject->Intersect( rayRBC, hitInfoRBC );
+                        hitted = intersectHitObject( centerHitInfo, rayRBC, hitInfoRBC );
                     else
                         if( hitPacket[ iRB ].m_hitresult )
-                            hitted = hitPacket[ iRB ].m_HitInfo.pHitObject->Intersect( rayRBC,
-                                                                                       hitInfoRBC );
+                            hitted = intersectHitObject( hitPacket[ iRB ].m_HitInfo, rayRBC,
+                                                         hitInfoRBC );
 
                     if( hitted )
                         cRBC = CCOLORRGB( shadeHit( bgColorY, rayRBC, hitInfoRBC, false, 0, false ) );
@@ -2079,6 +2161,14 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     m_xoffset = (m_windowSize.x - m_realBufferSize.x) / 2;
     m_yoffset = (m_windowSize.y - m_realBufferSize.y) / 2;
 
+    initialize_render_buffers();
+
+    opengl_init_pbo();
+}
+
+
+void C3D_RENDER_RAYTRACING::initialize_render_buffers()
+{
     m_postshader_ssao.UpdateSize( m_realBufferSize );
 
 
@@ -2088,7 +2178,7 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     m_blockPositions.reserve( (m_realBufferSize.x / RAYPACKET_DIM) *
                               (m_realBufferSize.y / RAYPACKET_DIM) );
 
-    i = 0;
+    unsigned int i = 0;
 
     while(1)
     {
@@ -2106,6 +2196,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
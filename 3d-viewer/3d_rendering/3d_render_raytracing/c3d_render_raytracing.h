@@ -47,6 +47,18 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+/// Triangles of a 3D model, in model coordinates, and their accelerator.
+/// They are shared by all the instances of the model.
+struct MODEL_ACCELERATOR
+{
+    CCONTAINER           m_triangles;
+    CGENERICACCELERATOR *m_accelerator;
+};
+
+/// Maps a S3DMODEL pointer, and if it is placed mirrored, with its triangles
+typedef std::map< std::pair< const S3DMODEL *, bool >,
+                  MODEL_ACCELERATOR * > MAP_MODEL_ACCELERATORS;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -69,6 +81,19 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * @brief RenderOffscreen - Renders the board to a memory buffer, without using OpenGL.
+     * It does a full quality render of the current camera view, so it can be used
+     * on machines without a graphics card.
+     * @param aSize: size of the image in pixels
+     * @param aOutRGBA: receives the image, 4 bytes (RGBA) per pixel, rows from top to bottom
+     * @param aStatusTextReporter: optional reporter of the progress and timings
+     * @return true if the image was rendered
+     */
+    bool RenderOffscreen( const wxSize &aSize,
+                          std::vector<unsigned char> &aOutRGBA,
+                          REPORTER *aStatusTextReporter );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -201,7 +226,13 @@ private:
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
 
+    /// Stores the triangles of the 3D models, instanced by m_object_container
+    MAP_MODEL_ACCELERATORS m_model_accelerators;
+
+    void delete_model_accelerators();
+
     void initialize_block_positions();
+    void initialize_render_buffers();
 
     void render( GLubyte *ptrPBO, REPORTER *aStatusTextReporter );
     void render_preview( GLubyte *ptrPBO );
@@ -43,6 +43,7 @@ struct HITINFO
     float   m_tHit;                     ///< ( 4) distance
 
     const COBJECT *pHitObject;          ///< ( 4) Object that was hitted
+    const COBJECT *pHitInstance;        ///< ( 4) Model instance of the object, or NULL
     SFVEC2F m_UV;                       ///< ( 8) 2-D texture coordinates
     unsigned int m_acc_node_info;       ///< ( 4) The acc stores here the node that it hits
 
@@ -42,6 +42,23 @@ static void RAYPACKET_GenerateFrustum( CFRUSTUM *m_Frustum, RAY *m_ray )
 }
 
 
+static void RAYPACKET_GenerateSoA( RAYPACKET_SOA *aSoA, const RAY *m_ray )
+{
+    static_assert( RAYPACKET_RAYS_PER_PACKET == RAYPACKET_SOA_SIZE,
+                   "The ray packet size does not match the SIMD kernels" );
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        for( unsigned int a = 0; a < 3; ++a )
+        {
+            aSoA->m_Origin[a][i] = m_ray[i].m_Origin[a];
+            aSoA->m_Dir[a][i]    = m_ray[i].m_Dir[a];
+            aSoA->m_InvDir[a][i] = m_ray[i].m_InvDir[a];
+        }
+    }
+}
+
+
 RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
 {
     unsigned int i = 0;
@@ -66,6 +83,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera, const SFVEC2I &aWindowsPosition )
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_GenerateSoA( &m_soa, m_ray );
 }
 
 
@@ -75,6 +93,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     RAYPACKET_InitRays( aCamera, aWindowsPosition, m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_GenerateSoA( &m_soa, m_ray );
 }
 
 
@@ -88,6 +107,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
                                            m_ray );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_GenerateSoA( &m_soa, m_ray );
 }
 
 
@@ -119,6 +139,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_GenerateSoA( &m_soa, m_ray );
 }
 
 
@@ -148,6 +169,7 @@ RAYPACKET::RAYPACKET( const CCAMERA &aCamera,
     wxASSERT( i == RAYPACKET_RAYS_PER_PACKET );
 
     RAYPACKET_GenerateFrustum( &m_Frustum, m_ray );
+    RAYPACKET_GenerateSoA( &m_soa, m_ray );
 }
 
 
@@ -32,6 +32,7 @@
 
 #include "ray.h"
 #include "cfrustum.h"
+#include "raypacket_simd.h"
 #include "../ccamera.h"
 
 #define RAYPACKET_DIM (1 << 3)
@@ -42,8 +43,9 @@
 
 struct RAYPACKET
 {
-    CFRUSTUM    m_Frustum;
-    RAY         m_ray[RAYPACKET_RAYS_PER_PACKET];
+    CFRUSTUM      m_Frustum;
+    RAY           m_ray[RAYPACKET_RAYS_PER_PACKET];
+    RAYPACKET_SOA m_soa;   ///< copy of the rays used by the vectorised kernels
 
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2I &aWindowsPosition );
@@ -0,0 +1,439 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.cpp
+ * @brief Vectorised ray packet intersection kernels.
+ */
+
+#include "raypacket_simd.h"
+
+// The vectorised kernels are compiled for their own instruction set with the function
+// target attribute, so the rest of the code does not depend on the build flags.
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define RAYPACKET_X86
+#include <immintrin.h>
+#define RAYPACKET_SSE_TARGET  __attribute__(( target( "sse2" ) ))
+#define RAYPACKET_AVX2_TARGET __attribute__(( target( "avx2" ) ))
+#endif
+
+
+// Minimum and maximum with the same results as the minps and maxps instructions:
+// the second operand is returned if any of them is NaN, so a NaN distance (a ray
+// parallel to a box plane) does not change the current interval
+static inline float vmin( float a, float b )
+{
+    return a < b ? a : b;
+}
+
+
+static inline float vmax( float a, float b )
+{
+    return a > b ? a : b;
+}
+
+
+static inline uint64_t firstRaysMask( unsigned int aFirst )
+{
+    return ~(uint64_t)0 << aFirst;
+}
+
+
+// Scalar kernels
+// /////////////////////////////////////////////////////////////////////////////
+
+static uint64_t intersectBBoxScalar( const RAYPACKET_SOA &aRays,
+                                     const float *aMin,
+                                     const float *aMax,
+                                     const float *aTHit,
+                                     unsigned int aFirst )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < RAYPACKET_SOA_SIZE; ++i )
+    {
+        float tNear = 0.0f;
+        float tFar = aTHit[i];
+
+        for( unsigned int a = 0; a < 3; ++a )
+        {
+            const float t0 = ( aMin[a] - aRays.m_Origin[a][i] ) * aRays.m_InvDir[a][i];
+            const float t1 = ( aMax[a] - aRays.m_Origin[a][i] ) * aRays.m_InvDir[a][i];
+
+            tNear = vmax( vmin( t0, t1 ), tNear );
+            tFar  = vmin( vmax( t0, t1 ), tFar );
+        }
+
+        if( tNear <= tFar )
+            mask |= (uint64_t)1 << i;
+    }
+
+    return mask;
+}
+
+
+static uint64_t intersectTriangleScalar( const RAYPACKET_SOA &aRays,
+                                         const RAYPACKET_TRIANGLE &aTri,
+                                         const float *aTHit,
+                                         uint64_t aMask )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_SOA_SIZE; ++i )
+    {
+        if( !( ( aMask >> i ) & 1 ) )
+            continue;
+
+        const float Ok = aRays.m_Origin[aTri.m_k][i];
+        const float Ou = aRays.m_Origin[aTri.m_ku][i];
+        const float Ov = aRays.m_Origin[aTri.m_kv][i];
+        const float Dk = aRays.m_Dir[aTri.m_k][i];
+        const float Du = aRays.m_Dir[aTri.m_ku][i];
+        const float Dv = aRays.m_Dir[aTri.m_kv][i];
+
+        const float lnd = 1.0f / ( Dk + aTri.m_nu * Du + aTri.m_nv * Dv );
+        const float t = ( aTri.m_nd - Ok - aTri.m_nu * Ou - aTri.m_nv * Ov ) * lnd;
+
+        if( !( ( aTHit[i] > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = Ou + t * Du - aTri.m_au;
+        const float hv = Ov + t * Dv - aTri.m_av;
+        const float beta = hv * aTri.m_bnu + hu * aTri.m_bnv;
+
+        if( beta < 0.0f )
+            continue;
+
+        const float gamma = hu * aTri.m_cnu + hv * aTri.m_cnv;
+
+        if( gamma < 0.0f )
+            continue;
+
+        if( ( beta + gamma ) > 1.0f )
+            continue;
+
+        const float dot = aRays.m_Dir[0][i] * aTri.m_n[0] +
+                          aRays.m_Dir[1][i] * aTri.m_n[1] +
+                          aRays.m_Dir[2][i] * aTri.m_n[2];
+
+        if( dot > 0.0f )
+            continue;
+
+        mask |= (uint64_t)1 << i;
+    }
+
+    return mask;
+}
+
+
+#ifdef RAYPACKET_X86
+
+// SSE kernels, 4 rays per instruction
+// /////////////////////////////////////////////////////////////////////////////
+
+RAYPACKET_SSE_TARGET
+static uint64_t intersectBBoxSSE( const RAYPACKET_SOA &aRays,
+                                  const float *aMin,
+                                  const float *aMax,
+                                  const float *aTHit,
+                                  unsigned int aFirst )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_SOA_SIZE; i += 4 )
+    {
+        __m128 tNear = _mm_setzero_ps();
+        __m128 tFar = _mm_loadu_ps( aTHit + i );
+
+        for( unsigned int a = 0; a < 3; ++a )
+        {
+            const __m128 o = _mm_loadu_ps( aRays.m_Origin[a] + i );
+            const __m128 inv = _mm_loadu_ps( aRays.m_InvDir[a] + i );
+            const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aMin[a] ), o ), inv );
+            const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aMax[a] ), o ), inv );
+
+            tNear = _mm_max_ps( _mm_min_ps( t0, t1 ), tNear );
+            tFar  = _mm_min_ps( _mm_max_ps( t0, t1 ), tFar );
+        }
+
+        mask |= (uint64_t)_mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) ) << i;
+    }
+
+    return mask & firstRaysMask( aFirst );
+}
+
+
+RAYPACKET_SSE_TARGET
+static uint64_t intersectTriangleSSE( const RAYPACKET_SOA &aRays,
+                                      const RAYPACKET_TRIANGLE &aTri,
+                                      const float *aTHit,
+                                      uint64_t aMask )
+{
+    const __m128 nu = _mm_set1_ps( aTri.m_nu );
+    const __m128 nv = _mm_set1_ps( aTri.m_nv );
+    const __m128 nd = _mm_set1_ps( aTri.m_nd );
+    const __m128 bnu = _mm_set1_ps( aTri.m_bnu );
+    const __m128 bnv = _mm_set1_ps( aTri.m_bnv );
+    const __m128 cnu = _mm_set1_ps( aTri.m_cnu );
+    const __m128 cnv = _mm_set1_ps( aTri.m_cnv );
+    const __m128 au = _mm_set1_ps( aTri.m_au );
+    const __m128 av = _mm_set1_ps( aTri.m_av );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_SOA_SIZE; i += 4 )
+    {
+        if( !( ( aMask >> i ) & 0xF ) )
+            continue;
+
+        const __m128 Ok = _mm_loadu_ps( aRays.m_Origin[aTri.m_k] + i );
+        const __m128 Ou = _mm_loadu_ps( aRays.m_Origin[aTri.m_ku] + i );
+        const __m128 Ov = _mm_loadu_ps( aRays.m_Origin[aTri.m_kv] + i );
+        const __m128 Dk = _mm_loadu_ps( aRays.m_Dir[aTri.m_k] + i );
+        const __m128 Du = _mm_loadu_ps( aRays.m_Dir[aTri.m_ku] + i );
+        const __m128 Dv = _mm_loadu_ps( aRays.m_Dir[aTri.m_kv] + i );
+
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( Dk, _mm_mul_ps( nu, Du ) ),
+                                                         _mm_mul_ps( nv, Dv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, Ok ),
+                                                             _mm_mul_ps( nu, Ou ) ),
+                                                 _mm_mul_ps( nv, Ov ) ),
+                                     lnd );
+
+        __m128 pass = _mm_and_ps( _mm_cmpgt_ps( _mm_loadu_ps( aTHit + i ), t ),
+                                  _mm_cmpgt_ps( t, zero ) );
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( Ou, _mm_mul_ps( t, Du ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( Ov, _mm_mul_ps( t, Dv ) ), av );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        pass = _mm_and_ps( pass, _mm_cmpnlt_ps( beta, zero ) );
+        pass = _mm_and_ps( pass, _mm_cmpnlt_ps( gamma, zero ) );
+        pass = _mm_and_ps( pass, _mm_cmpngt_ps( _mm_add_ps( beta, gamma ), one ) );
+
+        const __m128 dot = _mm_add_ps( _mm_add_ps(
+                _mm_mul_ps( _mm_loadu_ps( aRays.m_Dir[0] + i ), _mm_set1_ps( aTri.m_n[0] ) ),
+                _mm_mul_ps( _mm_loadu_ps( aRays.m_Dir[1] + i ), _mm_set1_ps( aTri.m_n[1] ) ) ),
+                _mm_mul_ps( _mm_loadu_ps( aRays.m_Dir[2] + i ), _mm_set1_ps( aTri.m_n[2] ) ) );
+
+        pass = _mm_and_ps( pass, _mm_cmpngt_ps( dot, zero ) );
+
+        mask |= (uint64_t)_mm_movemask_ps( pass ) << i;
+    }
+
+    return mask & aMask;
+}
+
+
+// AVX2 kernels, 8 rays per instruction
+// /////////////////////////////////////////////////////////////////////////////
+
+RAYPACKET_AVX2_TARGET
+static uint64_t intersectBBoxAVX2( const RAYPACKET_SOA &aRays,
+                                   const float *aMin,
+                                   const float *aMax,
+                                   const float *aTHit,
+                                   unsigned int aFirst )
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < RAYPACKET_SOA_SIZE; i += 8 )
+    {
+        __m256 tNear = _mm256_setzero_ps();
+        __m256 tFar = _mm256_loadu_ps( aTHit + i );
+
+        for( unsigned int a = 0; a < 3; ++a )
+        {
+            const __m256 o = _mm256_loadu_ps( aRays.m_Origin[a] + i );
+            const __m256 inv = _mm256_loadu_ps( aRays.m_InvDir[a] + i );
+            const __m256 t0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aMin[a] ), o ), inv );
+            const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( aMax[a] ), o ), inv );
+
+            tNear = _mm256_max_ps( _mm256_min_ps( t0, t1 ), tNear );
+            tFar  = _mm256_min_ps( _mm256_max_ps( t0, t1 ), tFar );
+        }
+
+        mask |= (uint64_t)_mm256_movemask_ps( _mm256_cmp_ps( tNear, tFar, _CMP_LE_OQ ) ) << i;
+    }
+
+    return mask & firstRaysMask( aFirst );
+}
+
+
+RAYPACKET_AVX2_TARGET
+static uint64_t intersectTriangleAVX2( const RAYPACKET_SOA &aRays,
+                                       const RAYPACKET_TRIANGLE &aTri,
+                                       const float *aTHit,
+                                       uint64_t aMask )
+{
+    const __m256 nu = _mm256_set1_ps( aTri.m_nu );
+    const __m256 nv = _mm256_set1_ps( aTri.m_nv );
+    const __m256 nd = _mm256_set1_ps( aTri.m_nd );
+    const __m256 bnu = _mm256_set1_ps( aTri.m_bnu );
+    const __m256 bnv = _mm256_set1_ps( aTri.m_bnv );
+    const __m256 cnu = _mm256_set1_ps( aTri.m_cnu );
+    const __m256 cnv = _mm256_set1_ps( aTri.m_cnv );
+    const __m256 au = _mm256_set1_ps( aTri.m_au );
+    const __m256 av = _mm256_set1_ps( aTri.m_av );
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps( 1.0f );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = 0; i < RAYPACKET_SOA_SIZE; i += 8 )
+    {
+        if( !( ( aMask >> i ) & 0xFF ) )
+            continue;
+
+        const __m256 Ok = _mm256_loadu_ps( aRays.m_Origin[aTri.m_k] + i );
+        const __m256 Ou = _mm256_loadu_ps( aRays.m_Origin[aTri.m_ku] + i );
+        const __m256 Ov = _mm256_loadu_ps( aRays.m_Origin[aTri.m_kv] + i );
+        const __m256 Dk = _mm256_loadu_ps( aRays.m_Dir[aTri.m_k] + i );
+        const __m256 Du = _mm256_loadu_ps( aRays.m_Dir[aTri.m_ku] + i );
+        const __m256 Dv = _mm256_loadu_ps( aRays.m_Dir[aTri.m_kv] + i );
+
+        const __m256 lnd = _mm256_div_ps( one,
+                _mm256_add_ps( _mm256_add_ps( Dk, _mm256_mul_ps( nu, Du ) ),
+                               _mm256_mul_ps( nv, Dv ) ) );
+        const __m256 t = _mm256_mul_ps( _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, Ok ),
+                                                                      _mm256_mul_ps( nu, Ou ) ),
+                                                       _mm256_mul_ps( nv, Ov ) ),
+                                        lnd );
+
+        __m256 pass = _mm256_and_ps( _mm256_cmp_ps( _mm256_loadu_ps( aTHit + i ), t, _CMP_GT_OQ ),
+                                     _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( Ou, _mm256_mul_ps( t, Du ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( Ov, _mm256_mul_ps( t, Dv ) ), av );
+        const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        pass = _mm256_and_ps( pass, _mm256_cmp_ps( beta, zero, _CMP_NLT_UQ ) );
+        pass = _mm256_and_ps( pass, _mm256_cmp_ps( gamma, zero, _CMP_NLT_UQ ) );
+        pass = _mm256_and_ps( pass, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), one,
+                                                   _CMP_NGT_UQ ) );
+
+        const __m256 dot = _mm256_add_ps( _mm256_add_ps(
+                _mm256_mul_ps( _mm256_loadu_ps( aRays.m_Dir[0] + i ),
+                               _mm256_set1_ps( aTri.m_n[0] ) ),
+                _mm256_mul_ps( _mm256_loadu_ps( aRays.m_Dir[1] + i ),
+                               _mm256_set1_ps( aTri.m_n[1] ) ) ),
+                _mm256_mul_ps( _mm256_loadu_ps( aRays.m_Dir[2] + i ),
+                               _mm256_set1_ps( aTri.m_n[2] ) ) );
+
+        pass = _mm256_and_ps( pass, _mm256_cmp_ps( dot, zero, _CMP_NGT_UQ ) );
+
+        mask |= (uint64_t)_mm256_movemask_ps( pass ) << i;
+    }
+
+    return mask & aMask;
+}
+
+#endif // RAYPACKET_X86
+
+
+// Runtime selection
+// /////////////////////////////////////////////////////////////////////////////
+
+static RAYPACKET_SIMD bestSimdLevel()
+{
+#ifdef RAYPACKET_X86
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "avx2" ) )
+        return RAYPACKET_SIMD_AVX2;
+
+    if( __builtin_cpu_supports( "sse2" ) )
+        return RAYPACKET_SIMD_SSE;
+#endif
+
+    return RAYPACKET_SIMD_SCALAR;
+}
+
+
+static RAYPACKET_SIMD s_simdLevel = bestSimdLevel();
+
+
+RAYPACKET_SIMD RAYPACKET_GetSimdLevel()
+{
+    return s_simdLevel;
+}
+
+
+RAYPACKET_SIMD RAYPACKET_SetSimdLevel( RAYPACKET_SIMD aLevel )
+{
+    const RAYPACKET_SIMD best = bestSimdLevel();
+
+    s_simdLevel = ( aLevel > best ) ? best : aLevel;
+
+    return s_simdLevel;
+}
+
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aRays,
+                                  const float *aMin,
+                                  const float *aMax,
+                                  const float *aTHit,
+                                  unsigned int aFirst )
+{
+    if( aFirst >= RAYPACKET_SOA_SIZE )
+        return 0;
+
+    switch( s_simdLevel )
+    {
+#ifdef RAYPACKET_X86
+    case RAYPACKET_SIMD_AVX2:
+        return intersectBBoxAVX2( aRays, aMin, aMax, aTHit, aFirst );
+
+    case RAYPACKET_SIMD_SSE:
+        return intersectBBoxSSE( aRays, aMin, aMax, aTHit, aFirst );
+#endif
+
+    default:
+        return intersectBBoxScalar( aRays, aMin, aMax, aTHit, aFirst );
+    }
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aRays,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      uint64_t aMask )
+{
+    switch( s_simdLevel )
+    {
+#ifdef RAYPACKET_X86
+    case RAYPACKET_SIMD_AVX2:
+        return intersectTriangleAVX2( aRays, aTriangle, aTHit, aMask );
+
+    case RAYPACKET_SIMD_SSE:
+        return intersectTriangleSSE( aRays, aTriangle, aTHit, aMask );
+#endif
+
+    default:
+        return intersectTriangleScalar( aRays, aTriangle, aTHit, aMask );
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.h
+ * @brief Vectorised ray packet intersection kernels.
+ *
+ * The kernels test all the rays of a packet at once, 4 (SSE) or 8 (AVX2) rays per
+ * instruction, and return a bit mask of the rays that hit. The instruction set is
+ * selected at runtime, with a scalar implementation used on other processors.
+ */
+
+#ifndef _RAYPACKET_SIMD_H_
+#define _RAYPACKET_SIMD_H_
+
+#include <stdint.h>
+
+#define RAYPACKET_SOA_SIZE 64
+
+
+/// Structure of arrays layout of the rays of a packet, indexed by axis and ray
+struct RAYPACKET_SOA
+{
+    float m_Origin[3][RAYPACKET_SOA_SIZE];
+    float m_Dir[3][RAYPACKET_SOA_SIZE];
+    float m_InvDir[3][RAYPACKET_SOA_SIZE];
+};
+
+
+/// Precalculated triangle constants used by the packet triangle intersection test
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int m_k, m_ku, m_kv;   ///< projection axis and the two other axes
+    float m_nu, m_nv, m_nd;
+    float m_bnu, m_bnv;
+    float m_cnu, m_cnv;
+    float m_au, m_av;               ///< first vertex, projected
+    float m_n[3];                   ///< face normal
+};
+
+
+enum RAYPACKET_SIMD
+{
+    RAYPACKET_SIMD_SCALAR,
+    RAYPACKET_SIMD_SSE,
+    RAYPACKET_SIMD_AVX2
+};
+
+
+/**
+ * @brief RAYPACKET_GetSimdLevel
+ * @return the instruction set currently used by the kernels
+ */
+RAYPACKET_SIMD RAYPACKET_GetSimdLevel();
+
+/**
+ * @brief RAYPACKET_SetSimdLevel - selects the instruction set used by the kernels.
+ * It is limited to the best one supported by the processor. It must not be called
+ * while rays are being traced.
+ * @return the instruction set that was selected
+ */
+RAYPACKET_SIMD RAYPACKET_SetSimdLevel( RAYPACKET_SIMD aLevel );
+
+/**
+ * @brief RAYPACKET_IntersectBBox - finds the rays entering an axis aligned box
+ * before their current hit distance.
+ * @param aRays: the packet rays
+ * @param aMin: minimum corner of the box
+ * @param aMax: maximum corner of the box
+ * @param aTHit: current hit distance of each ray
+ * @param aFirst: index of the first ray to test, the rays before it are not reported
+ * @return mask of the rays hitting the box
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET_SOA &aRays,
+                                  const float *aMin,
+                                  const float *aMax,
+                                  const float *aTHit,
+                                  unsigned int aFirst );
+
+/**
+ * @brief RAYPACKET_IntersectTriangle - finds the rays hitting the front face of a triangle
+ * before their current hit distance. It does the same test as CTRIANGLE::Intersect(),
+ * the hit information has to be computed by it.
+ * @param aRays: the packet rays
+ * @param aTriangle: the triangle constants
+ * @param aTHit: current hit distance of each ray
+ * @param aMask: mask of the rays to test
+ * @return mask of the rays hitting the triangle
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET_SOA &aRays,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      const float *aTHit,
+                                      uint64_t aMask );
+
+#endif // _RAYPACKET_SIMD_H_
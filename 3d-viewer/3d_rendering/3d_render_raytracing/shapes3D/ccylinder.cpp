@@ -121,6 +121,7 @@ bool CVCYLINDER::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
         m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
         aHitInfo.pHitObject = this;
+        aHitInfo.pHitInstance = NULL;
     }
 
     return hitResult;
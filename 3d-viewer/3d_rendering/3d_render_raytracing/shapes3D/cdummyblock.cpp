@@ -58,6 +58,7 @@ bool CDUMMYBLOCK::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
         m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
         aHitInfo.pHitObject = this;
+        aHitInfo.pHitInstance = NULL;
 
         return true;
     }
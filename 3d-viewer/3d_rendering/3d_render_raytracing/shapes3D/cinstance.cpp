@@ -0,0 +1,97 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.cpp
+ * @brief
+ */
+
+#include "cinstance.h"
+
+
+CINSTANCE::CINSTANCE( const CGENERICACCELERATOR *aModel,
+                      const CBBOX &aModelBBox,
+                      const glm::mat4 &aModelMatrix ) : COBJECT( OBJ3D_INSTANCE )
+{
+    m_model = aModel;
+    m_invModelMatrix = glm::inverse( aModelMatrix );
+    m_normalMatrix = glm::transpose( glm::mat3( m_invModelMatrix ) );
+
+    m_bbox.Reset();
+    m_bbox.Set( aModelBBox );
+    m_bbox.ApplyTransformationAA( aModelMatrix );
+    m_bbox.ScaleNextUp();
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+void CINSTANCE::toModelRay( const RAY &aRay, RAY &aModelRay ) const
+{
+    // The direction is not normalized, so the distances along the ray are the same
+    // in model and world coordinates
+    aModelRay.Init( SFVEC3F( m_invModelMatrix * glm::vec4( aRay.m_Origin, 1.0f ) ),
+                    glm::mat3( m_invModelMatrix ) * aRay.m_Dir );
+}
+
+
+bool CINSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    RAY modelRay;
+
+    toModelRay( aRay, modelRay );
+
+    // The node of the model accelerator has no meaning for the scene accelerator
+    const unsigned int accNodeInfo = aHitInfo.m_acc_node_info;
+
+    if( !m_model->Intersect( modelRay, aHitInfo ) )
+        return false;
+
+    aHitInfo.m_acc_node_info = accNodeInfo;
+    aHitInfo.m_HitPoint = aRay.at( aHitInfo.m_tHit );
+    aHitInfo.m_HitNormal = glm::normalize( m_normalMatrix * aHitInfo.m_HitNormal );
+    aHitInfo.pHitInstance = this;
+
+    return true;
+}
+
+
+bool CINSTANCE::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    RAY modelRay;
+
+    toModelRay( aRay, modelRay );
+
+    return m_model->IntersectP( modelRay, aMaxDistance );
+}
+
+
+bool CINSTANCE::Intersects( const CBBOX &aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F CINSTANCE::GetDiffuseColor( const HITINFO &aHitInfo ) const
+{
+    // The hit object is the model object, that is shaded instead of the instance
+    return aHitInfo.pHitObject->GetDiffuseColor( aHitInfo );
+}
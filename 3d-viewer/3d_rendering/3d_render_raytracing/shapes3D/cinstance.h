@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.h
+ * @brief Implements an instance of a 3D model: the model objects, in model coordinates,
+ * placed in the scene by a transformation matrix.
+ */
+
+#ifndef _CINSTANCE_H_
+#define _CINSTANCE_H_
+
+#include "cobject.h"
+#include "../accelerators/caccelerator.h"
+
+/**
+ * An instance of a model. The model objects and their accelerator are shared by all the
+ * instances of the model, the rays are transformed to model coordinates to intersect them.
+ * The hit object reported is the object of the model, with the hit point and normal in
+ * world coordinates, and HITINFO::pHitInstance is set to the instance.
+ */
+class  CINSTANCE : public COBJECT
+{
+
+public:
+    /**
+     * @brief CINSTANCE
+     * @param aModel: accelerator of the model objects, it must live as long as the instance
+     * @param aModelBBox: bounding box of the model objects
+     * @param aModelMatrix: transformation from model to world coordinates
+     */
+    CINSTANCE( const CGENERICACCELERATOR *aModel,
+               const CBBOX &aModelBBox,
+               const glm::mat4 &aModelMatrix );
+
+    // Imported from COBJECT
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
+    bool Intersects( const CBBOX &aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
+
+private:
+    void toModelRay( const RAY &aRay, RAY &aModelRay ) const;
+
+private:
+    const CGENERICACCELERATOR *m_model;
+    glm::mat4 m_invModelMatrix;
+    glm::mat3 m_normalMatrix;
+};
+
+#endif // _CINSTANCE_H_
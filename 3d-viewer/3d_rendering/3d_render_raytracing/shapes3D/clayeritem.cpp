@@ -121,6 +121,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                         aHitInfo.m_HitPoint = aRay.at( tBot );
                         aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, -1.0f );
                         aHitInfo.pHitObject = this;
+                        aHitInfo.pHitInstance = NULL;
 
                         m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -140,6 +141,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                         aHitInfo.m_HitPoint = aRay.at( tTop );
                         aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, 1.0f );
                         aHitInfo.pHitObject = this;
+                        aHitInfo.pHitInstance = NULL;
 
                         m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -164,6 +166,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                             aHitInfo.m_HitPoint = aRay.at( tTop );
                             aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, 1.0f );
                             aHitInfo.pHitObject = this;
+                            aHitInfo.pHitInstance = NULL;
 
                             m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -188,6 +191,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                                 aHitInfo.m_HitPoint = aRay.at( tBot );
                                 aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, -1.0f );
                                 aHitInfo.pHitObject = this;
+                                aHitInfo.pHitInstance = NULL;
 
                                 m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -246,6 +250,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                 }
 
                 aHitInfo.pHitObject = this;
+                aHitInfo.pHitInstance = NULL;
 
                 m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -282,6 +287,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                 aHitInfo.m_tHit = tBBoxEnd;
                 aHitInfo.m_HitPoint = aRay.at( tBBoxEnd );
                 aHitInfo.pHitObject = this;
+                aHitInfo.pHitInstance = NULL;
 
                 if( aRay.m_Dir.z > 0.0f )
                     aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, -1.0f );
@@ -311,6 +317,7 @@ bool CLAYERITEM::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                     aHitInfo.m_HitPoint = hitPoint;
                     aHitInfo.m_HitNormal = SFVEC3F( outNormal.x, outNormal.y, 0.0f );
                     aHitInfo.pHitObject = this;
+                    aHitInfo.pHitInstance = NULL;
 
                     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -84,6 +84,7 @@ bool CXYPLANE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     aHitInfo.m_tHit = t;
     aHitInfo.m_HitPoint = aRay.at( t );
     aHitInfo.pHitObject = this;
+    aHitInfo.pHitInstance = NULL;
 
     if( aRay.m_dirIsNeg[2] )
         aHitInfo.m_HitNormal = SFVEC3F( 0.0f, 0.0f, 1.0f );
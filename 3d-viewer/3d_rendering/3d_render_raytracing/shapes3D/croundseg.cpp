@@ -88,6 +88,7 @@ bool CROUNDSEG::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                                             0.0f,
                                             aRay.m_dirIsNeg[2]? 1.0f: -1.0f );
             aHitInfo.pHitObject = this;
+            aHitInfo.pHitInstance = NULL;
 
             m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -126,6 +127,7 @@ bool CROUNDSEG::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                                                     m_plane_dir_right.y,
                                                     0.0f );
                     aHitInfo.pHitObject = this;
+                    aHitInfo.pHitInstance = NULL;
 
                     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -165,6 +167,7 @@ bool CROUNDSEG::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                                                         m_plane_dir_left.y,
                                                         0.0f );
                         aHitInfo.pHitObject = this;
+                        aHitInfo.pHitInstance = NULL;
 
                         m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -221,6 +224,7 @@ bool CROUNDSEG::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                             0.0f );
 
                 aHitInfo.pHitObject = this;
+                aHitInfo.pHitInstance = NULL;
 
                 m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
@@ -265,6 +269,7 @@ bool CROUNDSEG::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
                                 (hitPoint2D.y - m_segment.m_End.y) * m_inv_radius,
                                 0.0f );
                 aHitInfo.pHitObject = this;
+                aHitInfo.pHitInstance = NULL;
 
                 m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
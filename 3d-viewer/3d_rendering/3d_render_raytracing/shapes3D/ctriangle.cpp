@@ -262,6 +262,7 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
     aHitInfo.pHitObject = this;
+    aHitInfo.pHitInstance = NULL;
 
     return true;
 #undef ku
@@ -269,6 +270,26 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 }
 
 
+void CTRIANGLE::GetPacketData( RAYPACKET_TRIANGLE &aOut ) const
+{
+    aOut.m_k  = m_k;
+    aOut.m_ku = s_modulo[m_k + 1];
+    aOut.m_kv = s_modulo[m_k + 2];
+    aOut.m_nu = m_nu;
+    aOut.m_nv = m_nv;
+    aOut.m_nd = m_nd;
+    aOut.m_bnu = m_bnu;
+    aOut.m_bnv = m_bnv;
+    aOut.m_cnu = m_cnu;
+    aOut.m_cnv = m_cnv;
+    aOut.m_au = m_vertex[0][aOut.m_ku];
+    aOut.m_av = m_vertex[0][aOut.m_kv];
+    aOut.m_n[0] = m_n.x;
+    aOut.m_n[1] = m_n.y;
+    aOut.m_n[2] = m_n.z;
+}
+
+
 bool CTRIANGLE::IntersectP( const RAY &aRay,
                             float aMaxDistance ) const
 {
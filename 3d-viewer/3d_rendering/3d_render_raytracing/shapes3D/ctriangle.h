@@ -35,6 +35,7 @@
 #define _CTRIANGLE_H_
 
 #include "cobject.h"
+#include "../raypacket_simd.h"
 
 /**
  * A triangle object
@@ -69,6 +70,12 @@ public:
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
+    /**
+     * @brief GetPacketData - get the constants used by the packet intersection kernels
+     * @param aOut: receives the triangle constants
+     */
+    void GetPacketData( RAYPACKET_TRIANGLE &aOut ) const;
+
 private:
     void pre_calc_const();
 
@@ -37,6 +37,11 @@
 
 # include <omp.h>
 
+// Tasks, used to build trees in parallel, were introduced in OpenMP 3.0
+# if _OPENMP >= 200805
+#  define USE_OPENMP_TASKS
+# endif
+
 struct MutexType
 {
     MutexType() { omp_init_lock( &lock ); }
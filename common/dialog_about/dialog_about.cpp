@@ -581,6 +581,13 @@ void DIALOG_ABOUT::buildVersionInfoData( wxString& aMsg, bool aFormatHtml )
 #else
     aMsg << OFF;
 #endif
+
+    aMsg << indent4 << "KICAD_BOARD_ITEM_POOL=";
+#ifdef KICAD_BOARD_ITEM_POOL
+    aMsg << ON;
+#else
+    aMsg << OFF;
+#endif
 }
 
 
@@ -57,6 +57,7 @@ void DHEAD::DeleteAll()
     first = 0;
     last  = 0;
     count = 0;
+    ++revision;
 }
 
 
@@ -91,6 +92,7 @@ void DHEAD::append( EDA_ITEM* aNewElement )
     aNewElement->SetList( this );
 
     ++count;
+    ++revision;
 }
 
 
@@ -120,10 +122,12 @@ void DHEAD::append( DHEAD& aList )
         }
 
         count += aList.count;
+        ++revision;
 
         aList.count = 0;
         aList.first = NULL;
         aList.last  = NULL;
+        ++aList.revision;
     }
 }
 
@@ -166,6 +170,7 @@ void DHEAD::insert( EDA_ITEM* aNewElement, EDA_ITEM* aAfterMe )
         aNewElement->SetList( this );
 
         ++count;
+        ++revision;
     }
 }
 
@@ -199,6 +204,7 @@ void DHEAD::remove( EDA_ITEM* aElement )
     aElement->SetList( 0 );
 
     --count;
+    ++revision;
     wxASSERT( ( first && last ) || count == 0 );
 }
 
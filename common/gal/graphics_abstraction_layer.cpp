@@ -413,6 +413,30 @@ VECTOR2D GAL::GetGridPoint( const VECTOR2D& aPoint ) const
 #endif
 }
 
+void GAL::DrawGlyphs( const std::vector<const GLYPH*>& aGlyphs,
+                      const std::vector<double>& aOffsets,
+                      const VECTOR2D& aGlyphSize, double aTilt )
+{
+    std::deque<VECTOR2D> pointList;
+
+    for( size_t i = 0; i < aGlyphs.size(); ++i )
+    {
+        for( const auto& stroke : *aGlyphs[i] )
+        {
+            pointList.clear();
+
+            for( const VECTOR2D& point : stroke )
+            {
+                double y = point.y * aGlyphSize.y;
+                pointList.push_back( VECTOR2D( point.x * aGlyphSize.x - y * aTilt + aOffsets[i], y ) );
+            }
+
+            DrawPolyline( pointList );
+        }
+    }
+}
+
+
 const int GAL::MIN_DEPTH = -1024;
 const int GAL::MAX_DEPTH = 1023;
 const int GAL::GRID_DEPTH = MAX_DEPTH - 1;
@@ -35,20 +35,25 @@
 #include <gal/opengl/utils.h>
 
 #include <list>
+#include <iterator>
 #include <cassert>
+#include <cstring>
+#include <cmath>
 
-#ifdef __WXDEBUG__
 #include <wx/log.h>
+
+#ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__ */
 
 using namespace KIGFX;
 
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
-    VERTEX_CONTAINER( aSize ), m_item( NULL ), m_chunkSize( 0 ), m_chunkOffset( 0 ), m_maxIndex( 0 )
+    VERTEX_CONTAINER( aSize ), m_item( NULL ), m_chunkSize( 0 ), m_chunkOffset( 0 ),
+    m_maxIndex( 0 ), m_compactedVertices( 0 )
 {
     // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
+    resetFreeChunks( 0, aSize );
 }
 
 
@@ -58,7 +63,7 @@ void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 
     unsigned int itemSize = aItem->GetSize();
     m_item      = aItem;
-    m_chunkSize = itemSize;
+    m_chunkSize = GetSizeClass( itemSize );
 
     // Get the previously set offset if the item was stored previously
     m_chunkOffset = itemSize > 0 ? aItem->GetOffset() : -1;
@@ -74,23 +79,20 @@ void CACHED_CONTAINER::FinishItem()
     assert( m_item != NULL );
 
     unsigned int itemSize = m_item->GetSize();
+    unsigned int usedSize = GetSizeClass( itemSize );
 
     // Finishing the previously edited item
-    if( itemSize < m_chunkSize )
+    if( usedSize < m_chunkSize )
     {
         // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
-
-        // Add the not used memory back to the pool
-        addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
-
-        m_maxIndex = std::max( itemOffset + itemSize, m_maxIndex );
+        addFreeChunk( m_chunkOffset + usedSize, m_chunkSize - usedSize );
     }
 
     if( itemSize > 0 )
         m_items.insert( m_item );
 
+    updateMaxIndex();
+
     m_item = NULL;
     m_chunkSize = 0;
     m_chunkOffset = 0;
@@ -113,7 +115,9 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
     unsigned int itemSize = m_item->GetSize();
     unsigned int newSize = itemSize + aSize;
 
-    if( newSize > m_chunkSize )
+    // The reserved chunk must be able to hold the whole size class, as this is the amount of
+    // space that is going to be released when the item is deleted
+    if( GetSizeClass( newSize ) > m_chunkSize )
     {
         // There is not enough space in the currently reserved chunk, so we have to resize it
         if( !reallocate( newSize ) )
@@ -160,13 +164,17 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 #endif
 
     // Insert a free memory chunk entry in the place where item was stored
-    addFreeChunk( offset, size );
+    m_usedChunks.erase( offset );
+    addFreeChunk( offset, GetSizeClass( size ) );
 
     // Indicate that the item is not stored in the container anymore
     aItem->setSize( 0 );
 
     m_items.erase( aItem );
 
+    if( offset + size == (int) m_maxIndex )
+        updateMaxIndex();
+
 #if CACHED_CONTAINER_TEST > 0
     test();
 #endif
@@ -200,10 +208,95 @@ void CACHED_CONTAINER::Clear()
         ( *it )->setSize( 0 );
 
     m_items.clear();
+    m_usedChunks.clear();
 
     // Now there is only free space left
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+    resetFreeChunks( 0, m_freeSpace );
+}
+
+
+bool CACHED_CONTAINER::Compact( unsigned int aMaxVertices )
+{
+    assert( m_item == NULL );
+    assert( IsMapped() );
+
+    unsigned int moved = 0;
+
+    while( moved < aMaxVertices && m_freeOffsets.size() > 1 )
+    {
+        // The lowest hole in the container; everything below it is already compact
+        FREE_OFFSET_MAP::const_iterator hole = m_freeOffsets.begin();
+        unsigned int holeOffset = hole->first;
+        unsigned int holeSize   = hole->second;
+
+        // First try to fill the hole with the last stored item, so it does not have
+        // to be moved again in the next steps
+        USED_CHUNK_MAP::const_iterator last = std::prev( m_usedChunks.end() );
+        VERTEX_ITEM* item = last->second;
+        unsigned int newOffset = holeOffset;
+
+        if( last->first < holeOffset || GetSizeClass( item->GetSize() ) > holeSize )
+        {
+            // It does not fit, so slide down the item placed right after the hole
+            USED_CHUNK_MAP::const_iterator next = m_usedChunks.find( holeOffset + holeSize );
+            assert( next != m_usedChunks.end() );
+            item = next->second;
+        }
+
+        moveChunk( item, newOffset );
+        moved += item->GetSize();
+    }
+
+    if( moved > 0 )
+    {
+        m_compactedVertices += moved;
+        updateMaxIndex();
+        m_dirty = true;
+
+        wxLogTrace( "GAL_CACHED_CONTAINER",
+                    wxT( "Compacted %d vertices, %d free chunks left" ),
+                    moved, (int) m_freeOffsets.size() );
+    }
+
+#if CACHED_CONTAINER_TEST > 0
+    test();
+#endif
+
+    return m_freeOffsets.size() > 1;
+}
+
+
+double CACHED_CONTAINER::GetFragmentation() const
+{
+    if( m_freeSpace == 0 || m_freeChunks.empty() )
+        return 0.0;
+
+    // The largest free chunk is the last one in the size-ordered map
+    return 1.0 - (double) m_freeChunks.rbegin()->first / m_freeSpace;
+}
+
+
+unsigned int CACHED_CONTAINER::GetSizeClass( unsigned int aSize )
+{
+    // Small chunks are not worth splitting into separate classes
+    const unsigned int MIN_CHUNK = 8;
+
+    if( aSize == 0 )
+        return 0;
+
+    if( aSize <= MIN_CHUNK )
+        return MIN_CHUNK;
+
+    // Each power of two range is divided into 8 classes, so no more than 1/8 of the reserved
+    // space is wasted
+    unsigned int msb = 0;
+
+    for( unsigned int v = aSize; v > 1; v >>= 1 )
+        ++msb;
+
+    unsigned int step = 1u << ( msb - 3 );
+
+    return ( aSize + step - 1 ) & ~( step - 1 );
 }
 
 
@@ -218,6 +311,25 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize %p from %d to %d" ), m_item, itemSize, aSize );
 #endif
 
+    // Try to grow the current chunk in place, if it is followed by enough free space
+    if( itemSize > 0 )
+    {
+        FREE_OFFSET_MAP::iterator tail = m_freeOffsets.find( m_chunkOffset + m_chunkSize );
+
+        if( tail != m_freeOffsets.end() && m_chunkSize + tail->second >= GetSizeClass( aSize ) )
+        {
+            unsigned int tailSize = tail->second;
+
+            removeFreeChunk( tail->first, tailSize );
+            m_freeSpace -= tailSize;
+            m_chunkSize += tailSize;
+
+            return true;
+        }
+    }
+
+    aSize = GetSizeClass( aSize );
+
     // Find a free space chunk >= aSize
     FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
 
@@ -252,6 +364,10 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     assert( newChunkSize >= aSize );
     assert( newChunkOffset < m_currentSize );
 
+    // Remove the new allocated chunk from the free space pool
+    removeFreeChunk( newChunkOffset, newChunkSize );
+    m_freeSpace -= newChunkSize;
+
     // Check if the item was previously stored in the container
     if( itemSize > 0 )
     {
@@ -263,17 +379,15 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
 
         // Free the space used by the previous chunk
+        m_usedChunks.erase( m_chunkOffset );
         addFreeChunk( m_chunkOffset, m_chunkSize );
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
-
     m_chunkSize = newChunkSize;
     m_chunkOffset = newChunkOffset;
 
     m_item->setOffset( m_chunkOffset );
+    m_usedChunks[m_chunkOffset] = m_item;
 
     return true;
 }
@@ -282,22 +396,21 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
     // Defragmentation
-    ITEMS::iterator it, it_end;
     int newOffset = 0;
 
-    for( VERTEX_ITEM* item : m_items )
+    for( const auto& chunk : m_usedChunks )
     {
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        VERTEX_ITEM* item = chunk.second;
 
-        // Move an item to the new container
-        memcpy( &aTarget[newOffset], &m_vertices[itemOffset], itemSize * VERTEX_SIZE );
+        if( item == m_item )
+            continue;
 
-        // Update new offset
-        item->setOffset( newOffset );
+        // Move an item to the new container
+        memcpy( &aTarget[newOffset], &m_vertices[item->GetOffset()],
+                item->GetSize() * VERTEX_SIZE );
 
         // Move to the next free space
-        newOffset += itemSize;
+        newOffset += GetSizeClass( item->GetSize() );
     }
 
     // Move the current item and place it at the end
@@ -305,70 +418,121 @@ void CACHED_CONTAINER::defragment( VERTEX* aTarget )
     {
         memcpy( &aTarget[newOffset], &m_vertices[m_item->GetOffset()],
                 m_item->GetSize() * VERTEX_SIZE );
+    }
+
+    packChunks();
+}
+
+
+unsigned int CACHED_CONTAINER::packChunks()
+{
+    USED_CHUNK_MAP packed;
+    unsigned int newOffset = 0;
+
+    for( const auto& chunk : m_usedChunks )
+    {
+        VERTEX_ITEM* item = chunk.second;
+
+        if( item == m_item )
+            continue;
+
+        item->setOffset( newOffset );
+        packed[newOffset] = item;
+        newOffset += GetSizeClass( item->GetSize() );
+    }
+
+    // The current item keeps the whole reserved chunk
+    if( m_item && m_item->GetSize() > 0 )
+    {
         m_item->setOffset( newOffset );
+        packed[newOffset] = m_item;
         m_chunkOffset = newOffset;
     }
 
-    m_maxIndex = usedSpace();
+    m_usedChunks.swap( packed );
+    m_maxIndex = newOffset + ( m_item ? m_item->GetSize() : 0 );
+
+    return newOffset;
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+void CACHED_CONTAINER::moveChunk( VERTEX_ITEM* aItem, unsigned int aNewOffset )
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
+    unsigned int oldOffset = aItem->GetOffset();
+    unsigned int chunkSize = GetSizeClass( aItem->GetSize() );
 
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
+    FREE_OFFSET_MAP::iterator target = m_freeOffsets.find( aNewOffset );
+    assert( target != m_freeOffsets.end() );
 
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
+    // Occupy the beginning of the target chunk, the rest of it stays free
+    unsigned int targetSize = target->second;
+    assert( targetSize >= chunkSize || aNewOffset + targetSize == oldOffset );
+    removeFreeChunk( aNewOffset, targetSize );
+    m_freeSpace -= targetSize;
 
-    FREE_CHUNK_MAP::const_iterator it, it_end;
+    // Source and destination might overlap when an item slides down
+    memmove( &m_vertices[aNewOffset], &m_vertices[oldOffset], aItem->GetSize() * VERTEX_SIZE );
 
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
+    m_usedChunks.erase( oldOffset );
+    m_usedChunks[aNewOffset] = aItem;
+    aItem->setOffset( aNewOffset );
+
+    if( aNewOffset + targetSize == oldOffset )
+    {
+        // Slide: the hole moves to the end of the item
+        addFreeChunk( aNewOffset + chunkSize, targetSize );
+    }
+    else
     {
-        freeChunks.push_back( std::make_pair( it->second, it->first ) );
+        if( targetSize > chunkSize )
+            addFreeChunk( aNewOffset + chunkSize, targetSize - chunkSize );
+
+        addFreeChunk( oldOffset, chunkSize );
     }
+}
+
 
+void CACHED_CONTAINER::resetFreeChunks( unsigned int aOffset, unsigned int aSize )
+{
     m_freeChunks.clear();
-    freeChunks.sort();
+    m_freeOffsets.clear();
+
+    if( aSize > 0 )
+    {
+        m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
+        m_freeOffsets[aOffset] = aSize;
+    }
+}
+
 
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int offset = freeChunks.front().first;
-    unsigned int size   = freeChunks.front().second;
-    freeChunks.pop_front();
+void CACHED_CONTAINER::removeFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    auto range = m_freeChunks.equal_range( aSize );
 
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
+    for( FREE_CHUNK_MAP::iterator it = range.first; it != range.second; ++it )
     {
-        if( itf->first == offset + size )
+        if( getChunkOffset( *it ) == aOffset )
         {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
-        {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size   = itf->second;
-
+            m_freeChunks.erase( it );
+            break;
         }
     }
 
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
+    m_freeOffsets.erase( aOffset );
+}
 
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-    wxLogDebug( "Merged free chunks / %.1f ms", totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
+
+void CACHED_CONTAINER::updateMaxIndex()
+{
+    if( m_usedChunks.empty() )
+    {
+        m_maxIndex = 0;
+    }
+    else
+    {
+        const auto& last = *m_usedChunks.rbegin();
+        m_maxIndex = last.first + last.second->GetSize();
+    }
 }
 
 
@@ -377,8 +541,36 @@ void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
     assert( aOffset + aSize <= m_currentSize );
     assert( aSize > 0 );
 
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
     m_freeSpace += aSize;
+
+    // Merge with the following chunk
+    FREE_OFFSET_MAP::iterator next = m_freeOffsets.lower_bound( aOffset );
+
+    if( next != m_freeOffsets.end() && next->first == aOffset + aSize )
+    {
+        unsigned int nextSize = next->second;
+        removeFreeChunk( aOffset + aSize, nextSize );
+        aSize += nextSize;
+        next = m_freeOffsets.lower_bound( aOffset );
+    }
+
+    // Merge with the preceding chunk
+    if( next != m_freeOffsets.begin() )
+    {
+        FREE_OFFSET_MAP::iterator prev = std::prev( next );
+
+        if( prev->first + prev->second == aOffset )
+        {
+            unsigned int prevOffset = prev->first;
+            unsigned int prevSize   = prev->second;
+            removeFreeChunk( prevOffset, prevSize );
+            aOffset = prevOffset;
+            aSize += prevSize;
+        }
+    }
+
+    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
+    m_freeOffsets[aOffset] = aSize;
 }
 
 
@@ -439,7 +631,10 @@ void CACHED_CONTAINER::test()
     unsigned int used_space = 0;
     ITEMS::iterator itr;
     for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        used_space += ( *itr )->GetSize();
+    {
+        if( *itr != m_item )
+            used_space += GetSizeClass( ( *itr )->GetSize() );
+    }
 
     // If we have a chunk assigned, then there must be an item edited
     assert( m_chunkSize == 0 || m_item );
@@ -449,6 +644,15 @@ void CACHED_CONTAINER::test()
 
     assert( ( m_freeSpace + used_space ) == m_currentSize );
 
-    // Overlapping check TODO
+    // Overlapping check
+    unsigned int end = 0;
+
+    for( const auto& chunk : m_usedChunks )
+    {
+        assert( chunk.first >= end );
+        assert( m_freeOffsets.find( chunk.first ) == m_freeOffsets.end() );
+        end = chunk.first + ( chunk.second == m_item ? m_chunkSize
+                                                     : GetSizeClass( chunk.second->GetSize() ) );
+    }
 #endif /* __WXDEBUG__ */
 }
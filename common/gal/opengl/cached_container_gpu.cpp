@@ -122,25 +122,23 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
     checkGlError( "creating buffer during defragmentation" );
 
-    ITEMS::iterator it, it_end;
     int newOffset = 0;
 
     // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+    for( const auto& chunk : m_usedChunks )
     {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        VERTEX_ITEM* item = chunk.second;
+
+        if( item == m_item )
+            continue;
 
         // Move an item to the new container
         glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                itemOffset * VERTEX_SIZE, newOffset * VERTEX_SIZE, itemSize * VERTEX_SIZE );
-
-        // Update new offset
-        item->setOffset( newOffset );
+                item->GetOffset() * VERTEX_SIZE, newOffset * VERTEX_SIZE,
+                item->GetSize() * VERTEX_SIZE );
 
         // Move to the next free space
-        newOffset += itemSize;
+        newOffset += GetSizeClass( item->GetSize() );
     }
 
     // Move the current item and place it at the end
@@ -149,11 +147,11 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
         glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
                 m_item->GetOffset() * VERTEX_SIZE, newOffset * VERTEX_SIZE,
                 m_item->GetSize() * VERTEX_SIZE );
-
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
     }
 
+    // Update offsets of the moved items
+    packChunks();
+
     // Cleanup
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -180,8 +178,7 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     m_currentSize = aNewSize;
 
     // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    resetFreeChunks( m_currentSize - m_freeSpace, m_freeSpace );
 
     return true;
 }
@@ -246,8 +243,7 @@ bool CACHED_CONTAINER_GPU::defragmentResizeMemcpy( unsigned int aNewSize )
     m_currentSize = aNewSize;
 
     // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    resetFreeChunks( m_currentSize - m_freeSpace, m_freeSpace );
 
     return true;
 }
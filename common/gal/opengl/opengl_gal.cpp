@@ -1748,6 +1748,142 @@ void OPENGL_GAL::drawPolyline( const std::function<VECTOR2D (int)>& aPointGetter
 }
 
 
+void OPENGL_GAL::DrawGlyphs( const std::vector<const GLYPH*>& aGlyphs,
+                             const std::vector<double>& aOffsets,
+                             const VECTOR2D& aGlyphSize, double aTilt )
+{
+    // Cached vectors are referenced until the glyphs are drawn, so it cannot be pruned later
+    if( glyphCache.size() > GLYPH_CACHE_SIZE )
+        glyphCache.clear();
+
+    std::vector<const std::vector<GLYPH_VERTEX>*> tessellated( aGlyphs.size() );
+    unsigned int vertexCount = 0;
+
+    for( size_t i = 0; i < aGlyphs.size(); ++i )
+    {
+        GLYPH_CACHE_KEY key = { aGlyphs[i], aGlyphSize.x, aGlyphSize.y, aTilt, lineWidth };
+        tessellated[i] = &getTessellatedGlyph( key );
+        vertexCount += tessellated[i]->size();
+    }
+
+    if( vertexCount == 0 )
+        return;
+
+    // Line vectors need the linear part of the transformation, as in drawLineQuad()
+    const glm::mat4& transform = currentManager->GetTransformation();
+
+    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
+
+    // The whole line of text is stored in a single vertex range
+    if( !currentManager->Reserve( vertexCount ) )
+        return;
+
+    for( size_t i = 0; i < aGlyphs.size(); ++i )
+    {
+        for( const GLYPH_VERTEX& v : *tessellated[i] )
+        {
+            if( v.shader[0] == SHADER_LINE )
+            {
+                currentManager->Shader( SHADER_LINE,
+                        transform[0][0] * v.shader[1] + transform[1][0] * v.shader[2],
+                        transform[0][1] * v.shader[1] + transform[1][1] * v.shader[2],
+                        v.shader[3] );
+            }
+            else
+            {
+                currentManager->Shader( v.shader[0], v.shader[1], v.shader[2], v.shader[3] );
+            }
+
+            currentManager->Vertex( v.x + aOffsets[i], v.y, layerDepth );
+        }
+    }
+}
+
+
+const std::vector<OPENGL_GAL::GLYPH_VERTEX>& OPENGL_GAL::getTessellatedGlyph(
+        const GLYPH_CACHE_KEY& aKey )
+{
+    auto it = glyphCache.find( aKey );
+
+    if( it != glyphCache.end() )
+        return it->second;
+
+    std::vector<GLYPH_VERTEX>& vertices = glyphCache[aKey];
+    const double halfWidth = aKey.lineWidth / 2;
+
+    auto addVertex = [&vertices]( const VECTOR2D& aPos, float aShaderType, float aParam1,
+                                  float aParam2, float aParam3 )
+    {
+        GLYPH_VERTEX v = { aPos.x, aPos.y, { aShaderType, aParam1, aParam2, aParam3 } };
+        vertices.push_back( v );
+    };
+
+    // The same vertices as drawLineQuad() makes, before the transformation
+    auto addLineQuad = [&]( const VECTOR2D& aStart, const VECTOR2D& aEnd )
+    {
+        VECTOR2D startEndVector = aEnd - aStart;
+        double   lineLength     = startEndVector.EuclideanNorm();
+
+        if( lineLength <= 0.0 )
+            return;
+
+        double   scale          = halfWidth / lineLength;
+        VECTOR2D vector( -startEndVector.y * scale, startEndVector.x * scale );
+
+        addVertex( aStart, SHADER_LINE,  vector.x,  vector.y, aKey.lineWidth );    // v0
+        addVertex( aStart, SHADER_LINE, -vector.x, -vector.y, aKey.lineWidth );    // v1
+        addVertex( aEnd,   SHADER_LINE, -vector.x, -vector.y, aKey.lineWidth );    // v3
+        addVertex( aStart, SHADER_LINE,  vector.x,  vector.y, aKey.lineWidth );    // v0
+        addVertex( aEnd,   SHADER_LINE, -vector.x, -vector.y, aKey.lineWidth );    // v3
+        addVertex( aEnd,   SHADER_LINE,  vector.x,  vector.y, aKey.lineWidth );    // v2
+    };
+
+    // The same vertices as drawFilledSemiCircle() makes, before the transformation
+    auto addSemiCircle = [&]( const VECTOR2D& aCenterPoint, double aAngle )
+    {
+        const VECTOR2D corners[3] = {
+            VECTOR2D( -halfWidth * 3.0 / sqrt( 3.0 ), 0.0 ),
+            VECTOR2D( halfWidth * 3.0 / sqrt( 3.0 ), 0.0 ),
+            VECTOR2D( 0.0, halfWidth * 2.0 )
+        };
+
+        for( int i = 0; i < 3; ++i )
+            addVertex( aCenterPoint + corners[i].Rotate( aAngle ), SHADER_FILLED_CIRCLE,
+                       4.0f + i, 0.0f, 0.0f );
+    };
+
+    std::vector<VECTOR2D> points;
+
+    for( const auto& stroke : *aKey.glyph )
+    {
+        if( stroke.size() < 2 )
+            continue;
+
+        points.clear();
+
+        for( const VECTOR2D& point : stroke )
+        {
+            double y = point.y * aKey.sizeY;
+            points.push_back( VECTOR2D( point.x * aKey.sizeX - y * aKey.tilt, y ) );
+        }
+
+        // Segments with a line cap at the start, see drawPolyline()
+        for( size_t i = 1; i < points.size(); ++i )
+        {
+            addLineQuad( points[i - 1], points[i] );
+            addSemiCircle( points[i - 1], ( points[i] - points[i - 1] ).Angle() + M_PI / 2 );
+        }
+
+        // ..and the ending cap
+        const VECTOR2D& start = points[points.size() - 2];
+        const VECTOR2D& end = points.back();
+        addSemiCircle( end, ( end - start ).Angle() - M_PI / 2 );
+    }
+
+    return vertices;
+}
+
+
 int OPENGL_GAL::drawBitmapChar( unsigned long aChar )
 {
     const float TEX_X = font_image.width;
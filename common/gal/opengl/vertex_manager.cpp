@@ -38,9 +38,16 @@
 using namespace KIGFX;
 
 VERTEX_MANAGER::VERTEX_MANAGER( bool aCached ) :
-    m_noTransform( true ), m_transform( 1.0f ), m_reserved( NULL ), m_reservedSpace( 0 )
+    VERTEX_MANAGER( VERTEX_CONTAINER::MakeContainer( aCached ) )
 {
-    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached ) );
+}
+
+
+VERTEX_MANAGER::VERTEX_MANAGER( VERTEX_CONTAINER* aContainer ) :
+    m_noTransform( true ), m_transform( 1.0f ), m_reserved( NULL ), m_reservedSpace( 0 ),
+    m_compacting( false )
+{
+    m_container.reset( aContainer );
     m_gpu.reset( GPU_MANAGER::MakeManager( m_container.get() ) );
 
     // There is no shader used by default
@@ -57,6 +64,16 @@ void VERTEX_MANAGER::Map()
 
 void VERTEX_MANAGER::Unmap()
 {
+    if( m_container->IsCached() )
+    {
+        CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container.get() );
+
+        // Fill the holes left by removed items a bit at a time, instead of waiting until
+        // the container runs out of continuous space and has to be defragmented at once
+        if( m_compacting || cached->GetFragmentation() > COMPACTION_THRESHOLD )
+            m_compacting = cached->Compact( COMPACTION_BUDGET );
+    }
+
     m_container->Unmap();
 }
 
@@ -307,6 +307,12 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     const auto& overbars = processedText.second;
     int i = 0;
 
+    // Glyphs are collected and drawn all at once, so the GAL may batch them
+    std::vector<const GLYPH*> glyphs;
+    std::vector<double> glyphOffsets;
+    glyphs.reserve( text.size() );
+    glyphOffsets.reserve( text.size() );
+
     for( UTF8::uni_iter chIt = text.ubegin(), end = text.uend(); chIt < end; ++chIt )
     {
         int dd = *chIt - ' ';
@@ -314,8 +320,8 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
         if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
             dd = '?' - ' ';
 
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        const GLYPH& glyph = m_glyphs[dd];
+        const BOX2D& bbox  = m_glyphBoundingBoxes[dd];
 
         if( overbars[i] )
         {
@@ -342,36 +348,22 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             last_had_overbar = false;
         }
 
-        for( GLYPH::iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
-             ++pointListIt )
-        {
-            std::deque<VECTOR2D> pointListScaled;
-
-            for( std::deque<VECTOR2D>::iterator pointIt = pointListIt->begin();
-                 pointIt != pointListIt->end(); ++pointIt )
-            {
-                VECTOR2D pointPos( pointIt->x * glyphSize.x + xOffset, pointIt->y * glyphSize.y );
-
-                if( m_gal->IsFontItalic() )
-                {
-                    // FIXME should be done other way - referring to the lowest Y value of point
-                    // because now italic fonts are translated a bit
-                    if( m_gal->IsTextMirrored() )
-                        pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
-                    else
-                        pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
-                }
-
-                pointListScaled.push_back( pointPos );
-            }
-
-            m_gal->DrawPolyline( pointListScaled );
-        }
+        glyphs.push_back( &glyph );
+        glyphOffsets.push_back( xOffset );
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
         ++i;
     }
 
+    // FIXME should be done other way - referring to the lowest Y value of point
+    // because now italic fonts are translated a bit
+    double tilt = 0.0;
+
+    if( m_gal->IsFontItalic() )
+        tilt = m_gal->IsTextMirrored() ? -ITALIC_TILT : ITALIC_TILT;
+
+    m_gal->DrawGlyphs( glyphs, glyphOffsets, glyphSize, tilt );
+
     m_gal->Restore();
 }
 
@@ -33,6 +33,7 @@
 #include <list>
 #include <algorithm>
 #include <unordered_set>
+#include <stdexcept>
 
 #include <common.h>
 #include <md5_hash.h>
@@ -2079,10 +2080,21 @@ void SHAPE_POLY_SET::CacheTriangulation()
         return;
     }
 
-    for( int i = 0; i < tmpSet.OutlineCount(); i++ )
+    try
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        triangulateSingle( tmpSet.Polygon( i ), *m_triangulatedPolys.back() );
+        for( int i = 0; i < tmpSet.OutlineCount(); i++ )
+        {
+            m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
+            triangulateSingle( tmpSet.Polygon( i ), *m_triangulatedPolys.back() );
+        }
+    }
+    catch( const std::runtime_error& )
+    {
+        // poly2tri failed on a degenerated polygon: the polygon set is drawn
+        // without the cached triangulation
+        m_triangulatedPolys.clear();
+        m_triangulationValid = false;
+        return;
     }
 
     m_triangulationValid = true;
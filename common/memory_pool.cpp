@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_pool.cpp
+ */
+
+#include <memory_pool.h>
+
+#include <algorithm>
+#include <new>
+
+
+// Index of the size class of the blocks of aSize bytes
+static inline size_t classIndex( size_t aSize )
+{
+    return aSize == 0 ? 0 : ( aSize - 1 ) / MEMORY_POOL::BLOCK_ALIGNMENT;
+}
+
+
+MEMORY_POOL::MEMORY_POOL( size_t aMaxBlockSize, size_t aChunkSize ) :
+    m_maxBlockSize( aMaxBlockSize ),
+    m_chunkSize( aChunkSize ),
+    m_classes( classIndex( aMaxBlockSize ) + 1 )
+{
+}
+
+
+MEMORY_POOL::~MEMORY_POOL()
+{
+    for( SIZE_CLASS& sizeClass : m_classes )
+    {
+        for( char* chunk : sizeClass.m_chunks )
+            ::operator delete( chunk );
+    }
+}
+
+
+void MEMORY_POOL::addChunk( SIZE_CLASS& aClass, size_t aBlockSize )
+{
+    // A chunk holds at least one block
+    size_t count = std::max( m_chunkSize / aBlockSize, (size_t) 1 );
+    char* chunk = static_cast<char*>( ::operator new( count * aBlockSize ) );
+
+    aClass.m_chunks.push_back( chunk );
+
+    // Chain the blocks in the address order, so they are allocated in this order
+    for( size_t ii = count; ii > 0; --ii )
+    {
+        FREE_BLOCK* block = reinterpret_cast<FREE_BLOCK*>( chunk + ( ii - 1 ) * aBlockSize );
+        block->m_next = aClass.m_freeList;
+        aClass.m_freeList = block;
+    }
+}
+
+
+void* MEMORY_POOL::Allocate( size_t aSize )
+{
+    if( aSize > m_maxBlockSize )
+        return ::operator new( aSize );
+
+    size_t index = classIndex( aSize );
+    SIZE_CLASS& sizeClass = m_classes[index];
+    std::lock_guard<std::mutex> lock( sizeClass.m_mutex );
+
+    if( !sizeClass.m_freeList )
+        addChunk( sizeClass, ( index + 1 ) * BLOCK_ALIGNMENT );
+
+    FREE_BLOCK* block = sizeClass.m_freeList;
+    sizeClass.m_freeList = block->m_next;
+    sizeClass.m_used++;
+
+    return block;
+}
+
+
+void MEMORY_POOL::Free( void* aBlock, size_t aSize )
+{
+    if( !aBlock )
+        return;
+
+    if( aSize > m_maxBlockSize )
+    {
+        ::operator delete( aBlock );
+        return;
+    }
+
+    SIZE_CLASS& sizeClass = m_classes[classIndex( aSize )];
+    std::lock_guard<std::mutex> lock( sizeClass.m_mutex );
+
+    FREE_BLOCK* block = static_cast<FREE_BLOCK*>( aBlock );
+    block->m_next = sizeClass.m_freeList;
+    sizeClass.m_freeList = block;
+    sizeClass.m_used--;
+}
+
+
+size_t MEMORY_POOL::GetReservedSize() const
+{
+    size_t total = 0;
+
+    for( size_t ii = 0; ii < m_classes.size(); ++ii )
+    {
+        size_t blockSize = ( ii + 1 ) * BLOCK_ALIGNMENT;
+        size_t chunkBytes = std::max( m_chunkSize / blockSize, (size_t) 1 ) * blockSize;
+        std::lock_guard<std::mutex> lock( m_classes[ii].m_mutex );
+
+        total += m_classes[ii].m_chunks.size() * chunkBytes;
+    }
+
+    return total;
+}
+
+
+size_t MEMORY_POOL::GetUsedSize() const
+{
+    size_t total = 0;
+
+    for( size_t ii = 0; ii < m_classes.size(); ++ii )
+    {
+        std::lock_guard<std::mutex> lock( m_classes[ii].m_mutex );
+
+        total += m_classes[ii].m_used * ( ii + 1 ) * BLOCK_ALIGNMENT;
+    }
+
+    return total;
+}
@@ -66,7 +66,7 @@ void RENDER_SETTINGS::update()
 
 
 PAINTER::PAINTER( GAL* aGal ) :
-    m_gal( aGal ), m_brightenedColor( 0.0, 1.0, 0.0, 0.9 )
+    m_gal( aGal ), m_detail( DETAIL_FULL ), m_brightenedColor( 0.0, 1.0, 0.0, 0.9 )
 {
 }
 
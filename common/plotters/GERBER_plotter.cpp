@@ -45,8 +45,6 @@
 
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
-    workFile  = NULL;
-    finalFile = NULL;
     currentAperture = apertures.end();
     m_apertureAttribute = 0;
 
@@ -101,7 +99,7 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
 
-    fprintf( outputFile, "X%dY%dD%02d*\n",
+    m_body.Print( 0, "X%dY%dD%02d*\n",
 	    KiROUND( pt.x ), KiROUND( pt.y ), dcode );
 }
 
@@ -114,9 +112,9 @@ void GERBER_PLOTTER::clearNetAttribute()
 
     // Remove all net attributes from object attributes dictionnary
     if( m_useX2Attributes )
-        fputs( "%TD*%\n", outputFile );
+        m_body.Print( 0, "%%TD*%%\n" );
     else
-        fputs( "G04 #@! TD*\n", outputFile );
+        m_body.Print( 0, "G04 #@! TD*\n" );
 
     m_objectAttributesDictionnary.clear();
 }
@@ -162,7 +160,7 @@ void GERBER_PLOTTER::formatNetAttribute( GBR_NETLIST_METADATA* aData )
         clearNetAttribute();
 
     if( !short_attribute_string.empty() )
-        fputs( short_attribute_string.c_str(), outputFile );
+        m_body.Print( 0, "%s", short_attribute_string.c_str() );
 }
 
 
@@ -170,18 +168,13 @@ bool GERBER_PLOTTER::StartPlot()
 {
     wxASSERT( outputFile );
 
-    finalFile = outputFile;     // the actual gerber file will be created later
-
-    // Create a temporary filename to store gerber file
-    // note tmpfile() does not work under Vista and W7 in user mode
-    m_workFilename = filename + wxT(".tmp");
-    workFile   = wxFopen( m_workFilename, wxT( "wt" ));
-    outputFile = workFile;
-    wxASSERT( outputFile );
-
     if( outputFile == NULL )
         return false;
 
+    // The header is written to the file, the body is kept in memory until EndPlot(),
+    // once the aperture list which goes between them is known
+    m_body.Clear();
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
@@ -226,38 +219,25 @@ bool GERBER_PLOTTER::StartPlot()
 
 bool GERBER_PLOTTER::EndPlot()
 {
-    char     line[1024];
-    wxString msg;
-
     wxASSERT( outputFile );
 
-    /* Outfile is actually a temporary file i.e. workFile */
-    fputs( "M02*\n", outputFile );
-    fflush( outputFile );
+    m_body.Print( 0, "M02*\n" );
 
-    fclose( workFile );
-    workFile   = wxFopen( m_workFilename, wxT( "rt" ));
-    wxASSERT( workFile );
-    outputFile = finalFile;
+    // Placement of apertures in RS274X, after the header already in the file
+    writeApertureList();
+    fputs( "G04 APERTURE END LIST*\n", outputFile );
 
-    // Placement of apertures in RS274X
-    while( fgets( line, 1024, workFile ) )
-    {
-        fputs( line, outputFile );
+    const std::string& body = m_body.GetString();
+    bool ok = fwrite( body.data(), 1, body.size(), outputFile ) == body.size();
 
-        if( strcmp( strtok( line, "\n\r" ), "G04 APERTURE LIST*" ) == 0 )
-        {
-            writeApertureList();
-            fputs( "G04 APERTURE END LIST*\n", outputFile );
-        }
-    }
+    m_body.Clear();
+
+    if( fclose( outputFile ) != 0 )
+        ok = false;
 
-    fclose( workFile );
-    fclose( finalFile );
-    ::wxRemoveFile( m_workFilename );
     outputFile = 0;
 
-    return true;
+    return ok;
 }
 
 
@@ -288,35 +268,48 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 }
 
 
-std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
-                        APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+size_t GERBER_PLOTTER::APERTURE_HASH::operator()( const APERTURE& aAperture ) const
 {
-    int last_D_code = 9;
+    size_t seed = std::hash<int>()( aAperture.m_Size.x );
 
-    // Search an existing aperture
-    std::vector<APERTURE>::iterator tool = apertures.begin();
-
-    while( tool != apertures.end() )
+    // boost::hash_combine
+    auto combine = [&seed]( int aValue )
     {
-        last_D_code = tool->m_DCode;
+        seed ^= std::hash<int>()( aValue ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+    };
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return tool;
+    combine( aAperture.m_Size.y );
+    combine( aAperture.m_Type );
+    combine( aAperture.m_ApertureAttribute );
+
+    return seed;
+}
+
+
+bool GERBER_PLOTTER::APERTURE_EQUAL::operator()( const APERTURE& aFirst,
+                                                 const APERTURE& aSecond ) const
+{
+    return aFirst.m_Type == aSecond.m_Type && aFirst.m_Size == aSecond.m_Size
+           && aFirst.m_ApertureAttribute == aSecond.m_ApertureAttribute;
+}
 
-        ++tool;
-    }
 
-    // Allocate a new aperture
+std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
+                        APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = apertures.empty() ? 10 : apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
-    apertures.push_back( new_tool );
+    // Search an existing aperture, or allocate a new one
+    auto inserted = m_apertureIndex.insert( std::make_pair( new_tool, apertures.size() ) );
+
+    if( inserted.second )
+        apertures.push_back( new_tool );
 
-    return apertures.end() - 1;
+    return apertures.begin() + inserted.first->second;
 }
 
 
@@ -337,7 +330,7 @@ void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
     {
         // Pick an existing aperture or create a new one
         currentAperture = getAperture( aSize, aType, aApertureAttribute );
-        fprintf( outputFile, "D%d*\n", currentAperture->m_DCode );
+        m_body.Print( 0, "D%d*\n", currentAperture->m_DCode );
     }
 }
 
@@ -484,17 +477,17 @@ void GERBER_PLOTTER::Arc( const wxPoint& aCenter, double aStAngle, double aEndAn
     DPOINT devEnd = userToDeviceCoordinates( end );
     DPOINT devCenter = userToDeviceCoordinates( aCenter ) - userToDeviceCoordinates( start );
 
-    fprintf( outputFile, "G75*\n" ); // Multiquadrant mode
+    m_body.Print( 0, "G75*\n" ); // Multiquadrant mode
 
     if( aStAngle < aEndAngle )
-        fprintf( outputFile, "G03" );
+        m_body.Print( 0, "G03" );
     else
-        fprintf( outputFile, "G02" );
+        m_body.Print( 0, "G02" );
 
-    fprintf( outputFile, "X%dY%dI%dJ%dD01*\n",
+    m_body.Print( 0, "X%dY%dI%dJ%dD01*\n",
              KiROUND( devEnd.x ), KiROUND( devEnd.y ),
              KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
-    fprintf( outputFile, "G01*\n" ); // Back to linear interp.
+    m_body.Print( 0, "G01*\n" ); // Back to linear interp.
 }
 
 
@@ -516,7 +509,7 @@ void GERBER_PLOTTER:: PlotPoly( const std::vector< wxPoint >& aCornerList,
 
     if( aFill )
     {
-        fputs( "G36*\n", outputFile );
+        m_body.Print( 0, "G36*\n" );
 
         MoveTo( aCornerList[0] );
 
@@ -524,7 +517,7 @@ void GERBER_PLOTTER:: PlotPoly( const std::vector< wxPoint >& aCornerList,
             LineTo( aCornerList[ii] );
 
         FinishTo( aCornerList[0] );
-        fputs( "G37*\n", outputFile );
+        m_body.Print( 0, "G37*\n" );
     }
 
     if( aWidth > 0 )
@@ -1010,7 +1003,7 @@ void GERBER_PLOTTER::Text( const wxPoint& aPos, const COLOR4D aColor,
 void GERBER_PLOTTER::SetLayerPolarity( bool aPositive )
 {
     if( aPositive )
-        fprintf( outputFile, "%%LPD*%%\n" );
+        m_body.Print( 0, "%%LPD*%%\n" );
     else
-        fprintf( outputFile, "%%LPC*%%\n" );
+        m_body.Print( 0, "%%LPC*%%\n" );
 }
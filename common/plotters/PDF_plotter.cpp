@@ -37,7 +37,82 @@
 #include <macros.h>
 #include <kicad_string.h>
 #include <wx/zstream.h>
-#include <wx/mstream.h>
+
+#include <boost/uuid/sha1.hpp>
+
+
+/**
+ * A wxOutputStream writing to a stdio file, which it does not own.
+ */
+class PDF_FILE_STREAM : public wxOutputStream
+{
+public:
+    PDF_FILE_STREAM( FILE* aFile ) : m_file( aFile ) {}
+
+protected:
+    size_t OnSysWrite( const void* aBuffer, size_t aSize ) override
+    {
+        size_t written = fwrite( aBuffer, 1, aSize, m_file );
+
+        if( written != aSize )
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+
+        return written;
+    }
+
+private:
+    FILE* m_file;
+};
+
+
+/**
+ * The content of a PDF stream: an OUTPUTFORMATTER deflating its output on the fly
+ * into the PDF file, so the stream is never stored in memory or in a temporary file.
+ */
+class PDF_STREAM_FORMATTER : public OUTPUTFORMATTER
+{
+public:
+    /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
+     * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
+     * stream! (a DEFLATE stream would be generated with -15 instead of 15)
+     */
+    PDF_STREAM_FORMATTER( FILE* aFile ) :
+        m_fileStream( aFile ),
+        m_zlibStream( m_fileStream, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB )
+    {
+    }
+
+    void Write( const void* aData, size_t aCount )
+    {
+        m_zlibStream.Write( aData, aCount );
+    }
+
+    /**
+     * Flush the compressed data to the file
+     * @return false on write error
+     */
+    bool Finish()
+    {
+        return m_zlibStream.Close() && m_fileStream.IsOk();
+    }
+
+protected:
+    void write( const char* aOutBuf, int aCount ) override
+    {
+        m_zlibStream.Write( aOutBuf, aCount );
+    }
+
+private:
+    PDF_FILE_STREAM    m_fileStream;
+    wxZlibOutputStream m_zlibStream;
+};
+
+
+PDF_PLOTTER::~PDF_PLOTTER()
+{
+    // Emergency cleanup, the stream is usually closed in EndPlot()
+    delete workFile;
+}
 
 
 /*
@@ -58,6 +133,8 @@ bool PDF_PLOTTER::OpenFile( const wxString& aFullFilename )
     if( outputFile == NULL )
         return false ;
 
+    setOutputBuffer();
+
     return true;
 }
 
@@ -105,7 +182,7 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
         pen_width = defaultPenWidth;
 
     if( pen_width != currentPenWidth )
-        fprintf( workFile, "%g w\n",
+        workFile->Print( 0, "%g w\n",
                  userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
@@ -124,7 +201,7 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
 {
     wxASSERT( workFile );
-    fprintf( workFile, "%g %g %g rg %g %g %g RG\n",
+    workFile->Print( 0, "%g %g %g rg %g %g %g RG\n",
              r, g, b, r, g, b );
 }
 
@@ -137,20 +214,20 @@ void PDF_PLOTTER::SetDash( int dashed )
     switch( dashed )
     {
     case PLOTDASHTYPE_DASH:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        workFile->Print( 0, "[%d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DOT:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        workFile->Print( 0, "[%d %d] 0 d\n",
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DASHDOT:
-        fprintf( workFile, "[%d %d %d %d] 0 d\n",
+        workFile->Print( 0, "[%d %d %d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU(),
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     default:
-        fputs( "[] 0 d\n", workFile );
+        workFile->Print( 0, "[] 0 d\n" );
     }
 }
 
@@ -165,7 +242,7 @@ void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( workFile, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
+    workFile->Print( 0, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
              p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
              fill == NO_FILL ? 'S' : 'B' );
 }
@@ -200,7 +277,7 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
     double magic = radius * 0.551784; // You don't want to know where this come from
 
     // This is the convex hull for the bezier approximated circle
-    fprintf( workFile, "%g %g m "
+    workFile->Print( 0, "%g %g m "
                        "%g %g %g %g %g %g c "
                        "%g %g %g %g %g %g c "
                        "%g %g %g %g %g %g c "
@@ -255,30 +332,30 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    workFile->Print( 0, "%g %g m ", pos_dev.x, pos_dev.y );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        workFile->Print( 0, "%g %g l ", pos_dev.x, pos_dev.y );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    workFile->Print( 0, "%g %g l ", pos_dev.x, pos_dev.y );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
     if( fill == NO_FILL )
     {
-        fputs( "S\n", workFile );
+        workFile->Print( 0, "S\n" );
     }
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        workFile->Print( 0, "%g %g l b\n", pos_dev.x, pos_dev.y );
     }
 }
 
@@ -296,16 +373,16 @@ void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    workFile->Print( 0, "%g %g m\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        workFile->Print( 0, "%g %g l\n", pos.x, pos.y );
     }
 
     // Close path and stroke(/fill)
-    fprintf( workFile, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
+    workFile->Print( 0, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
 }
 
 
@@ -316,7 +393,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     {
         if( penState != 'Z' )
         {
-            fputs( "S\n", workFile );
+            workFile->Print( 0, "S\n" );
             penState     = 'Z';
             penLastpos.x = -1;
             penLastpos.y = -1;
@@ -327,7 +404,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
+        workFile->Print( 0, "%g %g %c\n",
                  pos_dev.x, pos_dev.y,
                  ( plume=='D' ) ? 'l' : 'm' );
     }
@@ -336,7 +413,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 }
 
 /**
- * PDF images are handles as inline, not XObject streams...
+ * PDF images are XObject streams, written once for all the places using them
  */
 void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                             double aScaleFactor )
@@ -354,35 +431,17 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
 
     DPOINT dev_start = userToDeviceCoordinates( start );
 
-    /* PDF has an uhm... simplified coordinate system handling. There is
-       *one* operator to do everything (the PS concat equivalent). At least
-       they kept the matrix stack to save restore environments. Also images
-       are always emitted at the origin with a size of 1x1 user units.
-       What we need to do is:
-       1) save the CTM end estabilish the new one
-       2) plot the image
-       3) restore the CTM
-       4) profit
-     */
-    fprintf( workFile, "q %g 0 0 %g %g %g cm\n", // Step 1
-            userToDeviceSize( drawsize.x ),
-            userToDeviceSize( drawsize.y ),
-            dev_start.x, dev_start.y );
-
-    /* An inline image is a cross between a dictionary and a stream.
-       A real ugly construct (compared with the elegance of the PDF
-       format). Also it accepts some 'abbreviations', which is stupid
-       since the content stream is usually compressed anyway... */
-    fprintf( workFile,
-             "BI\n"
-             "  /BPC 8\n"
-             "  /CS %s\n"
-             "  /W %d\n"
-             "  /H %d\n"
-             "ID\n", colorMode ? "/RGB" : "/G", pix_size.x, pix_size.y );
-
-    /* Here comes the stream (in binary!). I *could* have hex or ascii84
-       encoded it, but who cares? I'll go through zlib anyway */
+    // The image dictionary entries (a single line), followed by the pixels
+    char dict[128];
+    snprintf( dict, sizeof( dict ),
+              "/Type /XObject /Subtype /Image /Width %d /Height %d "
+              "/ColorSpace %s /BitsPerComponent 8\n",
+              pix_size.x, pix_size.y, colorMode ? "/DeviceRGB" : "/DeviceGray" );
+
+    std::string data( dict );
+
+    data.reserve( data.size() + pix_size.x * pix_size.y * ( colorMode ? 3 : 1 ) );
+
     for( int y = 0; y < pix_size.y; y++ )
     {
         for( int x = 0; x < pix_size.x; x++ )
@@ -390,22 +449,80 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             unsigned char r = aImage.GetRed( x, y ) & 0xFF;
             unsigned char g = aImage.GetGreen( x, y ) & 0xFF;
             unsigned char b = aImage.GetBlue( x, y ) & 0xFF;
-            // As usual these days, stdio buffering has to suffeeeeerrrr
+
             if( colorMode )
             {
-            putc( r, workFile );
-            putc( g, workFile );
-            putc( b, workFile );
+                data += (char) r;
+                data += (char) g;
+                data += (char) b;
             }
             else
             {
                 // Grayscale conversion
-                putc( (r + g + b) / 3, workFile );
+                data += (char) ( ( r + g + b ) / 3 );
             }
         }
     }
 
-    fputs( "EI Q\n", workFile ); // Finish step 2 and do step 3
+    // The cache keeps the dictionary and the SHA1 of the pixels, not the pixels of all
+    // the images of the plot (a SHA1 collision between two images is not a concern)
+    boost::uuids::detail::sha1 sha1;
+    unsigned int digest[5];
+
+    sha1.process_bytes( data.data(), data.size() );
+    sha1.get_digest( digest );
+
+    std::string key( dict );
+    key.append( (const char*) digest, sizeof( digest ) );
+
+    auto inserted = imageCache.insert( std::make_pair( std::move( key ), 0 ) );
+
+    if( inserted.second )
+    {
+        // A new image: its stream will be written after the page stream
+        inserted.first->second = allocPdfObject();
+        imageHandles.push_back( inserted.first->second );
+        pendingImages.push_back( std::make_pair( inserted.first->second, std::move( data ) ) );
+    }
+
+    /* PDF has an uhm... simplified coordinate system handling. There is
+       *one* operator to do everything (the PS concat equivalent). At least
+       they kept the matrix stack to save restore environments. Also images
+       are always emitted at the origin with a size of 1x1 user units.
+       What we need to do is:
+       1) save the CTM end estabilish the new one
+       2) plot the image
+       3) restore the CTM
+       4) profit
+     */
+    workFile->Print( 0, "q %g 0 0 %g %g %g cm /Im%d Do Q\n",
+                     userToDeviceSize( drawsize.x ),
+                     userToDeviceSize( drawsize.y ),
+                     dev_start.x, dev_start.y,
+                     inserted.first->second );
+}
+
+
+/**
+ * Write the image XObjects used by the page stream just closed
+ */
+void PDF_PLOTTER::writePendingImages()
+{
+    wxASSERT( !workFile );
+
+    for( const auto& image : pendingImages )
+    {
+        const std::string& data = image.second;
+
+        // The pixels follow the dictionary entries line
+        const size_t dictSize = data.find( '\n' ) + 1;
+
+        startPdfStream( image.first, data.substr( 0, dictSize ).c_str() );
+        workFile->Write( data.data() + dictSize, data.size() - dictSize );
+        closePdfStream();
+    }
+
+    pendingImages.clear();
 }
 
 
@@ -451,12 +568,11 @@ void PDF_PLOTTER::closePdfObject()
 
 
 /**
- * Starts a PDF stream (for the page). Returns the object handle opened
- * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
- * can contain a lot of things, but for the moment we only handle page
- * content.
+ * Starts a PDF stream (for a page or an image). Returns the object handle opened
+ * Pass -1 (default) for a fresh object. aDictEntries are added to the stream
+ * dictionary, with a trailing white space.
  */
-int PDF_PLOTTER::startPdfStream(int handle)
+int PDF_PLOTTER::startPdfStream( int handle, const char* aDictEntries )
 {
     wxASSERT( outputFile );
     wxASSERT( !workFile );
@@ -466,13 +582,12 @@ int PDF_PLOTTER::startPdfStream(int handle)
     // you could allocate more object during stream preparation
     streamLengthHandle = allocPdfObject();
     fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
+             "<< %s/Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
+             "stream\n", aDictEntries, streamLengthHandle );
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
-    workFile = wxFopen( workFilename, wxT( "w+b" ));
-    wxASSERT( workFile );
+    // The stream is deflated directly into the file
+    streamStart = ftell( outputFile );
+    workFile = new PDF_STREAM_FORMATTER( outputFile );
     return handle;
 }
 
@@ -484,58 +599,21 @@ void PDF_PLOTTER::closePdfStream()
 {
     wxASSERT( workFile );
 
-    long stream_len = ftell( workFile );
-
-    if( stream_len < 0 )
-    {
-        wxASSERT( false );
-        return;
-    }
-
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
-
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
-
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
-
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
-
-    {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
-
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
-
-        zos.Write( inbuf, stream_len );
-
-        delete[] inbuf;
-
-    }   // flush the zip stream using zos destructor
+    bool ok = workFile->Finish();
+    wxASSERT( ok );
+    (void) ok;
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+    delete workFile;
+    workFile = NULL;
 
-    unsigned out_count = sb->Tell();
+    long out_count = ftell( outputFile ) - streamStart;
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
-
-    fputs( "endstream\n", outputFile );
+    fputs( "\nendstream\n", outputFile );
     closePdfObject();
 
     // Writing the deferred length as an indirect object
     startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
+    fprintf( outputFile, "%ld\n", out_count );
     closePdfObject();
 }
 
@@ -559,7 +637,7 @@ void PDF_PLOTTER::StartPage()
        compressed later in closePdfStream */
 
     // Default graphic settings (coordinate system, default color and line style)
-    fprintf( workFile,
+    workFile->Print( 0,
              "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
              0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
              userToDeviceSize( defaultPenWidth ) );
@@ -572,8 +650,9 @@ void PDF_PLOTTER::ClosePage()
 {
     wxASSERT( workFile );
 
-    // Close the page stream (and compress it)
+    // Close the page stream, and write the images it uses
     closePdfStream();
+    writePendingImages();
 
     // Emit the page object and put it in the page list for later
     pageHandles.push_back( startPdfObject() );
@@ -593,12 +672,14 @@ void PDF_PLOTTER::ClosePage()
              "/Parent %d 0 R\n"
              "/Resources <<\n"
              "    /ProcSet [/PDF /Text /ImageC /ImageB]\n"
-             "    /Font %d 0 R >>\n"
+             "    /Font %d 0 R\n"
+             "    /XObject %d 0 R >>\n"
              "/MediaBox [0 0 %d %d]\n"
              "/Contents %d 0 R\n"
              ">>\n",
              pageTreeHandle,
              fontResDictHandle,
+             xObjectDictHandle,
              int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
              int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
              pageStreamHandle );
@@ -634,6 +715,12 @@ bool PDF_PLOTTER::StartPlot()
        (it *could* be inherited via the Pages tree */
     fontResDictHandle = allocPdfObject();
 
+    // And the image dictionary
+    xObjectDictHandle = allocPdfObject();
+    imageHandles.clear();
+    imageCache.clear();
+    pendingImages.clear();
+
     /* Now, the PDF is read from the end, (more or less)... so we start
        with the page stream for page 1. Other more important stuff is written
        at the end */
@@ -693,6 +780,19 @@ bool PDF_PLOTTER::EndPlot()
     fputs( ">>\n", outputFile );
     closePdfObject();
 
+    // Named image dictionary
+    startPdfObject( xObjectDictHandle );
+    fputs( "<<\n", outputFile );
+
+    for( int handle : imageHandles )
+        fprintf( outputFile, "    /Im%d %d 0 R\n", handle, handle );
+
+    fputs( ">>\n", outputFile );
+    closePdfObject();
+
+    // The images are no more needed
+    imageCache.clear();
+
     /* The page tree: it's a B-tree but luckily we only have few pages!
        So we use just an array... The handle was allocated at the beginning,
        now we instantiate the corresponding object */
@@ -829,14 +929,14 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
        for the trig part of the matrix to avoid %g going in exponential
        format (which is not supported)
        render_mode 0 shows the text, render_mode 3 is invisible */
-    fprintf( workFile, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
+    workFile->Print( 0, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
             ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
             fontname, heightFactor, render_mode,
             wideningFactor * 100 );
 
     // The text must be escaped correctly
-    fputsPostscriptString( workFile, aText );
-    fputs( " Tj ET\n", workFile );
+    workFile->Print( 0, "%s", postscriptString( aText ).c_str() );
+    workFile->Print( 0, " Tj ET\n" );
 
     // We are in text coordinates, plot the overbars, if we're not doing phantom text
     if( use_native_font )
@@ -852,13 +952,13 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
                is the right function to use here... */
             DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
             DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-            fprintf( workFile, "%g %g m %g %g l ",
+            workFile->Print( 0, "%g %g m %g %g l ",
                     dev_from.x, dev_from.y, dev_to.x, dev_to.y );
         }
     }
 
     // Stroke and restore the CTM
-    fputs( "S Q\n", workFile );
+    workFile->Print( 0, "S Q\n" );
 
     // Plot the stroked text (if requested)
     if( !use_native_font )
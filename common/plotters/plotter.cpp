@@ -92,10 +92,24 @@ bool PLOTTER::OpenFile( const wxString& aFullFilename )
     if( outputFile == NULL )
         return false ;
 
+    setOutputBuffer();
+
     return true;
 }
 
 
+void PLOTTER::setOutputBuffer()
+{
+    // The default stdio buffer is only a few KB
+    const size_t bufferSize = 256 * 1024;
+
+    wxASSERT( outputFile );
+
+    m_outputBuffer.resize( bufferSize );
+    setvbuf( outputFile, m_outputBuffer.data(), _IOFBF, bufferSize );
+}
+
+
 DPOINT PLOTTER::userToDeviceCoordinates( const wxPoint& aCoordinate )
 {
     wxPoint pos = aCoordinate - plotOffset;
@@ -35,6 +35,13 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -52,7 +59,8 @@ public:
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
         m_groups( nullptr ),
-        m_groupsSize( 0 ) {}
+        m_groupsSize( 0 ),
+        m_pendingDetails( 0 ) {}
 
     ~VIEW_ITEM_DATA()
     {
@@ -97,6 +105,19 @@ private:
     GroupPair* m_groups;
     int        m_groupsSize;
 
+    ///> Levels of detail (as bits) that are requested to be cached on the next update
+    int        m_pendingDetails;
+
+    /**
+     * Function detailKey()
+     * Returns the key used to store group ids of an item drawn with a reduced level of detail.
+     * Groups for the full level of detail are stored with the layer number as the key.
+     */
+    static int detailKey( int aLayer, VIEW_DETAIL aDetail )
+    {
+        return aLayer + aDetail * VIEW::VIEW_MAX_LAYERS;
+    }
+
     /**
      * Function getGroup()
      * Returns number of the group id for the given layer, or -1 in case it was not cached before.
@@ -200,7 +221,8 @@ private:
     {
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            int orig_layer = m_groups[i].first;
+            int orig_layer = m_groups[i].first % VIEW::VIEW_MAX_LAYERS;
+            int detail = m_groups[i].first / VIEW::VIEW_MAX_LAYERS;
             int new_layer = orig_layer;
 
             try
@@ -209,7 +231,7 @@ private:
             }
             catch( const std::out_of_range& ) {}
 
-            m_groups[i].first = new_layer;
+            m_groups[i].first = detailKey( new_layer, (VIEW_DETAIL) detail );
         }
     }
 
@@ -290,8 +312,13 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_useDetailLevels( false ),
+    m_bulkAdd( false )
 {
+    for( int i = 0; i < DETAIL_COUNT; ++i )
+        m_detailThresholds[i] = 0.0;
+
     m_boundary.SetMaximum();
     m_allItems.reserve( 32768 );
 
@@ -352,7 +379,10 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
+
+        if( !m_bulkAdd )
+            l.items->Insert( aItem );
+
         MarkTargetDirty( l.target );
     }
 
@@ -388,12 +418,13 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
         MarkTargetDirty( l.target );
+    }
 
-        // Clear the GAL cache
-        int prevGroup = viewData->getGroup( layers[i] );
-
-        if( prevGroup >= 0 )
-            m_gal->DeleteGroup( prevGroup );
+    // Clear the GAL cache, including groups storing reduced levels of detail
+    for( int group : viewData->getAllGroups() )
+    {
+        if( group >= 0 )
+            m_gal->DeleteGroup( group );
     }
 
     viewData->deleteGroups();
@@ -498,6 +529,20 @@ double VIEW::ToScreen( double aSize ) const
 }
 
 
+VIEW_DETAIL VIEW::GetDetailLevel( const BOX2I& aBBox, bool aSimplifiable ) const
+{
+    double size = std::abs( ToScreen( (double) std::max( aBBox.GetWidth(), aBBox.GetHeight() ) ) );
+
+    if( size < m_detailThresholds[DETAIL_BBOX] )
+        return DETAIL_BBOX;
+
+    if( aSimplifiable && size < m_detailThresholds[DETAIL_SIMPLIFIED] )
+        return DETAIL_SIMPLIFIED;
+
+    return DETAIL_FULL;
+}
+
+
 void VIEW::CopySettings( const VIEW* aOtherView )
 {
     wxASSERT_MSG( false, wxT( "This is not implemented" ) );
@@ -745,10 +790,15 @@ struct VIEW::updateItemsColor
     {
         // Obtain the color that should be used for coloring the item
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
-        int group = aItem->viewPrivData()->getGroup( layer );
 
-        if( group >= 0 )
-            gal->ChangeGroupColor( group, color );
+        for( int detail = DETAIL_FULL; detail < DETAIL_COUNT; ++detail )
+        {
+            int key = VIEW_ITEM_DATA::detailKey( layer, (VIEW_DETAIL) detail );
+            int group = aItem->viewPrivData()->getGroup( key );
+
+            if( group >= 0 )
+                gal->ChangeGroupColor( group, color );
+        }
 
         return true;
     }
@@ -794,10 +844,15 @@ void VIEW::UpdateAllLayersColor()
         for( int i = 0; i < layers_count; ++i )
         {
             const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
-            int group = viewData->getGroup( layers[i] );
 
-            if( group >= 0 )
-                m_gal->ChangeGroupColor( group, color );
+            for( int detail = DETAIL_FULL; detail < DETAIL_COUNT; ++detail )
+            {
+                int key = VIEW_ITEM_DATA::detailKey( layers[i], (VIEW_DETAIL) detail );
+                int group = viewData->getGroup( key );
+
+                if( group >= 0 )
+                    m_gal->ChangeGroupColor( group, color );
+            }
         }
     }
 
@@ -815,10 +870,14 @@ struct VIEW::changeItemsDepth
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        int group = aItem->viewPrivData()->getGroup( layer );
+        for( int detail = DETAIL_FULL; detail < DETAIL_COUNT; ++detail )
+        {
+            int key = VIEW_ITEM_DATA::detailKey( layer, (VIEW_DETAIL) detail );
+            int group = aItem->viewPrivData()->getGroup( key );
 
-        if( group >= 0 )
-            gal->ChangeGroupDepth( group, depth );
+            if( group >= 0 )
+                gal->ChangeGroupDepth( group, depth );
+        }
 
         return true;
     }
@@ -921,10 +980,14 @@ void VIEW::UpdateAllLayersOrder()
 
         for( int i = 0; i < layers_count; ++i )
         {
-            int group = viewData->getGroup( layers[i] );
+            for( int detail = DETAIL_FULL; detail < DETAIL_COUNT; ++detail )
+            {
+                int key = VIEW_ITEM_DATA::detailKey( layers[i], (VIEW_DETAIL) detail );
+                int group = viewData->getGroup( key );
 
-            if( group >= 0 )
-                m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+                if( group >= 0 )
+                    m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+            }
         }
     }
 
@@ -1010,9 +1073,26 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( !viewData )
         return;
 
+    VIEW_DETAIL detail = m_useDetailLevels ? aItem->ViewGetDetail( aLayer, this ) : DETAIL_FULL;
+
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
+        if( detail != DETAIL_FULL )
+        {
+            int group = viewData->getGroup( VIEW_ITEM_DATA::detailKey( aLayer, detail ) );
+
+            if( group >= 0 )
+            {
+                m_gal->DrawGroup( group );
+                return;
+            }
+
+            // The reduced representation is going to be cached on the next update,
+            // until then the full one is used
+            viewData->m_pendingDetails |= ( 1 << detail );
+        }
+
         int group = viewData->getGroup( aLayer );
 
         if( group >= 0 )
@@ -1023,8 +1103,12 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     else
     {
         // Immediate mode
+        m_painter->SetDetailLevel( detail );
+
         if( !m_painter->Draw( aItem, aLayer ) )
             aItem->ViewDraw( aLayer, this );  // Alternative drawing method
+
+        m_painter->SetDetailLevel( DETAIL_FULL );
     }
 }
 
@@ -1074,6 +1158,7 @@ struct VIEW::recacheItem
             gal->DeleteGroup( group );
 
         viewData->setGroup( layer, -1 );
+        view->clearItemDetails( aItem, layer );
         view->Update( aItem );
 
         return true;
@@ -1085,6 +1170,13 @@ struct VIEW::recacheItem
 };
 
 
+void VIEW::EndBulkAdd()
+{
+    m_bulkAdd = false;
+    rebuildIndex();
+}
+
+
 void VIEW::Clear()
 {
     BOX2I r;
@@ -1254,11 +1346,15 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 
     // Obtain the color that should be used for coloring the item on the specific layerId
     const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
-    int group = viewData->getGroup( aLayer );
 
-    // Change the color, only if it has group assigned
-    if( group >= 0 )
-        m_gal->ChangeGroupColor( group, color );
+    for( int detail = DETAIL_FULL; detail < DETAIL_COUNT; ++detail )
+    {
+        int group = viewData->getGroup( VIEW_ITEM_DATA::detailKey( aLayer, (VIEW_DETAIL) detail ) );
+
+        // Change the color, only if it has group assigned
+        if( group >= 0 )
+            m_gal->ChangeGroupColor( group, color );
+    }
 }
 
 
@@ -1289,6 +1385,63 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
     m_gal->EndGroup();
+
+    // Reduced representations are outdated now, they will be recreated when needed
+    clearItemDetails( aItem, aLayer );
+}
+
+
+void VIEW::updateItemDetail( VIEW_ITEM* aItem, int aLayer, VIEW_DETAIL aDetail )
+{
+    auto viewData = aItem->viewPrivData();
+    wxASSERT( (unsigned) aLayer < m_layers.size() );
+    wxASSERT( IsCached( aLayer ) );
+    wxASSERT( aDetail != DETAIL_FULL );
+
+    if( !viewData )
+        return;
+
+    int key = VIEW_ITEM_DATA::detailKey( aLayer, aDetail );
+
+    if( viewData->getGroup( key ) >= 0 )
+        return;
+
+    VIEW_LAYER& l = m_layers.at( aLayer );
+
+    m_gal->SetTarget( l.target );
+    m_gal->SetLayerDepth( l.renderingOrder );
+
+    int group = m_gal->BeginGroup();
+    viewData->setGroup( key, group );
+
+    m_painter->SetDetailLevel( aDetail );
+
+    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+        aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+
+    m_painter->SetDetailLevel( DETAIL_FULL );
+    m_gal->EndGroup();
+}
+
+
+void VIEW::clearItemDetails( VIEW_ITEM* aItem, int aLayer )
+{
+    auto viewData = aItem->viewPrivData();
+
+    if( !viewData )
+        return;
+
+    for( int detail = DETAIL_SIMPLIFIED; detail < DETAIL_COUNT; ++detail )
+    {
+        int key = VIEW_ITEM_DATA::detailKey( aLayer, (VIEW_DETAIL) detail );
+        int group = viewData->getGroup( key );
+
+        if( group >= 0 )
+        {
+            m_gal->DeleteGroup( group );
+            viewData->setGroup( key, -1 );
+        }
+    }
 }
 
 
@@ -1335,6 +1488,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
                 m_gal->DeleteGroup( prevGroup );
                 viewData->setGroup( l.id, -1 );
             }
+
+            clearItemDetails( aItem, l.id );
         }
     }
 
@@ -1369,12 +1524,109 @@ bool VIEW::areRequiredLayersEnabled( int aLayerId ) const
 }
 
 
+void VIEW::prepareItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    // Starting the threads costs more than preparing a few items (e.g. while editing)
+    const size_t minParallelItems = 64;
+
+    if( aItems.size() < minParallelItems )
+    {
+        for( VIEW_ITEM* item : aItems )
+            item->ViewPrepareGeometry();
+
+        return;
+    }
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aItems.size() );
+    std::atomic<size_t> next( 0 );
+    std::vector<std::thread> workers;
+
+    // An exception escaping a thread would terminate the program: the first one is
+    // passed to the caller, as if the items were prepared in the calling thread
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        workers.push_back( std::thread( [ &aItems, &next, &error, &errorLock ]()
+        {
+            for( size_t i = next.fetch_add( 1 ); i < aItems.size(); i = next.fetch_add( 1 ) )
+            {
+                try
+                {
+                    aItems[i]->ViewPrepareGeometry();
+                }
+                catch( ... )
+                {
+                    std::lock_guard<std::mutex> lock( errorLock );
+
+                    if( !error )
+                        error = std::current_exception();
+                }
+            }
+        } ) );
+    }
+
+    for( auto& worker : workers )
+        worker.join();
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
+void VIEW::rebuildIndex()
+{
+    std::vector<std::vector<VIEW_ITEM*>> layerItems( VIEW_MAX_LAYERS );
+
+    for( VIEW_ITEM* item : m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( !viewData )
+            continue;
+
+        for( int layer : viewData->m_layers )
+            layerItems[layer].push_back( item );
+    }
+
+    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+        i->second.items->BulkLoad( layerItems[i->first] );
+}
+
+
 void VIEW::RecacheAllItems()
 {
     BOX2I r;
 
     r.SetMaximum();
 
+    // Generate the expensive geometry in parallel, only drawing to the GAL is serialized
+    std::vector<VIEW_ITEM*> toPrepare;
+
+    for( VIEW_ITEM* item : m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( !viewData )
+            continue;
+
+        for( int layer : viewData->m_layers )
+        {
+            if( IsCached( layer ) )
+            {
+                toPrepare.push_back( item );
+                break;
+            }
+        }
+    }
+
+    prepareItems( toPrepare );
+
+    // Repack the layer trees, degraded by inserting and removing items while editing
+    rebuildIndex();
+
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
     {
         VIEW_LAYER* l = &( ( *i ).second );
@@ -1390,6 +1642,18 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
+    std::vector<VIEW_ITEM*> toPrepare;
+
+    for( VIEW_ITEM* item : m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( viewData && ( viewData->m_requiredUpdate & ( GEOMETRY | LAYERS | INITIAL_ADD ) ) )
+            toPrepare.push_back( item );
+    }
+
+    prepareItems( toPrepare );
+
     m_gal->BeginUpdate();
 
     for( VIEW_ITEM* item : m_allItems )
@@ -1404,6 +1668,25 @@ void VIEW::UpdateItems()
             invalidateItem( item, viewData->m_requiredUpdate );
             viewData->m_requiredUpdate = NONE;
         }
+
+        if( viewData->m_pendingDetails )
+        {
+            for( int layer : viewData->m_layers )
+            {
+                if( !IsCached( layer ) )
+                    continue;
+
+                for( int detail = DETAIL_SIMPLIFIED; detail < DETAIL_COUNT; ++detail )
+                {
+                    if( viewData->m_pendingDetails & ( 1 << detail ) )
+                        updateItemDetail( item, layer, (VIEW_DETAIL) detail );
+                }
+
+                MarkTargetDirty( m_layers[layer].target );
+            }
+
+            viewData->m_pendingDetails = 0;
+        }
     }
 
     m_gal->EndUpdate();
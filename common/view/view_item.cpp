@@ -34,3 +34,9 @@ VIEW_ITEM::~VIEW_ITEM()
     VIEW::OnDestroy( this );
     m_viewPrivData = nullptr;
 }
+
+
+VIEW_DETAIL VIEW_ITEM::ViewGetDetail( int aLayer, VIEW* aView ) const
+{
+    return aView->GetDetailLevel( ViewBBox(), false );
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python
+'''
+    A python script to create all the fabrication files of a board, without the GUI
+    (for instance on a continuous integration server):
+    plot files of the layers selected in the plot settings saved in the board,
+    Gerber job file (if enabled in these settings)
+    Drill files and drill map files
+
+    The files are generated in parallel (one file per thread).
+
+    usage: plot_fab_outputs.py [-h] [-o OUTPUT_DIR] [--gerber-drill]
+                               [--drill-map {none,pdf,ps,gerber,dxf,svg}]
+                               [-j JOBS] board
+
+    The return code is 0 when all the files are created, 1 otherwise.
+
+    The frame references (page layout) are plotted if they are enabled
+    in the plot settings of the board.
+'''
+
+from __future__ import print_function
+
+import argparse
+import sys
+
+import pcbnew
+
+
+MAP_FORMATS = {
+    'none': pcbnew.PLOT_FORMAT_UNDEFINED,
+    'pdf': pcbnew.PLOT_FORMAT_PDF,
+    'ps': pcbnew.PLOT_FORMAT_POST,
+    'gerber': pcbnew.PLOT_FORMAT_GERBER,
+    'dxf': pcbnew.PLOT_FORMAT_DXF,
+    'svg': pcbnew.PLOT_FORMAT_SVG,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Create the fabrication files of a board')
+    parser.add_argument('board', help='the .kicad_pcb file')
+    parser.add_argument('-o', '--output-dir',
+                        help='output directory (default: the one of the board plot settings)')
+    parser.add_argument('--gerber-drill', action='store_true',
+                        help='create Gerber X2 drill files instead of Excellon files')
+    parser.add_argument('--drill-map', choices=sorted(MAP_FORMATS.keys()), default='none',
+                        help='drill map file format (default: none)')
+    parser.add_argument('-j', '--jobs', type=int, default=0,
+                        help='number of threads (default: one per CPU core)')
+    args = parser.parse_args()
+
+    board = pcbnew.LoadBoard(args.board)
+
+    popt = pcbnew.PCB_PLOT_PARAMS(board.GetPlotOptions())
+
+    if args.output_dir:
+        popt.SetOutputDirectory(args.output_dir)
+
+    batch = pcbnew.PLOT_BATCH(board, popt)
+    batch.SetDrillFiles(args.gerber_drill, MAP_FORMATS[args.drill_map])
+    batch.SetThreadCount(args.jobs)
+
+    if not batch.Run():
+        print('error: some files could not be created', file=sys.stderr)
+        return 1
+
+    print('fabrication files created in %s' % popt.GetOutputDirectory())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
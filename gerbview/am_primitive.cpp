@@ -104,7 +104,7 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                             aShapeBuffer.Append( polybuffer[0].x, polybuffer[0].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
+    thread_local std::vector<wxPoint> polybuffer;   // a buffer per thread to avoid a lot of memory reallocation
     polybuffer.clear();
 
     wxPoint curPos = aShapePos;
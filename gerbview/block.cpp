@@ -209,13 +209,17 @@ void GERBVIEW_FRAME::Block_Move()
             continue;
 
         /* Move items in block */
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            GERBER_DRAW_ITEM* gerb_item = item;
+        std::vector<GERBER_DRAW_ITEM*> blockItems;
+        gerber->GetItemsInArea( GetScreen()->m_BlockLocate, blockItems );
 
+        for( GERBER_DRAW_ITEM* gerb_item : blockItems )
+        {
             if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
                 gerb_item->MoveAB( delta );
         }
+
+        // The moved items are no longer at their place in the index
+        gerber->InvalidateItemsIndex();
     }
 
     m_canvas->Refresh( true );
@@ -318,6 +318,8 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -560,8 +562,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 if( m_SlotOn )  // Oblong hole
                 {
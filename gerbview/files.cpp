@@ -26,6 +26,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <fctsys.h>
 #include <wx/fs_zip.h>
 #include <wx/wfstream.h>
@@ -237,66 +241,152 @@ bool GERBVIEW_FRAME::loadListOfGerberFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Show progress dialog after 1 second of loading
-    static const long long progressShowDelay = 1000;
+    // Give a graphic layer and an empty image to each file: the first file replaces
+    // the image of the active layer, the next ones use the next available layers
+    std::vector<GERBER_FILE_IMAGE*> gerbers;
+    std::vector<wxString> fullFilenames;
 
-    auto startTime = wxGetUTCTimeMillis();
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    // The images are added to the images list only once loaded, because the canvas
+    // can be redrawn during the loading: the layers given to the previous files of
+    // the list are not available
+    std::vector<bool> reservedLayers( ImagesMaxCount(), false );
 
-    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    auto nextFreeLayer = [&]( int aLayer ) -> int
     {
-        if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( _("Loading Gerber files..." ) );
-        }
-        else if( progress )
+        for( unsigned i = 0; i < ImagesMaxCount(); ++i )
         {
-            progress->KeepRefreshing();
+            if( GetGbrImage( aLayer ) == NULL && !reservedLayers[aLayer] )
+                return aLayer;
+
+            if( ++aLayer >= (int) ImagesMaxCount() )
+                aLayer = 0;
         }
 
+        return NO_AVAILABLE_LAYERS;
+    };
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
         filename = aFilenameList[ii];
 
         if( !filename.IsAbsolute() )
             filename.SetPath( aPath );
 
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+
+            // Report the name of not loaded files:
+            while( ii < aFilenameList.GetCount() )
+            {
+                filename = aFilenameList[ii++];
+                wxString txt;
+                txt.Printf( MSG_NOT_LOADED,
+                            GetChars( filename.GetFullName() ) );
+                reporter.Report( txt, REPORTER::RPT_ERROR );
+            }
+            break;
+        }
+
         m_lastFileName = filename.GetFullPath();
 
         SetActiveLayer( layer, false );
 
         visibility |= ( 1 << layer );
 
-        if( Read_GERBER_File( filename.GetFullPath() ) )
-        {
-            UpdateFileHistory( m_lastFileName );
+        if( GetGbrImage( layer ) != NULL )
+            Erase_Current_DrawLayer( false );
 
-            layer = getNextAvailableLayer( layer );
+        reservedLayers[layer] = true;
 
-            if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+        gerbers.push_back( new GERBER_FILE_IMAGE( layer ) );
+        fullFilenames.push_back( filename.GetFullPath() );
 
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < aFilenameList.GetCount() )
+        layer = nextFreeLayer( layer );
+    }
+
+    // Read the files: they are independent, so they are read by a pool of threads,
+    // each file in its own image
+    std::vector<char> loaded( gerbers.size(), 0 );
+    std::atomic<size_t> nextFile( 0 );
+    std::atomic<size_t> loadedCount( 0 );
+
+    {
+        // Set the locale once for all the threads: the LOCALE_IO of the loaders
+        // do not change it again
+        LOCALE_IO toggle;
+
+        size_t threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+        threadCount = std::min( threadCount, gerbers.size() );
+
+        std::vector<std::thread> loaders;
+
+        for( size_t ii = 0; ii < threadCount; ++ii )
+        {
+            loaders.push_back( std::thread( [&]()
+            {
+                for( size_t i = nextFile.fetch_add( 1 ); i < gerbers.size();
+                        i = nextFile.fetch_add( 1 ) )
                 {
-                    filename = aFilenameList[ii++];
-                    wxString txt;
-                    txt.Printf( MSG_NOT_LOADED,
-                                GetChars( filename.GetFullName() ) );
-                    reporter.Report( txt, REPORTER::RPT_ERROR );
+                    loaded[i] = gerbers[i]->LoadGerberFile( fullFilenames[i] );
+                    loadedCount++;
                 }
-                break;
+            } ) );
+        }
+
+        // Show progress dialog after 1 second of loading
+        static const long long progressShowDelay = 1000;
+
+        auto startTime = wxGetUTCTimeMillis();
+        std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+        size_t shownCount = 0;
+
+        while( loadedCount < gerbers.size() )
+        {
+            if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
+            {
+                progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                                _( "Loading Gerber files..." ), 1, false );
+                progress->SetMaxProgress( gerbers.size() );
+                progress->Report( _("Loading Gerber files..." ) );
             }
 
-            SetActiveLayer( layer, false );
+            if( progress )
+            {
+                for( size_t count = loadedCount; shownCount < count; shownCount++ )
+                    progress->AdvanceProgress();
+
+                progress->KeepRefreshing();
+            }
+
+            wxMilliSleep( 20 );
+        }
+
+        for( auto& loader : loaders )
+            loader.join();
+    }
+
+    // Add the loaded images and display the files in the list order
+    for( unsigned ii = 0; ii < gerbers.size(); ii++ )
+    {
+        if( !loaded[ii] )
+        {
+            success = false;
+
+            wxString txt;
+            txt.Printf( MSG_NOT_LOADED,
+                        GetChars( wxFileName( fullFilenames[ii] ).GetFullName() ) );
+            reporter.Report( txt, REPORTER::RPT_ERROR );
+
+            visibility &= ~( 1 << gerbers[ii]->m_GraphicLayer );
+            delete gerbers[ii];
+            continue;
         }
 
-        if( progress )
-            progress->AdvanceProgress();
+        GetImagesList()->AddGbrImage( gerbers[ii], gerbers[ii]->m_GraphicLayer );
+        UpdateFileHistory( fullFilenames[ii] );
+        showLoadedImage( gerbers[ii] );
     }
 
     if( !success )
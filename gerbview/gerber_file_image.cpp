@@ -99,6 +99,10 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
 
+    // The items are stored in m_itemBlocks
+    m_Drawings.SetOwnership( false );
+    m_itemsIndexValid = false;
+
     ResetDefaultValues();
 
     for( unsigned ii = 0; ii < DIM( m_Aperture_List ); ii++ )
@@ -108,8 +112,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
 GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 {
-    m_Drawings.DeleteAll();
-
+    // the items are deleted with m_itemBlocks
     for( unsigned ii = 0; ii < DIM( m_Aperture_List ); ii++ )
     {
         delete m_Aperture_List[ii];
@@ -128,6 +131,140 @@ GERBER_DRAW_ITEM * GERBER_FILE_IMAGE::GetItemsList()
 }
 
 
+// Number of items of the first and of the largest storage blocks of the items
+#define FIRST_ITEM_BLOCK_SIZE 256
+#define MAX_ITEM_BLOCK_SIZE 16384
+
+std::vector<GERBER_DRAW_ITEM>& GERBER_FILE_IMAGE::itemBlock()
+{
+    // A block is never reallocated (the items must not move): when it is full,
+    // the next items are stored in a new block, twice as large
+    if( m_itemBlocks.empty() || m_itemBlocks.back().size() == m_itemBlocks.back().capacity() )
+    {
+        size_t blockSize = m_itemBlocks.empty() ? FIRST_ITEM_BLOCK_SIZE
+                                                : 2 * m_itemBlocks.back().capacity();
+        blockSize = std::min( blockSize, (size_t) MAX_ITEM_BLOCK_SIZE );
+
+        m_itemBlocks.emplace_back();
+        m_itemBlocks.back().reserve( blockSize );
+    }
+
+    return m_itemBlocks.back();
+}
+
+
+GERBER_DRAW_ITEM* GERBER_FILE_IMAGE::AddNewItem()
+{
+    std::vector<GERBER_DRAW_ITEM>& block = itemBlock();
+
+    block.emplace_back( this );
+    m_Drawings.Append( &block.back() );
+    m_itemsIndexValid = false;
+
+    return &block.back();
+}
+
+
+GERBER_DRAW_ITEM* GERBER_FILE_IMAGE::AddNewItem( const GERBER_DRAW_ITEM& aItem )
+{
+    std::vector<GERBER_DRAW_ITEM>& block = itemBlock();
+
+    block.emplace_back( aItem );
+    m_Drawings.Append( &block.back() );
+    m_itemsIndexValid = false;
+
+    return &block.back();
+}
+
+
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    std::vector<ITEMS_RTREE::BulkEntry> entries;
+    entries.reserve( m_Drawings.GetCount() );
+
+    int rank = 0;
+
+    for( GERBER_DRAW_ITEM* item = m_Drawings; item; item = item->Next() )
+    {
+        const EDA_RECT bbox = item->GetBoundingBox();
+        ITEMS_RTREE::BulkEntry entry;
+
+        entry.m_min[0] = bbox.GetX();
+        entry.m_min[1] = bbox.GetY();
+        entry.m_max[0] = bbox.GetRight();
+        entry.m_max[1] = bbox.GetBottom();
+        entry.m_data.m_rank = rank++;
+        entry.m_data.m_item = item;
+
+        entries.push_back( entry );
+    }
+
+    // A packed tree: the items are not modified after loading
+    m_itemsIndex.BulkLoad( entries );
+    m_itemsIndexValid = true;
+}
+
+
+void GERBER_FILE_IMAGE::searchItemsIndex( const EDA_RECT& aArea, std::vector<RANKED_ITEM>& aList )
+{
+    if( !m_itemsIndexValid )
+        BuildItemsIndex();
+
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    auto visitor = [&]( const RANKED_ITEM& aEntry ) -> bool
+    {
+        aList.push_back( aEntry );
+        return true;
+    };
+
+    m_itemsIndex.Search( mmin, mmax, visitor );
+}
+
+
+void GERBER_FILE_IMAGE::GetItemsInArea( const EDA_RECT& aArea,
+                                        std::vector<GERBER_DRAW_ITEM*>& aList )
+{
+    std::vector<RANKED_ITEM> entries;
+    searchItemsIndex( aArea, entries );
+
+    for( const RANKED_ITEM& entry : entries )
+        aList.push_back( entry.m_item );
+}
+
+
+void GERBER_FILE_IMAGE::GetItemsAt( const wxPoint& aRefPos, std::vector<GERBER_DRAW_ITEM*>& aList )
+{
+    // GERBER_DRAW_ITEM::HitTest() accepts a small distance to very thin items,
+    // outside of their bounding box
+    const int hitMargin = Millimeter2iu( 0.01 ) + 1;
+
+    EDA_RECT area( aRefPos, wxSize( 0, 0 ) );
+    area.Inflate( hitMargin );
+
+    std::vector<RANKED_ITEM> candidates;
+    searchItemsIndex( area, candidates );
+
+    // The tree order depends on how it was packed: return the overlapping items
+    // in the list order
+    std::sort( candidates.begin(), candidates.end(),
+               []( const RANKED_ITEM& a, const RANKED_ITEM& b )
+               {
+                   return a.m_rank < b.m_rank;
+               } );
+
+    for( const RANKED_ITEM& candidate : candidates )
+    {
+        if( candidate.m_item->HitTest( aRefPos ) )
+            aList.push_back( candidate.m_item );
+    }
+}
+
+
 D_CODE* GERBER_FILE_IMAGE::GetDCODEOrCreate( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -220,7 +357,8 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
     m_IJPos.x = m_IJPos.y = 0;                      // current centre coord for
                                                     // plot arcs & circles
     m_LineNum = 0;                                  // line number in file being read
-    m_Current_File    = NULL;                       // Gerber file to read
+    m_Current_File    = NULL;                       // Drill file to read
+    m_Reader          = NULL;                       // Gerber file to read
     m_PolygonFillMode = false;
     m_PolygonFillModeState = 0;
     m_Selected_Tool = 0;
@@ -310,14 +448,13 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             // create duplicate only if ii or jj > 0
             if( jj == 0 && ii == 0 )
                 continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+            GERBER_DRAW_ITEM* dupItem = AddNewItem( aItem );
             wxPoint           move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                    GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                    GetLayerParams().m_StepForRepeatMetric );
             dupItem->MoveXY( move_vector );
-            m_Drawings.Append( dupItem );
         }
     }
 }
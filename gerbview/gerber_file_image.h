@@ -28,6 +28,7 @@
 #include <vector>
 #include <set>
 
+#include <geometry/rtree.h>
 #include <dcode.h>
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
@@ -39,6 +40,7 @@
 
 class GERBVIEW_FRAME;
 class D_CODE;
+class GERBER_FILE_READER;
 
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
@@ -104,6 +106,7 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
 
 public:
     DLIST<GERBER_DRAW_ITEM> m_Drawings;                         // linked list of Gerber Items to draw
+                                                                // (items owned by m_itemBlocks)
 
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -146,7 +149,8 @@ public:
     wxPoint            m_PreviousPos;                           // old current specified coord for plot
     wxPoint            m_IJPos;                                 // IJ coord (for arcs & circles )
 
-    FILE*              m_Current_File;                          // Current file to read
+    FILE*              m_Current_File;                          // Current file to read (drill files)
+    GERBER_FILE_READER* m_Reader;                               // Reader of the current Gerber file
 
     int                m_Selected_Tool;                         // For hightlight: current selected Dcode
     bool               m_Has_DCode;                             // true = DCodes in file
@@ -166,6 +170,19 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    std::vector< std::vector<GERBER_DRAW_ITEM> > m_itemBlocks;  // storage of the items of m_Drawings
+
+    // the payload of m_itemsIndex: an item and its rank in m_Drawings
+    // (a plain struct: the RTree stores its data in a union)
+    struct RANKED_ITEM
+    {
+        int               m_rank;
+        GERBER_DRAW_ITEM* m_item;
+    };
+
+    typedef RTree<RANKED_ITEM, int, 2, double> ITEMS_RTREE;
+    ITEMS_RTREE        m_itemsIndex;                            // spatial index of m_Drawings
+    bool               m_itemsIndexValid;                       // false if m_itemsIndex must be rebuilt
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -174,6 +191,12 @@ private:
                                                                 // -1 = negative items are
                                                                 // 0 = no negative items found
                                                                 // 1 = have negative items found
+
+    /**
+     * appends to \a aList the index entries whose bounding box intersects \a aArea
+     */
+    void searchItemsIndex( const EDA_RECT& aArea, std::vector<RANKED_ITEM>& aList );
+
     /**
      * test for an end of line
      * if a end of line is found:
@@ -182,12 +205,14 @@ private:
      * @param aText = pointer to the last useful char in aBuff
      *          on return: points the beginning of the next line.
      * @param aBuffSize = the size in bytes of aBuff
-     * @param aFile = the opened GERBER file to read
+     * @param aFile = the reader of the GERBER file
      * @return a pointer to the beginning of the next line or NULL if end of file
     */
-    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile );
+    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText,
+                       GERBER_FILE_READER* aFile );
 
-    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* aGerberFile );
+    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                        GERBER_FILE_READER* aGerberFile );
 
     /**
       * reads a single RS274X command terminated with a %
@@ -221,12 +246,17 @@ private:
      * @return bool - true if a macro was read in successfully, else false.
      */
     bool ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                            char* & text, FILE * gerber_file );
+                            char* & text, GERBER_FILE_READER* gerber_file );
 
     // functions to execute G commands or D basic commands:
     bool    Execute_G_Command( char*& text, int G_command );
     bool    Execute_DCODE_Command( char*& text, int D_command );
 
+    /**
+     * @return the storage block where the next item must be constructed
+     */
+    std::vector<GERBER_DRAW_ITEM>& itemBlock();
+
 public:
     GERBER_FILE_IMAGE( int layer );
     virtual ~GERBER_FILE_IMAGE();
@@ -264,6 +294,46 @@ public:
      */
     GERBER_DRAW_ITEM * GetItemsList();
 
+    /**
+     * Function AddNewItem
+     * creates a new GERBER_DRAW_ITEM and appends it to the items list.
+     * The items are not allocated one by one: they are stored in large blocks
+     * of contiguous items, owned by the image and deleted with it.
+     * @return the new item
+     */
+    GERBER_DRAW_ITEM* AddNewItem();
+
+    /**
+     * Function AddNewItem
+     * creates a copy of \a aItem and appends it to the items list.
+     * @return the new item
+     */
+    GERBER_DRAW_ITEM* AddNewItem( const GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Function BuildItemsIndex
+     * builds the spatial index (a R-tree of the bounding boxes) of the items, used to
+     * find the items at a location without testing all of them.
+     * It is built when the file is loaded. If the items are moved, call
+     * InvalidateItemsIndex(): the index is rebuilt by the next search.
+     */
+    void BuildItemsIndex();
+
+    void InvalidateItemsIndex() { m_itemsIndexValid = false; }
+
+    /**
+     * Function GetItemsInArea
+     * appends to \a aList the items whose bounding box intersects \a aArea
+     */
+    void GetItemsInArea( const EDA_RECT& aArea, std::vector<GERBER_DRAW_ITEM*>& aList );
+
+    /**
+     * Function GetItemsAt
+     * appends to \a aList the items hit by \a aRefPos (see GERBER_DRAW_ITEM::HitTest()),
+     * in the order of m_Drawings
+     */
+    void GetItemsAt( const wxPoint& aRefPos, std::vector<GERBER_DRAW_ITEM*>& aList );
+
     /**
      * Function GetLayerParams
      * @return the current layers params
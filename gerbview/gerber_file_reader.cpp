@@ -0,0 +1,97 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_file_reader.cpp
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include <gerber_file_reader.h>
+
+
+// Size of the blocks read from the file
+#define GERBER_READ_BLOCK_SIZE ( 256 * 1024 )
+
+
+GERBER_FILE_READER::GERBER_FILE_READER( FILE* aFile ) :
+    m_file( aFile ),
+    m_block( GERBER_READ_BLOCK_SIZE ),
+    m_blockLen( 0 ),
+    m_blockPos( 0 )
+{
+}
+
+
+GERBER_FILE_READER::~GERBER_FILE_READER()
+{
+    if( m_file )
+        fclose( m_file );
+}
+
+
+bool GERBER_FILE_READER::readBlock()
+{
+    m_blockPos = 0;
+    m_blockLen = fread( m_block.data(), 1, m_block.size(), m_file );
+
+    return m_blockLen > 0;
+}
+
+
+char* GERBER_FILE_READER::ReadLine( char* aBuff, unsigned int aBuffSize )
+{
+    if( aBuffSize < 2 )
+        return NULL;
+
+    size_t len = 0;
+
+    // Copy the chars up to the end of line (or the end of aBuff), block after block
+    while( len < aBuffSize - 1 )
+    {
+        if( m_blockPos >= m_blockLen && !readBlock() )
+            break;
+
+        const char* start = m_block.data() + m_blockPos;
+        size_t count = std::min( m_blockLen - m_blockPos, aBuffSize - 1 - len );
+        const char* eol = (const char*) memchr( start, '\n', count );
+
+        if( eol )
+            count = eol - start + 1;
+
+        memcpy( aBuff + len, start, count );
+        len += count;
+        m_blockPos += count;
+
+        if( eol )
+            break;
+    }
+
+    if( len == 0 )      // end of file
+        return NULL;
+
+    aBuff[len] = 0;
+
+    return aBuff;
+}
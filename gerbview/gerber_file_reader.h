@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_file_reader.h
+ */
+
+#ifndef GERBER_FILE_READER_H
+#define GERBER_FILE_READER_H
+
+#include <stdio.h>
+#include <vector>
+
+
+/**
+ * Class GERBER_FILE_READER
+ * reads the lines of a Gerber file from large blocks of the file, instead of
+ * one fgets() call (and one lock of the FILE) per line.
+ * Lines can have any length: a line longer than the caller's buffer is returned
+ * in several parts, as fgets() does.
+ */
+class GERBER_FILE_READER
+{
+public:
+    /**
+     * @param aFile = the opened file to read. The reader owns it and closes it.
+     */
+    GERBER_FILE_READER( FILE* aFile );
+    ~GERBER_FILE_READER();
+
+    /**
+     * Function ReadLine
+     * reads the next line of the file, like fgets()
+     * @param aBuff = the buffer to fill, the line is null terminated and keeps its '\n'
+     * @param aBuffSize = the size in bytes of aBuff
+     * @return aBuff, or NULL at the end of the file
+     */
+    char* ReadLine( char* aBuff, unsigned int aBuffSize );
+
+private:
+    /// Reads the next block of the file, and returns false at the end of the file
+    bool readBlock();
+
+    FILE*               m_file;
+    std::vector<char>   m_block;
+    size_t              m_blockLen;     ///< number of valid chars in m_block
+    size_t              m_blockPos;     ///< position of the next char to read in m_block
+};
+
+#endif  // GERBER_FILE_READER_H
@@ -218,6 +218,12 @@ private:
      */
     bool loadListOfGerberFiles( const wxString& aPath, const wxArrayString& aFilenameList );
 
+    /**
+     * Displays the messages of a Gerber file just loaded, and adds its items to the view
+     * @param aGerber is the image of the file, loaded by GERBER_FILE_IMAGE::LoadGerberFile()
+     */
+    void showLoadedImage( GERBER_FILE_IMAGE* aGerber );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -53,21 +53,15 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
 
     GERBER_DRAW_ITEM* gerb_item = nullptr;
 
+    // The items at ref, found using the spatial index of the images
+    std::vector<GERBER_DRAW_ITEM*> hitItems;
+
     // Search first on active layer
     // A not used graphic layer can be selected. So gerber can be NULL
     if( gerber && gerber->m_IsVisible )
-    {
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            if( item->HitTest( ref ) )
-            {
-                gerb_item = item;
-                break;
-            }
-        }
-    }
+        gerber->GetItemsAt( ref, hitItems );
 
-    if( gerb_item == nullptr ) // Search on all layers
+    if( hitItems.empty() ) // Search on all layers
     {
         for( layer = 0; layer < (int)ImagesMaxCount(); ++layer )
         {
@@ -82,20 +76,18 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
             if( layer == GetActiveLayer() )
                 continue;
 
-            for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-            {
-                if( item->HitTest( ref ) )
-                {
-                    gerb_item = item;
-                    break;
-                }
-            }
+            gerber->GetItemsAt( ref, hitItems );
 
-            if( gerb_item )
+            if( !hitItems.empty() )
                 break;
         }
     }
 
+    // GetItemsAt() returns the items in the order of the image: pick the first one,
+    // as the linear search of the list did
+    if( !hitItems.empty() )
+        gerb_item = hitItems.front();
+
     if( gerb_item )
     {
         MSG_PANEL_ITEMS items;
@@ -30,6 +30,7 @@
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
+#include <gerber_file_reader.h>
 #include <view/view.h>
 
 #include <html_messagebox.h>
@@ -63,18 +64,28 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         return false;
     }
 
+    showLoadedImage( gerber );
+
+    return true;
+}
+
+
+void GERBVIEW_FRAME::showLoadedImage( GERBER_FILE_IMAGE* aGerber )
+{
+    wxString msg;
+
     // Display errors list
-    if( gerber->GetMessages().size() > 0 )
+    if( aGerber->GetMessages().size() > 0 )
     {
         HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
+        dlg.ListSet(aGerber->GetMessages());
         dlg.ShowModal();
     }
 
     /* if the gerber file is only a RS274D file
      * (i.e. without any aperture information, but with items), warn the user:
      */
-    if( !gerber->m_Has_DCode && gerber->GetItemsList() )
+    if( !aGerber->m_Has_DCode && aGerber->GetItemsList() )
     {
         msg = _("Warning: this file has no D-Code definition\n"
                 "It is perhaps an old RS274D file\n"
@@ -88,28 +99,23 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     {
         auto view = canvas->GetView();
 
-        if( gerber->m_ImageNegative )
+        if( aGerber->m_ImageNegative )
         {
             // TODO: find a way to handle negative images
             // (maybe convert geometry into positives?)
         }
 
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        for( auto item = aGerber->GetItemsList(); item; item = item->Next() )
         {
             view->Add( (KIGFX::VIEW_ITEM*) item );
         }
     }
-
-    return true;
 }
 
 
-
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -121,20 +127,28 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     ResetDefaultValues();
 
     // Read the gerber file */
-    m_Current_File = wxFopen( aFullFileName, wxT( "rt" ) );
+    FILE* file = wxFopen( aFullFileName, wxT( "rt" ) );
 
-    if( m_Current_File == 0 )
+    if( file == 0 )
         return false;
 
     m_FileName = aFullFileName;
 
+    // The file is read by large blocks, and the lines are copied in a large buffer
+    // to store one line (one buffer per load: files can be loaded by several threads)
+    GERBER_FILE_READER reader( file );
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char* lineBuffer = buffer.data();
+
+    m_Reader = &reader;
+
     LOCALE_IO toggleIo;
 
     wxString msg;
 
     while( true )
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( reader.ReadLine( lineBuffer, GERBER_BUFZ ) == NULL )
             break;
 
         m_LineNum++;
@@ -214,7 +228,10 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
         }
     }
 
-    fclose( m_Current_File );
+    m_Reader = NULL;
+
+    // Build the spatial index here: the files of a list are loaded in parallel
+    BuildItemsIndex();
 
     m_InUse = true;
 
@@ -342,9 +342,10 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
                           bool aLayerNegative  )
 {
     /* in order to calculate arc parameters, we use fillArcGBRITEM
-     * so we muse create a dummy track and use its geometric parameters
+     * so we muse create a dummy track and use its geometric parameters.
+     * It is a local item: several files can be read at the same time
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -630,8 +631,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             if( !m_Exposure )   // Start a new polygon outline:
             {
                 m_Exposure = true;
-                gbritem    = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem    = AddNewItem();
                 gbritem->m_Shape = GBR_POLYGON;
                 gbritem->m_Flashed = false;
             }
@@ -701,8 +701,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             switch( m_Iterpolation )
             {
             case GERB_INTERPOL_LINEAR_1X:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 fillLineGBRITEM( gbritem, dcode, m_PreviousPos,
                                  m_CurrentPos, size, GetLayerParams().m_LayerNegative );
@@ -717,8 +716,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
 
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 fillArcGBRITEM( gbritem, dcode, m_PreviousPos,
                                 m_CurrentPos, m_IJPos, size,
@@ -751,8 +749,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 aperture = tool->m_Shape;
             }
 
-            gbritem = new GERBER_DRAW_ITEM( this );
-            m_Drawings.Append( gbritem );
+            gbritem = AddNewItem();
             fillFlashedGBRITEM( gbritem, aperture, dcode, m_CurrentPos,
                                 size, GetLayerParams().m_LayerNegative );
             StepAndRepeatItem( *gbritem );
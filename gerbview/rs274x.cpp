@@ -33,6 +33,7 @@
 
 #include <gerbview.h>
 #include <gerber_file_image.h>
+#include <gerber_file_reader.h>
 #include <X2_gerber_attributes.h>
 
 extern int ReadInt( char*& text, bool aSkipSeparator = true );
@@ -221,7 +222,7 @@ bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize,
         }
 
         // end of current line, read another one.
-        if( fgets( aBuff, aBuffSize, m_Current_File ) == NULL )
+        if( m_Reader->ReadLine( aBuff, aBuffSize ) == NULL )
         {
             // end of file
             ok = false;
@@ -355,7 +356,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
                 msg.Printf( wxT( "Unknown id (%c) in FS command" ),
                            *aText );
                 AddMessageToList( msg );
-                GetEndOfBlock( aBuff, aBuffSize, aText, m_Current_File );
+                GetEndOfBlock( aBuff, aBuffSize, aText, m_Reader );
                 ok = false;
                 break;
             }
@@ -409,7 +410,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
         m_IsX2_file = true;
     {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( m_Reader, aBuff, aBuffSize, aText, m_LineNum );
 
         if( dummy.IsFileFunction() )
         {
@@ -430,7 +431,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
     case APERTURE_ATTRIBUTE:    // Command %TA
         {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( m_Reader, aBuff, aBuffSize, aText, m_LineNum );
 
         if( dummy.GetAttribute() == ".AperFunction" )
         {
@@ -447,7 +448,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
         {
         X2_ATTRIBUTE dummy;
 
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( m_Reader, aBuff, aBuffSize, aText, m_LineNum );
 
         if( dummy.GetAttribute() == ".N" )
         {
@@ -471,7 +472,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
     case REMOVE_APERTURE_ATTRIBUTE:    // Command %TD ...
         {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, aBuff, aBuffSize, aText, m_LineNum );
+        dummy.ParseAttribCmd( m_Reader, aBuff, aBuffSize, aText, m_LineNum );
         RemoveAttribute( dummy );
         }
         break;
@@ -685,7 +686,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
     case AP_MACRO:  // lines like %AMMYMACRO*
                     // 5,1,8,0,0,1.08239X$1,22.5*
                     // %
-        /*ok = */ReadApertureMacro( aBuff, aBuffSize, aText, m_Current_File );
+        /*ok = */ReadApertureMacro( aBuff, aBuffSize, aText, m_Reader );
         break;
 
     case AP_DEFINITION:
@@ -893,13 +894,14 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 
     (void) seq_len;     // quiet g++, or delete the unused variable.
 
-    ok = GetEndOfBlock( aBuff, aBuffSize, aText, m_Current_File );
+    ok = GetEndOfBlock( aBuff, aBuffSize, aText, m_Reader );
 
     return ok;
 }
 
 
-bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* gerber_file )
+bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                                       GERBER_FILE_READER* gerber_file )
 {
     for( ; ; )
     {
@@ -914,7 +916,7 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
             aText++;
         }
 
-        if( fgets( aBuff, aBuffSize, gerber_file ) == NULL )
+        if( gerber_file->ReadLine( aBuff, aBuffSize ) == NULL )
             break;
 
         m_LineNum++;
@@ -925,7 +927,8 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
 }
 
 
-char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile )
+char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText,
+                                      GERBER_FILE_READER* aFile )
 {
     for( ; ; )
     {
@@ -938,7 +941,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
                 break;
 
             case 0:    // End of text found in aBuff: Read a new string
-                if( fgets( aBuff, aBuffSize, aFile ) == NULL )
+                if( aFile->ReadLine( aBuff, aBuffSize ) == NULL )
                     return NULL;
 
                 m_LineNum++;
@@ -955,7 +958,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
 
 bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
                                 char*&    aText,
-                                FILE*     gerber_file )
+                                GERBER_FILE_READER* gerber_file )
 {
     wxString       msg;
     APERTURE_MACRO am;
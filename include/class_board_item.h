@@ -31,6 +31,8 @@
 #define BOARD_ITEM_STRUCT_H
 
 
+#include <atomic>
+
 #include <base_struct.h>
 #include <gr_basic.h>
 #include <layers_id_colors_and_visibility.h>
@@ -38,6 +40,7 @@
 
 class BOARD;
 class BOARD_ITEM_CONTAINER;
+class MEMORY_POOL;
 class EDA_DRAW_PANEL;
 class SHAPE_POLY_SET;
 
@@ -71,6 +74,8 @@ class BOARD_ITEM : public EDA_ITEM
 protected:
     PCB_LAYER_ID    m_Layer;
 
+    static std::atomic<unsigned> s_geometryRevision;
+
     static int getTrailingInt( const wxString& aStr );
     static int getNextNumberInSequence( const std::set<int>& aSeq, bool aFillSequenceGaps );
 
@@ -113,6 +118,28 @@ public:
      */
     static wxPoint ZeroOffset;
 
+    /**
+     * Function GeometryChanged
+     * is called by the items when their position, size or net changes, so the
+     * indexes of the boards (see BOARD_ITEMS_INDEX) are rebuilt before their next use.
+     */
+    static void GeometryChanged() { s_geometryRevision++; }
+
+    static unsigned GetGeometryRevision() { return s_geometryRevision; }
+
+#if defined( KICAD_BOARD_ITEM_POOL ) && !defined( SWIG )
+    /**
+     * The board items are allocated from a MEMORY_POOL shared by all the boards:
+     * a board holds many items of a few sizes, created and deleted together (file
+     * loading, undo/redo copies...).
+     */
+    void* operator new( size_t aSize );
+    void operator delete( void* aItem, size_t aSize );
+
+    /// @return the pool of the board items, for statistics
+    static const MEMORY_POOL& GetMemoryPool();
+#endif
+
     BOARD_ITEM* Next() const { return static_cast<BOARD_ITEM*>( Pnext ); }
     BOARD_ITEM* Back() const { return static_cast<BOARD_ITEM*>( Pback ); }
     BOARD_ITEM_CONTAINER* GetParent() const { return (BOARD_ITEM_CONTAINER*) m_Parent; }
@@ -43,6 +43,7 @@ protected:
     EDA_ITEM*     first;          ///< first element in list, or NULL if list empty
     EDA_ITEM*     last;           ///< last elment in list, or NULL if empty
     unsigned      count;          ///< how many elements are in the list, automatically maintained.
+    unsigned      revision;       ///< incremented each time the list is modified
     bool          meOwner;        ///< I must delete the objects I hold in my destructor
 
     /**
@@ -54,6 +55,7 @@ protected:
         first(0),
         last(0),
         count(0),
+        revision(0),
         meOwner(true)
     {
     }
@@ -125,6 +127,13 @@ public:
      */
     unsigned GetCount() const { return count; }
 
+    /**
+     * Function GetRevision
+     * returns a number which changes each time an element is added to, inserted in
+     * or removed from the list, to know if data built from the list is up to date.
+     */
+    unsigned GetRevision() const { return revision; }
+
 #if defined(DEBUG)
     void VerifyListIntegrity();
 #endif
@@ -115,6 +115,21 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) {};
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) {};
 
+    /**
+     * @brief Draw a line of stroke font glyphs.
+     *
+     * Glyph points are scaled by aGlyphSize, slanted by aTilt (x -= aTilt * y) and moved along
+     * the X axis by the glyph offset. Drawing all glyphs at once lets the GAL batch them.
+     *
+     * @param aGlyphs are the glyphs to be drawn.
+     * @param aOffsets are the X positions of the glyphs.
+     * @param aGlyphSize is the glyph size (the width is negative for mirrored text).
+     * @param aTilt is the italic slant factor, 0.0 for upright text.
+     */
+    virtual void DrawGlyphs( const std::vector<const GLYPH*>& aGlyphs,
+                             const std::vector<double>& aOffsets,
+                             const VECTOR2D& aGlyphSize, double aTilt );
+
     /**
      * @brief Draw a circle using world coordinates.
      *
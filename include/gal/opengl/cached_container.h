@@ -82,17 +82,71 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     virtual void Unmap() override = 0;
 
+    /**
+     * Moves a limited amount of stored data to fill the free space holes in the container.
+     * Called once per update, so the cost of compaction is spread over many frames instead
+     * of stopping the world with defragmentResize(). The container has to be mapped and no
+     * item may be edited at the moment.
+     *
+     * @param aMaxVertices is the maximal number of vertices to be moved during the call.
+     * @return true if there is still compaction work left.
+     */
+    bool Compact( unsigned int aMaxVertices );
+
+    /**
+     * Returns the fragmentation factor of the free space, i.e. 0.0 when all the free space
+     * forms a single chunk and approaching 1.0 when it is scattered in many small holes.
+     */
+    double GetFragmentation() const;
+
+    /**
+     * Returns the number of separate free space chunks.
+     */
+    unsigned int GetFreeChunkCount() const
+    {
+        return m_freeOffsets.size();
+    }
+
+    /**
+     * Returns the number of vertices moved by Compact() since the container creation.
+     */
+    unsigned int GetCompactedVertices() const
+    {
+        return m_compactedVertices;
+    }
+
+    /**
+     * Returns the size of the chunk reserved for an item storing the given number of vertices.
+     * Chunk sizes are rounded up to a size class, so freed chunks are likely to be reused by
+     * other items and an item may grow a bit without moving its data.
+     *
+     * @param aSize is the number of vertices.
+     */
+    static unsigned int GetSizeClass( unsigned int aSize );
+
 protected:
     ///> Maps size of free memory chunks to their offsets
     typedef std::pair<unsigned int, unsigned int> CHUNK;
     typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
 
+    ///> Maps offsets of free memory chunks to their sizes
+    typedef std::map<unsigned int, unsigned int> FREE_OFFSET_MAP;
+
+    ///> Maps offsets of used memory chunks to the items that own them
+    typedef std::map<unsigned int, VERTEX_ITEM*> USED_CHUNK_MAP;
+
     /// List of all the stored items
     typedef std::set<VERTEX_ITEM*> ITEMS;
 
     ///> Stores size & offset of free chunks.
     FREE_CHUNK_MAP  m_freeChunks;
 
+    ///> Stores offset & size of free chunks, used to merge neighbouring chunks.
+    FREE_OFFSET_MAP m_freeOffsets;
+
+    ///> Stores chunks occupied by items, sorted by offset.
+    USED_CHUNK_MAP  m_usedChunks;
+
     ///> Stored VERTEX_ITEMs
     ITEMS m_items;
 
@@ -106,6 +160,9 @@ protected:
     ///> Maximal vertex index number stored in the container
     unsigned int m_maxIndex;
 
+    ///> Number of vertices moved by the incremental compaction
+    unsigned int m_compactedVertices;
+
     /**
      * Resizes the chunk that stores the current item to the given size. The current item has
      * its offset adjusted after the call, and the new chunk parameters are stored
@@ -133,10 +190,33 @@ protected:
     void defragment( VERTEX* aTarget );
 
     /**
-     * Looks for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
+     * Updates offsets of items after they have been packed one after another, in the order
+     * of their previous offsets, followed by the currently modified item.
+     * @return Offset of the currently modified item (or the end of the packed data).
+     */
+    unsigned int packChunks();
+
+    /**
+     * Moves the chunk of an item to another place in the container.
+     * @param aItem is the item to be moved.
+     * @param aNewOffset is the destination offset, it has to be a free chunk.
+     */
+    void moveChunk( VERTEX_ITEM* aItem, unsigned int aNewOffset );
+
+    /**
+     * Removes all free chunks and sets a single free chunk.
+     */
+    void resetFreeChunks( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Removes a free chunk entry, without changing the free space counter.
+     */
+    void removeFreeChunk( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Recomputes the maximal vertex index stored in the container.
      */
-    void mergeFreeChunks();
+    void updateMaxIndex();
 
     /**
      * Returns the size of a chunk.
@@ -159,7 +239,7 @@ protected:
     }
 
     /**
-     * Adds a chunk marked as a free space.
+     * Adds a chunk marked as a free space. It is merged with the neighbouring free chunks.
      */
     void addFreeChunk( unsigned int aOffset, unsigned int aSize );
 
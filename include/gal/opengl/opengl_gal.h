@@ -41,6 +41,8 @@
 #include <gal/hidpi_gl_canvas.h>
 
 #include <unordered_map>
+#include <map>
+#include <tuple>
 #include <boost/smart_ptr/shared_array.hpp>
 #include <memory>
 
@@ -157,6 +159,11 @@ public:
     virtual void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
                              double aRotationAngle ) override;
 
+    /// @copydoc GAL::DrawGlyphs()
+    virtual void DrawGlyphs( const std::vector<const GLYPH*>& aGlyphs,
+                             const std::vector<double>& aOffsets,
+                             const VECTOR2D& aGlyphSize, double aTilt ) override;
+
     /// @copydoc GAL::DrawGrid()
     virtual void DrawGrid() override;
 
@@ -338,6 +345,38 @@ private:
     /// Storage for intersecting points
     std::deque< boost::shared_array<GLdouble> > tessIntersects;
 
+    // Stroke font glyph cache
+    /// Vertex of a tessellated glyph, in the glyph coordinates
+    struct GLYPH_VERTEX
+    {
+        double x, y;
+        float shader[4];        ///< Shader parameters, line vectors are not transformed yet
+    };
+
+    /// Identifies a glyph tessellated with given size, slant and line width
+    struct GLYPH_CACHE_KEY
+    {
+        const GLYPH*    glyph;
+        double          sizeX, sizeY, tilt, lineWidth;
+
+        bool operator<( const GLYPH_CACHE_KEY& aOther ) const
+        {
+            return std::tie( glyph, sizeX, sizeY, tilt, lineWidth )
+                   < std::tie( aOther.glyph, aOther.sizeX, aOther.sizeY, aOther.tilt,
+                               aOther.lineWidth );
+        }
+    };
+
+    typedef std::map< GLYPH_CACHE_KEY, std::vector<GLYPH_VERTEX> > GLYPH_CACHE;
+    GLYPH_CACHE             glyphCache;             ///< Pre-tessellated stroke font glyphs
+    static const unsigned int GLYPH_CACHE_SIZE = 8192;  ///< Max number of cached glyphs
+
+    /**
+     * @brief Returns vertices of a glyph, tessellated as drawPolyline() would do.
+     * The result is cached, so each glyph is tessellated once for a given size and line width.
+     */
+    const std::vector<GLYPH_VERTEX>& getTessellatedGlyph( const GLYPH_CACHE_KEY& aKey );
+
     /**
      * @brief Draw a quad for the line.
      *
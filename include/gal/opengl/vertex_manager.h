@@ -58,6 +58,14 @@ public:
      */
     VERTEX_MANAGER( bool aCached );
 
+    /**
+     * @brief Constructor.
+     *
+     * @param aContainer is the container storing the vertices, the manager takes its
+     * ownership. It allows to use a container which does not need an OpenGL context.
+     */
+    VERTEX_MANAGER( VERTEX_CONTAINER* aContainer );
+
     /**
      * Function Map()
      * maps vertex buffer.
@@ -66,7 +74,8 @@ public:
 
     /**
      * Function Unmap()
-     * unmaps vertex buffer.
+     * unmaps vertex buffer. For cached containers, a part of the pending compaction work
+     * is done before the buffer is unmapped.
      */
     void Unmap();
 
@@ -370,6 +379,15 @@ protected:
 
     /// Currently available reserved space
     unsigned int            m_reservedSpace;
+
+    /// True if the cached container is being compacted in consecutive updates
+    bool                    m_compacting;
+
+    /// Fragmentation level of the cached container that starts the compaction
+    static constexpr double COMPACTION_THRESHOLD = 0.5;
+
+    /// Maximal number of vertices moved by the compaction during a single update
+    static constexpr unsigned int COMPACTION_BUDGET = 65536;
 };
 
 } // namespace KIGFX
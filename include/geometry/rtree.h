@@ -32,6 +32,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <type_traits>
+#include <vector>
 
 #define ASSERT assert    // RTree uses ASSERT( condition )
 
@@ -61,7 +63,7 @@ class RTFileStream;    // File I/O helper class, look below for implementation a
 ///
 /// This modified, templated C++ version by Greg Douglas at Auran (http://www.auran.com)
 ///
-/// DATATYPE Referenced data, should be int, void*, obj* etc. no larger than sizeof<void*> and simple type
+/// DATATYPE Referenced data, should be int, void*, obj* etc. or a simple struct of them
 /// ELEMTYPE Type of element such as int or float
 /// NUMDIMS Number of dimensions such as 2 or 3
 /// ELEMTYPEREAL Type of element that allows fractional and large values such as float or double, for use in volume calcs
@@ -163,6 +165,21 @@ public:
     /// Remove all entries from tree
     void    RemoveAll();
 
+    /// Bounding rectangle and data of an entry, used to build the tree with BulkLoad()
+    struct BulkEntry
+    {
+        ELEMTYPE    m_min[NUMDIMS];                 ///< Min dimensions of bounding box
+        ELEMTYPE    m_max[NUMDIMS];                 ///< Max dimensions of bounding box
+        DATATYPE    m_data;                         ///< Data Id or Ptr
+    };
+
+    /// Replace the tree contents with a_entries using the Sort-Tile-Recursive algorithm.
+    /// The nodes are fully packed and stored in a single memory block in breadth-first order,
+    /// so children of a node are next to each other. The tree may be modified afterwards
+    /// with Insert() and Remove() as usual.
+    /// \param a_entries Entries to be stored in the tree
+    void    BulkLoad( const std::vector<BulkEntry>& a_entries );
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
@@ -509,6 +526,8 @@ protected:
 
     void    RemoveAllRec( Node* a_node );
     void    Reset();
+    void    StrTile( Branch* a_begin, Branch* a_end, int a_axis );
+    bool    IsPacked( const Node* a_node ) const;
     void    CountRec( Node* a_node, int& a_count );
 
     bool    SaveRec( Node* a_node, RTFileStream& a_stream );
@@ -516,6 +535,7 @@ protected:
 
     Node*           m_root;                         ///< Root of tree
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
+    std::vector<Node> m_packedNodes;                ///< Nodes created by BulkLoad()
 };
 
 
@@ -606,9 +626,9 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
     ASSERT( MINNODES > 0 );
 
 
-    // We only support machine word size simple data type eg. integer index or object pointer.
+    // We only support simple data types eg. integer index, object pointer or a struct of them.
     // Since we are storing as union with non data branch
-    ASSERT( sizeof(DATATYPE) == sizeof(void*) || sizeof(DATATYPE) == sizeof(int) );
+    static_assert( std::is_trivial<DATATYPE>::value, "RTree data must be a simple type" );
 
     // Precomputed volumes of the unit spheres for the first few dimensions
     const float UNIT_SPHERE_VOLUMES[] =
@@ -1003,6 +1023,119 @@ void RTREE_QUAL::Reset()
     // Just reset memory pools.  We are not using complex types
     // EXAMPLE
 #endif    // RTREE_DONT_USE_MEMPOOLS
+
+    m_packedNodes.clear();
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<BulkEntry>& a_entries )
+{
+    Reset();
+
+    if( a_entries.empty() )
+    {
+        m_root = AllocNode();
+        m_root->m_level = 0;
+        return;
+    }
+
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( size_t i = 0; i < a_entries.size(); ++i )
+    {
+        for( int axis = 0; axis < NUMDIMS; ++axis )
+        {
+            branches[i].m_rect.m_min[axis]  = a_entries[i].m_min[axis];
+            branches[i].m_rect.m_max[axis]  = a_entries[i].m_max[axis];
+        }
+
+        branches[i].m_data = a_entries[i].m_data;
+    }
+
+    // Build the tree bottom-up, every level is tiled separately
+    std::vector< std::vector<Node> > levels;
+    size_t nodeCount = 0;
+
+    do
+    {
+        StrTile( branches.data(), branches.data() + branches.size(), 0 );
+
+        levels.emplace_back( ( branches.size() + MAXNODES - 1 ) / MAXNODES );
+        std::vector<Node>& nodes = levels.back();
+        std::vector<Branch> parents( nodes.size() );
+
+        for( size_t i = 0; i < nodes.size(); ++i )
+        {
+            Node*   node    = &nodes[i];
+            size_t  first   = i * MAXNODES;
+
+            InitNode( node );
+            node->m_level = levels.size() - 1;
+            node->m_count = std::min<size_t>( MAXNODES, branches.size() - first );
+            std::copy( &branches[first], &branches[first] + node->m_count, node->m_branch );
+
+            parents[i].m_rect   = NodeCover( node );
+            parents[i].m_child  = node;
+        }
+
+        nodeCount += nodes.size();
+        branches.swap( parents );
+    } while( branches.size() > 1 );
+
+    // Store the nodes in breadth-first order, so a query walks through memory mostly forward
+    m_packedNodes.resize( nodeCount );
+    m_packedNodes[0] = levels.back()[0];
+    size_t next = 1;
+
+    for( size_t i = 0; i < next; ++i )
+    {
+        Node& node = m_packedNodes[i];
+
+        if( !node.IsInternalNode() )
+            continue;
+
+        for( int index = 0; index < node.m_count; ++index )
+        {
+            m_packedNodes[next] = *node.m_branch[index].m_child;
+            node.m_branch[index].m_child = &m_packedNodes[next++];
+        }
+    }
+
+    m_root = &m_packedNodes[0];
+}
+
+
+// Sort the branches so every group of MAXNODES consecutive branches forms a tile
+// of neighbouring rectangles (Sort-Tile-Recursive).
+RTREE_TEMPLATE
+void RTREE_QUAL::StrTile( Branch* a_begin, Branch* a_end, int a_axis )
+{
+    std::sort( a_begin, a_end, [a_axis]( const Branch& a_a, const Branch& a_b )
+    {
+        return (ELEMTYPEREAL) a_a.m_rect.m_min[a_axis] + (ELEMTYPEREAL) a_a.m_rect.m_max[a_axis]
+             < (ELEMTYPEREAL) a_b.m_rect.m_min[a_axis] + (ELEMTYPEREAL) a_b.m_rect.m_max[a_axis];
+    } );
+
+    if( a_axis == NUMDIMS - 1 )
+        return;
+
+    // Split into slabs along the current axis, each slab is tiled along the remaining axes
+    size_t  count       = a_end - a_begin;
+    size_t  nodes       = ( count + MAXNODES - 1 ) / MAXNODES;
+    size_t  slabs       = (size_t) ceil( pow( (double) nodes, 1.0 / ( NUMDIMS - a_axis ) ) );
+    size_t  slabSize    = MAXNODES * ( ( nodes + slabs - 1 ) / slabs );
+
+    for( size_t first = 0; first < count; first += slabSize )
+        StrTile( a_begin + first, a_begin + std::min( first + slabSize, count ), a_axis + 1 );
+}
+
+
+RTREE_TEMPLATE
+bool RTREE_QUAL::IsPacked( const Node* a_node ) const
+{
+    return !m_packedNodes.empty()
+           && a_node >= &m_packedNodes.front() && a_node <= &m_packedNodes.back();
 }
 
 
@@ -1045,7 +1178,9 @@ void RTREE_QUAL::FreeNode( Node* a_node )
     ASSERT( a_node );
 
 #ifdef RTREE_DONT_USE_MEMPOOLS
-    delete a_node;
+    // Nodes created by BulkLoad() are released all together in Reset()
+    if( !IsPacked( a_node ) )
+        delete a_node;
 #else       // RTREE_DONT_USE_MEMPOOLS
     // EXAMPLE
 #endif      // RTREE_DONT_USE_MEMPOOLS
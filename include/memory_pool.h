@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_pool.h
+ */
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * Class MEMORY_POOL
+ * allocates small blocks of memory from large chunks, with one free list per size
+ * class (multiple of BLOCK_ALIGNMENT bytes), to create and delete many objects of a
+ * few sizes without the overhead of the heap allocator for each of them.
+ *
+ * The blocks larger than the largest size class are allocated by ::operator new.
+ * The chunks are released only by the pool destructor: a freed block is reused by the
+ * next allocation of the same size class.
+ *
+ * Each size class is protected by a mutex, so a pool can be used by several threads.
+ */
+class MEMORY_POOL
+{
+public:
+    /// Alignment and granularity of the block sizes
+    static const size_t BLOCK_ALIGNMENT = 16;
+
+    /**
+     * @param aMaxBlockSize is the size of the largest blocks allocated from the chunks
+     * @param aChunkSize is the size of the chunks allocated when a size class has
+     * no free block
+     */
+    MEMORY_POOL( size_t aMaxBlockSize = 2048, size_t aChunkSize = 64 * 1024 );
+    ~MEMORY_POOL();
+
+    /**
+     * Function Allocate
+     * @return a block of at least \a aSize bytes, aligned on BLOCK_ALIGNMENT bytes.
+     * Throws std::bad_alloc if the memory is exhausted, as operator new does.
+     */
+    void* Allocate( size_t aSize );
+
+    /**
+     * Function Free
+     * releases a block returned by Allocate().
+     * @param aSize must be the size given to Allocate()
+     */
+    void Free( void* aBlock, size_t aSize );
+
+    /// @return the memory allocated for the chunks, in bytes
+    size_t GetReservedSize() const;
+
+    /// @return the memory of the blocks currently allocated from the chunks, in bytes
+    size_t GetUsedSize() const;
+
+private:
+    // A free block stores the pointer to the next free block
+    struct FREE_BLOCK
+    {
+        FREE_BLOCK* m_next;
+    };
+
+    struct SIZE_CLASS
+    {
+        SIZE_CLASS() : m_freeList( nullptr ), m_used( 0 ) {}
+
+        mutable std::mutex  m_mutex;
+        FREE_BLOCK*         m_freeList;
+        std::vector<char*>  m_chunks;
+        size_t              m_used;         ///< number of allocated blocks
+    };
+
+    void addChunk( SIZE_CLASS& aClass, size_t aBlockSize );
+
+    size_t                  m_maxBlockSize;
+    size_t                  m_chunkSize;
+    std::vector<SIZE_CLASS> m_classes;
+
+    // no copy
+    MEMORY_POOL( const MEMORY_POOL& ) = delete;
+    MEMORY_POOL& operator=( const MEMORY_POOL& ) = delete;
+};
+
+#endif  // MEMORY_POOL_H
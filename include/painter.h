@@ -31,6 +31,7 @@
 #include <set>
 
 #include <gal/color4d.h>
+#include <view/view_item.h>
 #include <worksheet_shape_builder.h>
 #include <layers_id_colors_and_visibility.h>
 #include <memory>
@@ -336,11 +337,25 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function SetDetailLevel
+     * Sets the level of detail used by the following Draw() calls. Painters that do not
+     * provide reduced representations may ignore it.
+     * @param aDetail is the level of detail.
+     */
+    void SetDetailLevel( VIEW_DETAIL aDetail )
+    {
+        m_detail = aDetail;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
     GAL* m_gal;
 
+    /// Level of detail used for drawing items
+    VIEW_DETAIL m_detail;
+
     /// Color of brightened item frame
     COLOR4D m_brightenedColor;
 };
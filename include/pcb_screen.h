@@ -33,10 +33,16 @@
 #include <base_screen.h>
 #include <class_board_item.h>
 
+#include <unordered_map>
+
 
 class UNDO_REDO_CONTAINER;
 
 
+/// Default limit of the memory used by the undo and redo lists of a board, in bytes
+#define DEFAULT_MAX_UNDO_MEMORY ( 512 * 1024 * 1024 )
+
+
 /* Handle info to display a board */
 class PCB_SCREEN : public BASE_SCREEN
 {
@@ -84,8 +90,36 @@ public:
     /* full undo redo management : */
 
     // use BASE_SCREEN::ClearUndoRedoList()
-    // use BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aItem )
-    // use BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aItem )
+
+    /**
+     * Function PushCommandToUndoList
+     * adds a command to the undo list, as BASE_SCREEN::PushCommandToUndoList(), then
+     * removes the oldest commands while the undo and redo lists use more memory than
+     * GetMaxUndoMemory(). The last command is always kept.
+     */
+    void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem ) override;
+
+    // The memory of the commands is estimated when they are pushed, and the
+    // totals of the lists are updated when they are popped or cleared
+    void PushCommandToRedoList( PICKED_ITEMS_LIST* aItem ) override;
+    PICKED_ITEMS_LIST* PopCommandFromUndoList() override;
+    PICKED_ITEMS_LIST* PopCommandFromRedoList() override;
+
+    /**
+     * Function GetUndoRedoMemory
+     * @return an estimate of the memory used by the items copied or deleted in the
+     * undo and redo lists, in bytes
+     */
+    size_t GetUndoRedoMemory() const { return m_undoMemory + m_redoMemory; }
+
+    size_t GetMaxUndoMemory() const { return m_undoMemoryMax; }
+
+    /**
+     * Function SetMaxUndoMemory
+     * @param aMax is the limit of the memory used by the undo and redo lists, in bytes,
+     * or 0 for no limit
+     */
+    void SetMaxUndoMemory( size_t aMax ) { m_undoMemoryMax = aMax; }
 
     /**
      * Function ClearUndoORRedoList
@@ -100,6 +134,18 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) override;
+
+private:
+    /// Removes \a aCommand from m_commandMemory
+    /// @return the memory of the command when it was pushed
+    size_t forgetCommand( const PICKED_ITEMS_LIST* aCommand );
+
+    size_t      m_undoMemoryMax;    ///< memory limit of the undo and redo lists, 0 = no limit
+    size_t      m_undoMemory;       ///< estimated memory of the undo list
+    size_t      m_redoMemory;       ///< estimated memory of the redo list
+
+    /// Estimated memory of the commands of the undo and redo lists
+    std::unordered_map<const PICKED_ITEMS_LIST*, size_t> m_commandMemory;
 };
 
 #endif  // PCB_SCREEN_H
@@ -33,10 +33,12 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <draw_graphic_text.h>
 #include <page_info.h>
 #include <eda_text.h>       // FILL_T
+#include <richio.h>
 
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
@@ -455,6 +457,12 @@ public:
 
 
 protected:
+    /**
+     * Give a large stdio buffer to the output file: the plotters write many
+     * small items, the file is written in big chunks.
+     */
+    void setOutputBuffer();
+
     // These are marker subcomponents
     /**
      * Plot a circle centered on the position. Building block for markers
@@ -552,6 +560,8 @@ protected:      // variables used in most of plotters:
 
     /// Output file
     FILE*         outputFile;
+    /// stdio buffer of outputFile (see setOutputBuffer())
+    std::vector<char> m_outputBuffer;
 
     // Pen handling
     bool          colorMode;        /// true to plot in color, false to plot in black and white
@@ -734,6 +744,9 @@ protected:
                                       std::vector<int> *pos_pairs );
     void fputsPostscriptString(FILE *fout, const wxString& txt);
 
+    /// Return a string escaped for postscript/PDF, including the parenthesis
+    static std::string postscriptString( const wxString& txt );
+
     /// Virtual primitive for emitting the setrgbcolor operator
     virtual void emitSetRGBColor( double r, double g, double b ) = 0;
 
@@ -809,6 +822,8 @@ protected:
     virtual void emitSetRGBColor( double r, double g, double b ) override;
 };
 
+class PDF_STREAM_FORMATTER;
+
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
@@ -816,9 +831,12 @@ public:
     {
         // Avoid non initialized variables:
         pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
-        pageTreeHandle = 0;
+        pageTreeHandle = xObjectDictHandle = 0;
+        streamStart = 0;
     }
 
+    ~PDF_PLOTTER();
+
     virtual PlotFormat GetPlotterType() const override
     {
         return PLOT_FORMAT_PDF;
@@ -886,16 +904,28 @@ protected:
     int allocPdfObject();
     int startPdfObject(int handle = -1);
     void closePdfObject();
-    int startPdfStream(int handle = -1);
+    int startPdfStream( int handle = -1, const char* aDictEntries = "" );
     void closePdfStream();
+    void writePendingImages();
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
     int streamLengthHandle;      /// Handle to the deferred stream length
-    wxString workFilename;
-    FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
+    long streamStart;            /// Offset of the current stream data in outputFile
+    PDF_STREAM_FORMATTER* workFile; /// Deflates the current stream into outputFile
     std::vector<long> xrefTable; /// The PDF xref offset table
+
+    int xObjectDictHandle;       /// XObject resource dictionary (the images)
+    std::vector<int> imageHandles; /// Handles to the image XObjects
+
+    /// Handles of the image XObjects, by image size, color mode and SHA1 of the pixels:
+    /// an image plotted several times is stored only once in the file
+    std::unordered_map<std::string, int> imageCache;
+
+    /// Dictionary entries and pixels of the images first used in the current page
+    /// stream, written once the stream is closed
+    std::vector< std::pair<int, std::string> > pendingImages;
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
@@ -1206,18 +1236,31 @@ protected:
     // The last aperture attribute generated (only one aperture attribute can be set)
     int           m_apertureAttribute;
 
-    FILE* workFile;
-    FILE* finalFile;
-    wxString m_workFilename;
+    // the body of the file, written after the aperture list by EndPlot()
+    STRING_FORMATTER m_body;
 
     /**
      * Generate the table of D codes
      */
     void writeApertureList();
 
+    // hash and equality of the apertures, on their size, type and attribute
+    struct APERTURE_HASH
+    {
+        size_t operator()( const APERTURE& aAperture ) const;
+    };
+
+    struct APERTURE_EQUAL
+    {
+        bool operator()( const APERTURE& aFirst, const APERTURE& aSecond ) const;
+    };
+
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    // index in apertures of each aperture, for the lookup of getAperture()
+    std::unordered_map<APERTURE, size_t, APERTURE_HASH, APERTURE_EQUAL> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
@@ -0,0 +1,47 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_lod.h
+ * defines the levels of detail which a 3D plugin may be asked to load a model at
+ */
+
+#ifndef PLUGIN_3D_LOD_H
+#define PLUGIN_3D_LOD_H
+
+namespace S3D
+{
+    /**
+     * levels of detail of a loaded model; they only matter to plugins which
+     * tessellate the model themselves, such as the STEP/IGES plugin
+     */
+    enum LOD
+    {
+        LOD_PREVIEW = 0,    // coarse mesh for the footprint previews
+        LOD_NORMAL,         // the mesh used by Load()
+        LOD_FINE,           // fine mesh for the raytracer
+        LOD_END
+    };
+}
+
+#endif  // PLUGIN_3D_LOD_H
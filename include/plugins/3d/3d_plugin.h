@@ -44,6 +44,7 @@
 #define PATCH 0
 
 #include "plugins/kicad_plugin.h"
+#include "plugins/3d/3d_lod.h"
 
 
 KICAD_PLUGIN_EXPORT char const* GetKicadPluginClass( void )
@@ -131,4 +132,25 @@ KICAD_PLUGIN_EXPORT bool CanRender( void );
  */
 KICAD_PLUGIN_EXPORT SCENEGRAPH* Load( char const* aFileName );
 
+/**
+ * Function IsThreadSafe
+ * this function is optional; plugins which do not implement it are
+ * never called from more than one thread at a time
+ *
+ * @return true if Load() may be called from several threads at once
+ */
+KICAD_PLUGIN_EXPORT bool IsThreadSafe( void );
+
+/**
+ * Function LoadLOD
+ * this function is optional; it reads a model at the given level of detail,
+ * plugins which do not implement it are called through Load() instead
+ *
+ * @param aFileName is the full path of the model file
+ * @param aLevel is one of the S3D::LOD levels; LOD_NORMAL gives the same
+ * result as Load()
+ * @return a SCENEGRAPH pointer to the display structure or NULL on failure
+ */
+KICAD_PLUGIN_EXPORT SCENEGRAPH* LoadLOD( char const* aFileName, int aLevel );
+
 #endif  // PLUGIN_3D_H
@@ -114,4 +114,34 @@
 
 #endif  // defined( WIN32 ) && defined( __GNUC__ )
 
+
+/*
+ * OPEN_FILE_MAPPING( var, name, mode ) creates the boost::interprocess::file_mapping
+ * var of the file \a name, given in UTF8 like the names of the streams above.
+ * The narrow names are passed as they are to the system, so they must not be converted
+ * with the current locale, which is "C" while the models are loaded.
+ */
+#if defined( WIN32 )
+    #include <boost/version.hpp>
+
+    #if BOOST_VERSION >= 107900
+        #define OPEN_FILE_MAPPING( var, name, mode ) \
+            boost::interprocess::file_mapping var( \
+                    wxString::FromUTF8Unchecked( name ).wc_str(), mode )
+    #else
+        // No wide char names in older boost::interprocess: the file name can only
+        // use the characters of the ANSI code page
+        #define OPEN_FILE_MAPPING( var, name, mode ) \
+            boost::interprocess::file_mapping var( \
+                    wxString::FromUTF8Unchecked( name ).mb_str( \
+                            wxCSConv( wxFONTENCODING_SYSTEM ) ), mode )
+    #endif
+
+#else   // defined( WIN32 )
+
+    #define OPEN_FILE_MAPPING( var, name, mode ) \
+        boost::interprocess::file_mapping var( name, mode )
+
+#endif  // defined( WIN32 )
+
 #endif  // STREAMWRAPPER_H
@@ -92,6 +92,23 @@ public:
      */
     virtual void Remove( VIEW_ITEM* aItem );
 
+    /**
+     * Function BeginBulkAdd()
+     * Postpones indexing of the added items until EndBulkAdd() is called, so the layer
+     * R-trees are built at once instead of item by item. Meant for adding a large number
+     * of items, e.g. when a board is loaded. Queries return incomplete results until
+     * EndBulkAdd() is called.
+     */
+    void BeginBulkAdd()
+    {
+        m_bulkAdd = true;
+    }
+
+    /**
+     * Function EndBulkAdd()
+     * Rebuilds the spatial index of all layers after adding items with BeginBulkAdd().
+     */
+    void EndBulkAdd();
 
     /**
      * Function Query()
@@ -681,6 +698,30 @@ public:
         m_reverseDrawOrder = aFlag;
     }
 
+    /**
+     * Function SetDetailThresholds()
+     * Enables drawing items with a reduced level of detail, when they are small on the screen.
+     * Passing zero thresholds disables the feature.
+     * @param aSimplified is the on-screen size (in pixels) below which items providing
+     * a simplified representation use it.
+     * @param aBBox is the on-screen size (in pixels) below which only the bounding box is drawn.
+     */
+    void SetDetailThresholds( double aSimplified, double aBBox )
+    {
+        m_detailThresholds[DETAIL_SIMPLIFIED] = aSimplified;
+        m_detailThresholds[DETAIL_BBOX] = aBBox;
+        m_useDetailLevels = ( aSimplified > 0.0 || aBBox > 0.0 );
+        MarkDirty();
+    }
+
+    /**
+     * Function GetDetailLevel()
+     * Returns the level of detail suitable for drawing an item at the current scale.
+     * @param aBBox is the bounding box of the item.
+     * @param aSimplifiable tells if the item has a simplified representation.
+     */
+    VIEW_DETAIL GetDetailLevel( const BOX2I& aBBox, bool aSimplifiable ) const;
+
     static const int VIEW_MAX_LAYERS = 512;      ///< maximum number of layers that may be shown
 
 
@@ -775,6 +816,23 @@ private:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /// Caches an item drawn with a reduced level of detail
+    void updateItemDetail( VIEW_ITEM* aItem, int aLayer, VIEW_DETAIL aDetail );
+
+    /// Removes cached reduced level of detail representations of an item
+    void clearItemDetails( VIEW_ITEM* aItem, int aLayer );
+
+    /**
+     * Function prepareItems()
+     * Calls VIEW_ITEM::ViewPrepareGeometry() for the items using a pool of worker threads,
+     * so the serialized part of caching (i.e. drawing the items to the GAL) does less work.
+     * @param aItems is the list of items to be prepared.
+     */
+    void prepareItems( const std::vector<VIEW_ITEM*>& aItems );
+
+    /// Rebuilds the R-trees of all layers from scratch using bulk loading
+    void rebuildIndex();
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -850,6 +908,15 @@ private:
 
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
+
+    /// Flag to draw small items with a reduced level of detail
+    bool m_useDetailLevels;
+
+    /// On-screen sizes (in pixels) below which the reduced levels of detail are used
+    double m_detailThresholds[DETAIL_COUNT];
+
+    /// Flag to postpone indexing of the added items, see BeginBulkAdd()
+    bool m_bulkAdd;
 };
 } // namespace KIGFX
 
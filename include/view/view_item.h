@@ -70,6 +70,18 @@ enum VIEW_VISIBILITY_FLAGS {
     HIDDEN      = 0x02      /// Item is temporarily hidden (e.g. being used by a tool). Overrides VISIBLE flag.
 };
 
+/**
+ * Enum VIEW_DETAIL.
+ * Defines the level of detail used to draw an item, depending on its size on the screen.
+ * Items drawn with a reduced level of detail are cached in separate groups.
+ */
+enum VIEW_DETAIL {
+    DETAIL_FULL         = 0,    /// Item is drawn with all its details
+    DETAIL_SIMPLIFIED   = 1,    /// Item is drawn with a simplified outline (e.g. text as a bar)
+    DETAIL_BBOX         = 2,    /// Only the bounding box of the item is drawn
+    DETAIL_COUNT        = 3     /// Number of the available levels
+};
+
 /**
  * Class VIEW_ITEM -
  * is an abstract base class for deriving all objects that can be added to a VIEW.
@@ -127,6 +139,16 @@ public:
      */
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const = 0;
 
+    /**
+     * Function ViewPrepareGeometry()
+     * Computes and stores in the item the data that is expensive to generate when the item
+     * is drawn (e.g. polygon triangulation), so it is ready before the item geometry is cached.
+     * The function is called from worker threads, it may modify only the item's own data
+     * and must not use the GAL.
+     */
+    virtual void ViewPrepareGeometry()
+    {}
+
     /**
      * Function ViewGetLOD()
      * Returns the level of detail (LOD) of the item.
@@ -143,6 +165,18 @@ public:
         return 0;
     }
 
+    /**
+     * Function ViewGetDetail()
+     * Returns the level of detail that is sufficient to draw the item on a given layer
+     * at the current VIEW scale. By default items that are only a few pixels large on the
+     * screen are drawn as their bounding boxes, items providing a simplified representation
+     * should override this function.
+     * @param aLayer: current drawing layer
+     * @param aView: pointer to the VIEW device we are drawing on
+     * @return the level of detail to be used.
+     */
+    virtual VIEW_DETAIL ViewGetDetail( int aLayer, VIEW* aView ) const;
+
 public:
 
     VIEW_ITEM_DATA* viewPrivData() const
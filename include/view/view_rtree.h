@@ -55,6 +55,29 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Replaces the tree contents with aItems, building a packed tree at once. It is much faster
+     * than inserting the items one by one and the resulting tree is faster to query.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<BulkEntry> entries( aItems.size() );
+
+        for( size_t i = 0; i < aItems.size(); ++i )
+        {
+            const BOX2I& bbox = aItems[i]->ViewBBox();
+
+            entries[i].m_min[0] = bbox.GetX();
+            entries[i].m_min[1] = bbox.GetY();
+            entries[i].m_max[0] = bbox.GetRight();
+            entries[i].m_max[1] = bbox.GetBottom();
+            entries[i].m_data = aItems[i];
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
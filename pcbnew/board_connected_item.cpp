@@ -64,6 +64,8 @@ bool BOARD_CONNECTED_ITEM::SetNetCode( int aNetCode, bool aNoAssert )
     if( !aNoAssert )
         assert( m_netinfo );
 
+    GeometryChanged();
+
     // Add only if it was previously added to the ratsnest
     //if( addRatsnest )
     //    connectivity->Add( this );
@@ -94,6 +94,7 @@ public:
     {
         assert( aNetInfo->GetBoard() == GetBoard() );
         m_netinfo = aNetInfo;
+        GeometryChanged();
     }
 
     /**
@@ -0,0 +1,253 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_items_index.cpp
+ */
+
+#include <algorithm>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <board_items_index.h>
+
+
+// Number of queries of the same board state before building the index:
+// building it costs a few walks of the lists
+#define INDEX_MIN_QUERY_COUNT 4
+
+
+BOARD_ITEMS_INDEX::BOARD_ITEMS_INDEX( const BOARD* aBoard ) :
+    m_board( aBoard ),
+    m_valid( false ),
+    m_geometryRevision( 0 ),
+    m_tracksRevision( 0 ),
+    m_modulesRevision( 0 ),
+    m_queryCount( 0 )
+{
+}
+
+
+bool BOARD_ITEMS_INDEX::IsUsable()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    unsigned geometryRevision = BOARD_ITEM::GetGeometryRevision();
+    unsigned tracksRevision = m_board->m_Track.GetRevision();
+    unsigned modulesRevision = m_board->m_Modules.GetRevision();
+
+    if( geometryRevision != m_geometryRevision || tracksRevision != m_tracksRevision
+            || modulesRevision != m_modulesRevision )
+    {
+        m_valid = false;
+        m_queryCount = 0;
+        m_geometryRevision = geometryRevision;
+        m_tracksRevision = tracksRevision;
+        m_modulesRevision = modulesRevision;
+    }
+
+    if( !m_valid && ++m_queryCount >= INDEX_MIN_QUERY_COUNT )
+    {
+        build();
+
+        // Building the index does not modify the items
+        m_valid = BOARD_ITEM::GetGeometryRevision() == m_geometryRevision;
+    }
+
+    return m_valid;
+}
+
+
+void BOARD_ITEMS_INDEX::build()
+{
+    m_trackRanks.clear();
+    m_moduleRanks.clear();
+    m_trackEnds.clear();
+    m_netTracks.clear();
+
+    std::vector<TRACKS_RTREE::BulkEntry> trackEntries;
+    std::vector<MODULES_RTREE::BulkEntry> moduleEntries;
+    int rank = 0;
+
+    trackEntries.reserve( m_board->m_Track.GetCount() );
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        m_trackRanks[track] = rank++;
+
+        m_trackEnds[track->GetStart()].push_back( track );
+
+        if( track->GetEnd() != track->GetStart() )
+            m_trackEnds[track->GetEnd()].push_back( track );
+
+        m_netTracks[track->GetNetCode()].push_back( track );
+
+        // HitTest() accepts a distance of m_Width / 2, inside the bounding box
+        EDA_RECT bbox = track->GetBoundingBox();
+        bbox.Normalize();
+
+        TRACKS_RTREE::BulkEntry entry;
+        entry.m_min[0] = bbox.GetX();
+        entry.m_min[1] = bbox.GetY();
+        entry.m_max[0] = bbox.GetRight();
+        entry.m_max[1] = bbox.GetBottom();
+        entry.m_data = track;
+        trackEntries.push_back( entry );
+    }
+
+    rank = 0;
+    moduleEntries.reserve( m_board->m_Modules.GetCount() );
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        m_moduleRanks[module] = rank++;
+
+        EDA_RECT bbox = module->GetBoundaryBox();
+        bbox.Normalize();
+
+        MODULES_RTREE::BulkEntry entry;
+        entry.m_min[0] = bbox.GetX();
+        entry.m_min[1] = bbox.GetY();
+        entry.m_max[0] = bbox.GetRight();
+        entry.m_max[1] = bbox.GetBottom();
+        entry.m_data = module;
+        moduleEntries.push_back( entry );
+    }
+
+    m_tracksTree.BulkLoad( trackEntries );
+    m_modulesTree.BulkLoad( moduleEntries );
+}
+
+
+int BOARD_ITEMS_INDEX::trackRank( const TRACK* aTrack ) const
+{
+    auto it = m_trackRanks.find( aTrack );
+
+    return it == m_trackRanks.end() ? -1 : it->second;
+}
+
+
+TRACK* BOARD_ITEMS_INDEX::GetTrack( const TRACK* aStartTrace, const wxPoint& aPosition,
+                                    LSET aLayerMask ) const
+{
+    int startRank = trackRank( aStartTrace );
+
+    // The lists of m_trackEnds are in the order of the track list
+    for( TRACK* track : GetTracksAt( aPosition ) )
+    {
+        if( trackRank( track ) < startRank || track->GetState( IS_DELETED | BUSY ) )
+            continue;
+
+        if( ( aLayerMask & track->GetLayerSet() ).any() )
+            return track;
+    }
+
+    return NULL;
+}
+
+
+VIA* BOARD_ITEMS_INDEX::GetVia( const TRACK* aStartTrace, const wxPoint& aPosition,
+                                LSET aLayerMask ) const
+{
+    std::vector<TRACK*> tracks;
+    int startRank = trackRank( aStartTrace );
+
+    GetTracksNear( aPosition, tracks );
+
+    for( TRACK* track : tracks )
+    {
+        if( track->Type() != PCB_VIA_T || trackRank( track ) < startRank )
+            continue;
+
+        if( track->HitTest( aPosition ) && !track->GetState( BUSY | IS_DELETED )
+                && ( aLayerMask & track->GetLayerSet() ).any() )
+            return static_cast<VIA*>( track );
+    }
+
+    return NULL;
+}
+
+
+const std::vector<TRACK*>& BOARD_ITEMS_INDEX::GetTracksAt( const wxPoint& aPosition ) const
+{
+    static const std::vector<TRACK*> empty;
+    auto it = m_trackEnds.find( aPosition );
+
+    return it == m_trackEnds.end() ? empty : it->second;
+}
+
+
+void BOARD_ITEMS_INDEX::GetTracksNear( const wxPoint& aPosition,
+                                       std::vector<TRACK*>& aTracks ) const
+{
+    const int mmin[2] = { aPosition.x, aPosition.y };
+    const int mmax[2] = { aPosition.x, aPosition.y };
+
+    auto visitor = [&]( TRACK* aTrack ) -> bool
+    {
+        aTracks.push_back( aTrack );
+        return true;
+    };
+
+    const_cast<TRACKS_RTREE&>( m_tracksTree ).Search( mmin, mmax, visitor );
+
+    std::sort( aTracks.begin(), aTracks.end(),
+               [this]( const TRACK* a, const TRACK* b )
+               {
+                   return m_trackRanks.at( a ) < m_trackRanks.at( b );
+               } );
+}
+
+
+void BOARD_ITEMS_INDEX::GetModulesAt( const wxPoint& aPosition,
+                                      std::vector<MODULE*>& aModules ) const
+{
+    const int mmin[2] = { aPosition.x, aPosition.y };
+    const int mmax[2] = { aPosition.x, aPosition.y };
+
+    auto visitor = [&]( MODULE* aModule ) -> bool
+    {
+        if( aModule->HitTest( aPosition ) )
+            aModules.push_back( aModule );
+
+        return true;
+    };
+
+    const_cast<MODULES_RTREE&>( m_modulesTree ).Search( mmin, mmax, visitor );
+
+    std::sort( aModules.begin(), aModules.end(),
+               [this]( const MODULE* a, const MODULE* b )
+               {
+                   return m_moduleRanks.at( a ) < m_moduleRanks.at( b );
+               } );
+}
+
+
+const std::vector<TRACK*>& BOARD_ITEMS_INDEX::GetNetTracks( int aNetCode ) const
+{
+    static const std::vector<TRACK*> empty;
+    auto it = m_netTracks.find( aNetCode );
+
+    return it == m_netTracks.end() ? empty : it->second;
+}
@@ -0,0 +1,141 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_items_index.h
+ */
+
+#ifndef BOARD_ITEMS_INDEX_H
+#define BOARD_ITEMS_INDEX_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+#include <geometry/rtree.h>
+#include <layers_id_colors_and_visibility.h>
+#include <track_buckets.h>
+
+class BOARD;
+class TRACK;
+class VIA;
+class MODULE;
+
+
+/**
+ * Class BOARD_ITEMS_INDEX
+ * indexes the tracks, vias and footprints of a board by position and by net, for the
+ * positional queries of BOARD used by the legacy tools (GetPad(), GetViaByPosition(),
+ * MarkTrace()...), which walked the whole track or footprint list for each query.
+ *
+ * The index is not updated item by item: it is rebuilt when it is used after a change
+ * of the track or footprint lists (see DHEAD::GetRevision()) or of an item geometry
+ * (see BOARD_ITEM::GeometryChanged()). It is built only after a few queries of the
+ * same board state, so the tools modifying the board between each query keep the
+ * linear searches instead of rebuilding the index each time.
+ *
+ * The results are given in the order of the lists, as the linear searches do.
+ * The states (BUSY...) and the layers are not indexed: the callers test them.
+ */
+class BOARD_ITEMS_INDEX
+{
+public:
+    BOARD_ITEMS_INDEX( const BOARD* aBoard );
+
+    /**
+     * Function IsUsable
+     * updates the index if needed.
+     * @return true if the queries can use the index, false if they must walk the lists
+     */
+    bool IsUsable();
+
+    /**
+     * Function GetTrack
+     * is the equivalent of ::GetTrack( aStartTrace, NULL, aPosition, aLayerMask ):
+     * @return the first track or via, from \a aStartTrace to the end of the list, having
+     * an end at \a aPosition and a layer in \a aLayerMask, which is not flagged BUSY or
+     * IS_DELETED
+     */
+    TRACK* GetTrack( const TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerMask ) const;
+
+    /**
+     * Function GetVia
+     * is the equivalent of aStartTrace->GetVia( NULL, aPosition, aLayerMask ):
+     * @return the first via, from \a aStartTrace to the end of the list, hit at
+     * \a aPosition, having a layer in \a aLayerMask, which is not flagged BUSY or IS_DELETED
+     */
+    VIA* GetVia( const TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerMask ) const;
+
+    /**
+     * @return the tracks and vias having an end at \a aPosition
+     */
+    const std::vector<TRACK*>& GetTracksAt( const wxPoint& aPosition ) const;
+
+    /**
+     * Function GetTracksNear
+     * fills \a aTracks with the tracks and vias whose bounding box contains \a aPosition
+     */
+    void GetTracksNear( const wxPoint& aPosition, std::vector<TRACK*>& aTracks ) const;
+
+    /**
+     * Function GetModulesAt
+     * fills \a aModules with the footprints hit at \a aPosition, i.e. whose bounding box
+     * (MODULE::GetBoundaryBox()) contains \a aPosition
+     */
+    void GetModulesAt( const wxPoint& aPosition, std::vector<MODULE*>& aModules ) const;
+
+    /**
+     * @return the tracks and vias of the net \a aNetCode
+     */
+    const std::vector<TRACK*>& GetNetTracks( int aNetCode ) const;
+
+private:
+    /// Rank of an item in its list
+    int trackRank( const TRACK* aTrack ) const;
+
+    void build();
+
+    typedef RTree<TRACK*, int, 2, double>   TRACKS_RTREE;
+    typedef RTree<MODULE*, int, 2, double>  MODULES_RTREE;
+
+    const BOARD*    m_board;
+    std::mutex      m_mutex;
+
+    // The state of the board when the index was built, or last queried
+    bool            m_valid;
+    unsigned        m_geometryRevision;
+    unsigned        m_tracksRevision;
+    unsigned        m_modulesRevision;
+    int             m_queryCount;           ///< queries of the current board state
+
+    std::unordered_map<const TRACK*, int>                         m_trackRanks;
+    std::unordered_map<const MODULE*, int>                        m_moduleRanks;
+    std::unordered_map<wxPoint, std::vector<TRACK*>, POSITION_HASH> m_trackEnds;
+    std::unordered_map<int, std::vector<TRACK*>>                  m_netTracks;
+    TRACKS_RTREE                                                  m_tracksTree;
+    MODULES_RTREE                                                 m_modulesTree;
+};
+
+#endif  // BOARD_ITEMS_INDEX_H
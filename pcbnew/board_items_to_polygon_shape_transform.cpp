@@ -380,12 +380,12 @@ void ZONE_CONTAINER::TransformSolidAreasShapesToPolygonSet(
         return;
 
     // add filled areas polygons
-    aCornerBuffer.Append( m_FilledPolysList );
+    aCornerBuffer.Append( *m_FilledPolysList );
 
     // add filled areas outlines, which are drawn with thick lines
-    for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
+    for( int i = 0; i < m_FilledPolysList->OutlineCount(); i++ )
     {
-        const SHAPE_LINE_CHAIN& path = m_FilledPolysList.COutline( i );
+        const SHAPE_LINE_CHAIN& path = m_FilledPolysList->COutline( i );
 
         for( int j = 0; j < path.PointCount(); j++ )
         {
@@ -1323,6 +1323,6 @@ void ZONE_CONTAINER::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCorn
                                                         int             aCircleToSegmentsCount,
                                                         double          aCorrectionFactor ) const
 {
-    aCornerBuffer = m_FilledPolysList;
+    aCornerBuffer = *m_FilledPolysList;
     aCornerBuffer.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 }
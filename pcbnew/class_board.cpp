@@ -59,6 +59,7 @@
 #include <class_pcb_target.h>
 #include <class_dimension.h>
 #include <connectivity_data.h>
+#include <board_items_index.h>
 
 
 /**
@@ -99,6 +100,7 @@ DELETED_BOARD_ITEM g_DeletedItem;
  *  in class_board_item.cpp like I first tried it.
  */
 wxPoint BOARD_ITEM::ZeroOffset( 0, 0 );
+std::atomic<unsigned> BOARD_ITEM::s_geometryRevision( 0 );
 
 // this is a dummy colors settings (defined colors are the vdefulat values)
 // used to initialize the board.
@@ -144,6 +146,8 @@ BOARD::BOARD() :
 
     // Initialize ratsnest
     m_connectivity.reset( new CONNECTIVITY_DATA() );
+
+    m_itemsIndex.reset( new BOARD_ITEMS_INDEX( this ) );
 }
 
 
@@ -219,6 +223,14 @@ TRACKS BOARD::TracksInNet( int aNetCode )
 {
     TRACKS ret;
 
+    if( m_itemsIndex->IsUsable() )
+    {
+        const std::vector<TRACK*>& tracks = m_itemsIndex->GetNetTracks( aNetCode );
+
+        ret.insert( ret.end(), tracks.begin(), tracks.end() );
+        return ret;
+    }
+
     INSPECTOR_FUNC inspector = [aNetCode,&ret] ( EDA_ITEM* item, void* testData )
     {
         TRACK*  t = (TRACK*) item;
@@ -461,7 +473,7 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
          * is found we do not know at this time the number of connected items
          * and we do not know if this via is on the track or finish the track
          */
-        TRACK* via = aTrackList->GetVia( NULL, aPosition, layer_set );
+        TRACK* via = getVia( aTrackList, aPosition, layer_set );
 
         if( via )
         {
@@ -479,7 +491,7 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
          */
         TRACK*  segment = aTrackList;
 
-        while( ( segment = ::GetTrack( segment, NULL, aPosition, layer_set ) ) != NULL )
+        while( ( segment = getTrack( segment, aPosition, layer_set ) ) != NULL )
         {
             if( segment->GetState( BUSY ) ) // already found and selected: skip it
             {
@@ -1642,8 +1654,42 @@ int BOARD::SetAreasNetCodesFromNetNames()
 }
 
 
+TRACK* BOARD::getTrack( TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerSet ) const
+{
+    if( aStartTrace && aStartTrace->GetList() == &m_Track && m_itemsIndex->IsUsable() )
+        return m_itemsIndex->GetTrack( aStartTrace, aPosition, aLayerSet );
+
+    return ::GetTrack( aStartTrace, NULL, aPosition, aLayerSet );
+}
+
+
+VIA* BOARD::getVia( TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerSet ) const
+{
+    if( !aStartTrace )
+        return NULL;
+
+    if( aStartTrace->GetList() == &m_Track && m_itemsIndex->IsUsable() )
+        return m_itemsIndex->GetVia( aStartTrace, aPosition, aLayerSet );
+
+    return aStartTrace->GetVia( NULL, aPosition, aLayerSet );
+}
+
+
 VIA* BOARD::GetViaByPosition( const wxPoint& aPosition, PCB_LAYER_ID aLayer) const
 {
+    if( m_itemsIndex->IsUsable() )
+    {
+        for( TRACK* track : m_itemsIndex->GetTracksAt( aPosition ) )
+        {
+            if( track->Type() == PCB_VIA_T && track->GetStart() == aPosition
+                    && track->GetState( BUSY | IS_DELETED ) == 0
+                    && ( aLayer == UNDEFINED_LAYER || track->IsOnLayer( aLayer ) ) )
+                return static_cast<VIA*>( track );
+        }
+
+        return NULL;
+    }
+
     for( VIA *via = GetFirstVia( m_Track); via; via = GetFirstVia( via->Next() ) )
     {
         if( (via->GetStart() == aPosition) &&
@@ -1661,6 +1707,23 @@ D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerSet )
     if( !aLayerSet.any() )
         aLayerSet = LSET::AllCuMask();
 
+    if( m_itemsIndex->IsUsable() )
+    {
+        std::vector<MODULE*> modules;
+
+        m_itemsIndex->GetModulesAt( aPosition, modules );
+
+        for( MODULE* module : modules )
+        {
+            D_PAD* pad = module->GetPad( aPosition, aLayerSet );
+
+            if( pad )
+                return pad;
+        }
+
+        return NULL;
+    }
+
     for( MODULE* module = m_Modules;  module;  module = module->Next() )
     {
         D_PAD* pad = NULL;
@@ -1690,6 +1753,18 @@ std::list<TRACK*> BOARD::GetTracksByPosition( const wxPoint& aPosition, PCB_LAYE
 {
     std::list<TRACK*> tracks;
 
+    if( m_itemsIndex->IsUsable() )
+    {
+        for( TRACK* track : m_itemsIndex->GetTracksAt( aPosition ) )
+        {
+            if( track->Type() == PCB_TRACE_T && track->GetState( BUSY | IS_DELETED ) == 0
+                    && ( aLayer == UNDEFINED_LAYER || track->IsOnLayer( aLayer ) ) )
+                tracks.push_back( track );
+        }
+
+        return tracks;
+    }
+
     for( TRACK* track = GetFirstTrack( m_Track ); track; track = GetFirstTrack( track->Next() ) )
     {
         if( ( ( track->GetStart() == aPosition ) || track->GetEnd() == aPosition ) &&
@@ -1856,30 +1931,44 @@ void BOARD::PadDelete( D_PAD* aPad )
 TRACK* BOARD::GetVisibleTrack( TRACK* aStartingTrace, const wxPoint& aPosition,
         LSET aLayerSet ) const
 {
-    for( TRACK* track = aStartingTrace; track; track = track->Next() )
+    auto isVisibleHit = [&]( TRACK* track ) -> bool
     {
         PCB_LAYER_ID layer = track->GetLayer();
 
         if( track->GetState( BUSY | IS_DELETED ) )
-            continue;
+            return false;
 
         // track's layer is not visible
         if( m_designSettings.IsLayerVisible( layer ) == false )
-            continue;
+            return false;
+
+        // a via is visible on all its layers, a track must be on a layer of aLayerSet
+        if( track->Type() != PCB_VIA_T && !aLayerSet[layer] )
+            return false;
 
-        if( track->Type() == PCB_VIA_T )    // VIA encountered.
+        return track->HitTest( aPosition );
+    };
+
+    // The index gives the tracks whose bounding box contains aPosition
+    if( aStartingTrace && aStartingTrace == m_Track.GetFirst() && m_itemsIndex->IsUsable() )
+    {
+        std::vector<TRACK*> candidates;
+
+        m_itemsIndex->GetTracksNear( aPosition, candidates );
+
+        for( TRACK* track : candidates )
         {
-            if( track->HitTest( aPosition ) )
+            if( isVisibleHit( track ) )
                 return track;
         }
-        else
-        {
-            if( !aLayerSet[layer] )
-                continue;               // track's layer is not in aLayerSet
 
-            if( track->HitTest( aPosition ) )
-                return track;
-        }
+        return NULL;
+    }
+
+    for( TRACK* track = aStartingTrace; track; track = track->Next() )
+    {
+        if( isVisibleHit( track ) )
+            return track;
     }
 
     return NULL;
@@ -1921,18 +2010,18 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
      */
     if( aTrace->Type() == PCB_VIA_T )
     {
-        TRACK* segm1 = ::GetTrack( aTrackList, NULL, aTrace->GetStart(), layer_set );
+        TRACK* segm1 = getTrack( aTrackList, aTrace->GetStart(), layer_set );
         TRACK* segm2 = NULL;
         TRACK* segm3 = NULL;
 
         if( segm1 )
         {
-            segm2 = ::GetTrack( segm1->Next(), NULL, aTrace->GetStart(), layer_set );
+            segm2 = getTrack( segm1->Next(), aTrace->GetStart(), layer_set );
         }
 
         if( segm2 )
         {
-            segm3 = ::GetTrack( segm2->Next(), NULL, aTrace->GetStart(), layer_set );
+            segm3 = getTrack( segm2->Next(), aTrace->GetStart(), layer_set );
         }
 
         if( segm3 )
@@ -1990,7 +2079,7 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
 
         layer_set = via->GetLayerSet();
 
-        TRACK* track = ::GetTrack( aTrackList, NULL, via->GetStart(), layer_set );
+        TRACK* track = getTrack( aTrackList, via->GetStart(), layer_set );
 
         // GetTrace does not consider tracks flagged BUSY.
         // So if no connected track found, this via is on the current track
@@ -2012,7 +2101,7 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
          */
         LAYER_NUM layer = track->GetLayer();
 
-        while( ( track = ::GetTrack( track->Next(), NULL, via->GetStart(), layer_set ) ) != NULL )
+        while( ( track = getTrack( track->Next(), via->GetStart(), layer_set ) ) != NULL )
         {
             if( layer != track->GetLayer() )
             {
@@ -2199,12 +2288,25 @@ MODULE* BOARD::GetFootprint( const wxPoint& aPosition, PCB_LAYER_ID aActiveLayer
     int     min_dim     = 0x7FFFFFFF;
     int     alt_min_dim = 0x7FFFFFFF;
     bool    current_layer_back = IsBackLayer( aActiveLayer );
+    std::vector<MODULE*> candidates;
 
-    for( pt_module = m_Modules;  pt_module;  pt_module = pt_module->Next() )
+    if( m_itemsIndex->IsUsable() )
     {
-        // is the ref point within the module's bounds?
-        if( !pt_module->HitTest( aPosition ) )
-            continue;
+        m_itemsIndex->GetModulesAt( aPosition, candidates );
+    }
+    else
+    {
+        for( pt_module = m_Modules;  pt_module;  pt_module = pt_module->Next() )
+        {
+            // is the ref point within the module's bounds?
+            if( pt_module->HitTest( aPosition ) )
+                candidates.push_back( pt_module );
+        }
+    }
+
+    for( MODULE* candidate : candidates )
+    {
+        pt_module = candidate;
 
         // if caller wants to ignore locked modules, and this one is locked, skip it.
         if( aIgnoreLocked && pt_module->IsLocked() )
@@ -2270,7 +2372,7 @@ BOARD_CONNECTED_ITEM* BOARD::GetLockPoint( const wxPoint& aPosition, LSET aLayer
     }
 
     // No pad has been located so check for a segment of the trace.
-    TRACK* segment = ::GetTrack( m_Track, NULL, aPosition, aLayerSet );
+    TRACK* segment = getTrack( m_Track, aPosition, aLayerSet );
 
     if( !segment )
         segment = GetVisibleTrack( m_Track, aPosition, aLayerSet );
@@ -56,6 +56,7 @@ class BOARD;
 class ZONE_CONTAINER;
 class SEGZONE;
 class TRACK;
+class VIA;
 class D_PAD;
 class MARKER_PCB;
 class MSG_PANEL_ITEM;
@@ -63,6 +64,7 @@ class NETLIST;
 class REPORTER;
 class SHAPE_POLY_SET;
 class CONNECTIVITY_DATA;
+class BOARD_ITEMS_INDEX;
 
 /**
  * Enum LAYER_T
@@ -190,6 +192,9 @@ private:
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
+    /// positional index of the tracks and footprints, for the legacy queries
+    std::shared_ptr<BOARD_ITEMS_INDEX>      m_itemsIndex;
+
     BOARD_DESIGN_SETTINGS   m_designSettings;
     ZONE_SETTINGS           m_zoneSettings;
     COLORS_DESIGN_SETTINGS* m_colorsSettings;
@@ -211,6 +216,20 @@ private:
     void chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
                               const LSET& aLayerSet, TRACKS* aList );
 
+    /**
+     * Function getTrack
+     * is ::GetTrack( aStartTrace, NULL, aPosition, aLayerSet ), using the items index
+     * when \a aStartTrace belongs to the board track list.
+     */
+    TRACK* getTrack( TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerSet ) const;
+
+    /**
+     * Function getVia
+     * is aStartTrace->GetVia( NULL, aPosition, aLayerSet ), using the items index
+     * when \a aStartTrace belongs to the board track list.
+     */
+    VIA* getVia( TRACK* aStartTrace, const wxPoint& aPosition, LSET aLayerSet ) const;
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) :
@@ -34,8 +34,43 @@
 #include <wx/debug.h>
 
 #include <class_board.h>
+#include <memory_pool.h>
 #include <string>
 
+
+#ifdef KICAD_BOARD_ITEM_POOL
+
+// The pool is never destroyed: items may be deleted by the destructors of other static
+// objects, after the end of main()
+static MEMORY_POOL& boardItemPool()
+{
+    static MEMORY_POOL* pool = new MEMORY_POOL();
+
+    return *pool;
+}
+
+
+void* BOARD_ITEM::operator new( size_t aSize )
+{
+    return boardItemPool().Allocate( aSize );
+}
+
+
+// The destructor is virtual, so aSize is the size of the actual class of the item
+void BOARD_ITEM::operator delete( void* aItem, size_t aSize )
+{
+    boardItemPool().Free( aItem, aSize );
+}
+
+
+const MEMORY_POOL& BOARD_ITEM::GetMemoryPool()
+{
+    return boardItemPool();
+}
+
+#endif
+
+
 wxString BOARD_ITEM::ShowShape( STROKE_T aShape )
 {
     switch( aShape )
@@ -839,6 +839,13 @@ const BOX2I DRAWSEGMENT::ViewBBox() const
 }
 
 
+void DRAWSEGMENT::ViewPrepareGeometry()
+{
+    if( m_Shape == S_POLYGON && m_Poly.OutlineCount() )
+        m_Poly.CacheTriangulation();
+}
+
+
 void DRAWSEGMENT::computeArcBBox( EDA_RECT& aBBox ) const
 {
     // Do not include the center, which is not necessarily
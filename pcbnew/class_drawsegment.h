@@ -265,6 +265,8 @@ public:
 
     virtual const BOX2I ViewBBox() const override;
 
+    virtual void ViewPrepareGeometry() override;
+
     virtual void SwapData( BOARD_ITEM* aImage ) override;
 
 #if defined(DEBUG)
@@ -465,6 +465,7 @@ void MODULE::CalculateBoundingBox()
 {
     m_BoundaryBox = GetFootprintRect();
     m_Surface = std::abs( (double) m_BoundaryBox.GetWidth() * m_BoundaryBox.GetHeight() );
+    GeometryChanged();
 }
 
 
@@ -1481,4 +1482,5 @@ void MODULE::SwapData( BOARD_ITEM* aImage )
     assert( aImage->Type() == PCB_MODULE_T );
 
     std::swap( *((MODULE*) this), *((MODULE*) aImage) );
+    GeometryChanged();
 }
@@ -144,6 +144,13 @@ public:
      */
     void CalculateBoundingBox();
 
+    /**
+     * Function GetBoundaryBox
+     * @return the bounding box computed by the last call to CalculateBoundingBox(),
+     * the one used by HitTest( const wxPoint& )
+     */
+    const EDA_RECT& GetBoundaryBox() const { return m_BoundaryBox; }
+
     /**
      * Function GetFootprintRect()
      * Returns the area of the module footprint excluding any text.
@@ -1297,6 +1297,13 @@ void D_PAD::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
+void D_PAD::ViewPrepareGeometry()
+{
+    if( GetShape() == PAD_SHAPE_CUSTOM && m_customShapeAsPolygon.OutlineCount() )
+        m_customShapeAsPolygon.CacheTriangulation();
+}
+
+
 unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
     const int HIDE = std::numeric_limits<unsigned int>::max();
@@ -1341,6 +1348,13 @@ unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+KIGFX::VIEW_DETAIL D_PAD::ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Small pads are drawn with simple rectangles instead of rounded or custom shapes
+    return aView->GetDetailLevel( ViewBBox(), true );
+}
+
+
 const BOX2I D_PAD::ViewBBox() const
 {
     // Bounding box includes soldermask too
@@ -734,8 +734,12 @@ public:
 
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const override;
 
+    virtual void ViewPrepareGeometry() override;
+
     virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    virtual KIGFX::VIEW_DETAIL ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const override;
+
     virtual const BOX2I ViewBBox() const override;
 
     /**
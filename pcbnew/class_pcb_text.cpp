@@ -44,6 +44,7 @@
 
 #include <class_board.h>
 #include <class_pcb_text.h>
+#include <view/view.h>
 
 
 TEXTE_PCB::TEXTE_PCB( BOARD_ITEM* parent ) :
@@ -201,3 +202,10 @@ void TEXTE_PCB::SwapData( BOARD_ITEM* aImage )
 
     std::swap( *((TEXTE_PCB*) this), *((TEXTE_PCB*) aImage) );
 }
+
+
+KIGFX::VIEW_DETAIL TEXTE_PCB::ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Illegible texts are drawn as bars instead of strokes
+    return aView->GetDetailLevel( ViewBBox(), true );
+}
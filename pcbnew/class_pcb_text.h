@@ -154,6 +154,8 @@ public:
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
 
+    virtual KIGFX::VIEW_DETAIL ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const override;
+
     mutable UNIQUE_MUTEX m_mutex;
 
 #if defined(DEBUG)
@@ -509,6 +509,13 @@ unsigned int TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+KIGFX::VIEW_DETAIL TEXTE_MODULE::ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Illegible texts are drawn as bars instead of strokes
+    return aView->GetDetailLevel( ViewBBox(), true );
+}
+
+
 wxString TEXTE_MODULE::GetShownText() const
 {
     /* First order optimization: no % means that no processing is
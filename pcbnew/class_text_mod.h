@@ -229,6 +229,8 @@ public:
 
     virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    virtual KIGFX::VIEW_DETAIL ViewGetDetail( int aLayer, KIGFX::VIEW* aView ) const override;
+
 #if defined(DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const override { ShowDummy( os ); }
 #endif
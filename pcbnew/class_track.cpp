@@ -300,6 +300,7 @@ void TRACK::Rotate( const wxPoint& aRotCentre, double aAngle )
 {
     RotatePoint( &m_Start, aRotCentre, aAngle );
     RotatePoint( &m_End, aRotCentre, aAngle );
+    GeometryChanged();
 }
 
 
@@ -307,6 +308,7 @@ void TRACK::Flip( const wxPoint& aCentre )
 {
     m_Start.y = aCentre.y - (m_Start.y - aCentre.y);
     m_End.y   = aCentre.y - (m_End.y - aCentre.y);
+    GeometryChanged();
     int copperLayerCount = GetBoard()->GetCopperLayerCount();
     SetLayer( FlipLayer( GetLayer(), copperLayerCount ) );
 }
@@ -316,6 +318,7 @@ void VIA::Flip( const wxPoint& aCentre )
 {
     m_Start.y = aCentre.y - (m_Start.y - aCentre.y);
     m_End.y   = aCentre.y - (m_End.y - aCentre.y);
+    GeometryChanged();
 
     if( GetViaType() != VIA_THROUGH )
     {
@@ -1607,6 +1610,7 @@ void TRACK::SwapData( BOARD_ITEM* aImage )
     assert( aImage->Type() == PCB_TRACE_T );
 
     std::swap( *((TRACK*) this), *((TRACK*) aImage) );
+    GeometryChanged();
 }
 
 void VIA::SwapData( BOARD_ITEM* aImage )
@@ -1614,6 +1618,7 @@ void VIA::SwapData( BOARD_ITEM* aImage )
     assert( aImage->Type() == PCB_VIA_T );
 
     std::swap( *((VIA*) this), *((VIA*) aImage) );
+    GeometryChanged();
 }
 
 #if defined(DEBUG)
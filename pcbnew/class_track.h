@@ -103,22 +103,23 @@ public:
     {
         m_Start += aMoveVector;
         m_End   += aMoveVector;
+        GeometryChanged();
     }
 
     virtual void Rotate( const wxPoint& aRotCentre, double aAngle ) override;
 
     virtual void Flip( const wxPoint& aCentre ) override;
 
-    void SetPosition( const wxPoint& aPos ) override { m_Start = aPos; }
+    void SetPosition( const wxPoint& aPos ) override { m_Start = aPos; GeometryChanged(); }
     const wxPoint GetPosition() const override { return m_Start; }
 
-    void SetWidth( int aWidth )                 { m_Width = aWidth; }
+    void SetWidth( int aWidth )                 { m_Width = aWidth; GeometryChanged(); }
     int GetWidth() const                        { return m_Width; }
 
-    void SetEnd( const wxPoint& aEnd )          { m_End = aEnd; }
+    void SetEnd( const wxPoint& aEnd )          { m_End = aEnd; GeometryChanged(); }
     const wxPoint& GetEnd() const               { return m_End; }
 
-    void SetStart( const wxPoint& aStart )      { m_Start = aStart; }
+    void SetStart( const wxPoint& aStart )      { m_Start = aStart; GeometryChanged(); }
     const wxPoint& GetStart() const             { return m_Start; }
 
 
@@ -424,7 +425,12 @@ public:
     void SanitizeLayers();
 
     const wxPoint GetPosition() const override {  return m_Start; }
-    void SetPosition( const wxPoint& aPoint ) override { m_Start = aPoint;  m_End = aPoint; }
+    void SetPosition( const wxPoint& aPoint ) override
+    {
+        m_Start = aPoint;
+        m_End = aPoint;
+        GeometryChanged();
+    }
 
     virtual bool HitTest( const wxPoint& aPosition ) const override;
 
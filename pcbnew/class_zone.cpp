@@ -48,6 +48,9 @@
 #include <math_for_graphics.h>
 #include <polygon_test_point_inside.h>
 
+#include <cstdint>
+#include <mutex>
+
 
 ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     BOARD_CONNECTED_ITEM( aBoard, PCB_ZONE_AREA_T )
@@ -67,6 +70,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     m_cornerRadius = 0;
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
+    m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     aBoard->GetZoneSettings().ExportSetting( *this );
 }
 
@@ -90,7 +94,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList; // shared until one of the zones modifies it
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_isKeepout = aZone.m_isKeepout;
@@ -129,8 +133,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -153,12 +156,21 @@ EDA_ITEM* ZONE_CONTAINER::Clone() const
 }
 
 
+SHAPE_POLY_SET& ZONE_CONTAINER::filledPolysForWrite()
+{
+    if( m_FilledPolysList.use_count() > 1 )
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( *m_FilledPolysList );
+
+    return *m_FilledPolysList;
+}
+
+
 bool ZONE_CONTAINER::UnFill()
 {
-    bool change = ( !m_FilledPolysList.IsEmpty() ) ||
+    bool change = ( !m_FilledPolysList->IsEmpty() ) ||
                   ( m_FillSegmList.size() > 0 );
 
-    m_FilledPolysList.RemoveAllContours();
+    m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     m_FillSegmList.clear();
     m_IsFilled = false;
 
@@ -262,6 +274,12 @@ void ZONE_CONTAINER::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
+void ZONE_CONTAINER::ViewPrepareGeometry()
+{
+    CacheTriangulation();
+}
+
+
 bool ZONE_CONTAINER::IsOnLayer( PCB_LAYER_ID aLayer ) const
 {
     if( GetIsKeepout() )
@@ -420,7 +438,7 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     if( displ_opts->m_DisplayZonesMode == 1 )     // Do not show filled areas
         return;
 
-    if( m_FilledPolysList.IsEmpty() )  // Nothing to draw
+    if( m_FilledPolysList->IsEmpty() )  // Nothing to draw
         return;
 
     BOARD*      brd = GetBoard();
@@ -446,9 +464,9 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     color.a = 0.588;
 
 
-    for ( int ic = 0; ic < m_FilledPolysList.OutlineCount(); ic++ )
+    for ( int ic = 0; ic < m_FilledPolysList->OutlineCount(); ic++ )
     {
-        const SHAPE_LINE_CHAIN& path = m_FilledPolysList.COutline( ic );
+        const SHAPE_LINE_CHAIN& path = m_FilledPolysList->COutline( ic );
 
         CornersBuffer.clear();
 
@@ -806,7 +824,7 @@ int ZONE_CONTAINER::GetClearance( BOARD_CONNECTED_ITEM* aItem ) const
 
 bool ZONE_CONTAINER::HitTestFilledArea( const wxPoint& aRefPos ) const
 {
-    return m_FilledPolysList.Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
+    return m_FilledPolysList->Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
 }
 
 
@@ -884,9 +902,9 @@ void ZONE_CONTAINER::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PANEL
     msg.Printf( wxT( "%d" ), (int) m_HatchLines.size() );
     aList.push_back( MSG_PANEL_ITEM( _( "Hatch Lines" ), msg, BLUE ) );
 
-    if( !m_FilledPolysList.IsEmpty() )
+    if( !m_FilledPolysList->IsEmpty() )
     {
-        msg.Printf( wxT( "%d" ), m_FilledPolysList.TotalVertices() );
+        msg.Printf( wxT( "%d" ), m_FilledPolysList->TotalVertices() );
         aList.push_back( MSG_PANEL_ITEM( _( "Corner Count" ), msg, BLUE ) );
     }
 }
@@ -901,7 +919,7 @@ void ZONE_CONTAINER::Move( const wxPoint& offset )
 
     Hatch();
 
-    m_FilledPolysList.Move( VECTOR2I( offset.x, offset.y ) );
+    filledPolysForWrite().Move( VECTOR2I( offset.x, offset.y ) );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
     {
@@ -939,7 +957,7 @@ void ZONE_CONTAINER::Rotate( const wxPoint& centre, double angle )
     Hatch();
 
     /* rotate filled areas: */
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = filledPolysForWrite().Iterate(); ic; ++ic )
         RotatePoint( &ic->x, &ic->y, centre.x, centre.y, angle );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
@@ -980,7 +998,7 @@ void ZONE_CONTAINER::Mirror( const wxPoint& mirror_ref )
 
     Hatch();
 
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = filledPolysForWrite().Iterate(); ic; ++ic )
     {
         int py = mirror_ref.y - ic->y;
         ic->y = py + mirror_ref.y;
@@ -1281,7 +1299,16 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
 
 void ZONE_CONTAINER::CacheTriangulation()
 {
-    m_FilledPolysList.CacheTriangulation();
+    // The filled polygons can be shared by copies of this zone, on the board too, and
+    // the zones are prepared by several threads (see VIEW::prepareItems()): a lock
+    // per set serializes the triangulation of a shared set, the next callers find
+    // it up to date
+    static std::mutex locks[64];
+
+    uintptr_t set = reinterpret_cast<uintptr_t>( m_FilledPolysList.get() );
+    std::lock_guard<std::mutex> lock( locks[( set / sizeof( SHAPE_POLY_SET ) ) % 64] );
+
+    m_FilledPolysList->CacheTriangulation();
 }
 
 
@@ -31,6 +31,7 @@
 #define CLASS_ZONE_H_
 
 
+#include <memory>
 #include <vector>
 #include <gr_basic.h>
 #include <class_board_item.h>
@@ -171,6 +172,8 @@ public:
 
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const override;
 
+    virtual void ViewPrepareGeometry() override;
+
     void SetFillMode( ZONE_FILL_MODE aFillMode )                   { m_FillMode = aFillMode; }
     ZONE_FILL_MODE GetFillMode() const                             { return m_FillMode; }
 
@@ -520,7 +523,7 @@ public:
      */
     void ClearFilledPolysList()
     {
-        m_FilledPolysList.RemoveAllContours();
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     }
 
    /**
@@ -533,7 +536,7 @@ public:
 
     const SHAPE_POLY_SET& GetFilledPolysList() const
     {
-        return m_FilledPolysList;
+        return *m_FilledPolysList;
     }
 
     void CacheTriangulation();
@@ -544,7 +547,17 @@ public:
      */
     void SetFilledPolysList( SHAPE_POLY_SET& aPolysList )
     {
-        m_FilledPolysList = aPolysList;
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( aPolysList );
+    }
+
+    /**
+     * Function GetFilledPolysUseCount
+     * @return the number of zones sharing the filled polygons of this zone: the copies
+     * of a zone (undo/redo images) share its filled polygons until one of them is modified
+     */
+    long GetFilledPolysUseCount() const
+    {
+        return m_FilledPolysList.use_count();
     }
 
     /**
@@ -668,6 +681,11 @@ public:
     virtual void SwapData( BOARD_ITEM* aImage ) override;
 
 private:
+    /**
+     * @return the filled polygons, to be modified in place: they are copied first
+     * if they are shared with a copy of the zone
+     */
+    SHAPE_POLY_SET& filledPolysForWrite();
 
     SHAPE_POLY_SET*       m_Poly;                ///< Outline of the zone.
     int                   m_cornerSmoothingType;
@@ -732,8 +750,10 @@ private:
      * a polygon equivalent to m_Poly, without holes but with extra outline segment
      * connecting "holes" with external main outline.  In complex cases an outline
      * described by m_Poly can have many filled areas
+     * The polygons are shared by the copies of the zone, and copied before being modified
+     * (see filledPolysForWrite())
      */
-    SHAPE_POLY_SET        m_FilledPolysList;
+    std::shared_ptr<SHAPE_POLY_SET> m_FilledPolysList;
     SHAPE_POLY_SET        m_RawPolysList;
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
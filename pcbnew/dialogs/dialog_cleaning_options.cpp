@@ -26,6 +26,14 @@
  */
 #include <wx/wx.h>
 
+#include <fctsys.h>
+#include <class_drawpanel.h>
+#include <pcb_edit_frame.h>
+#include <board_commit.h>
+#include <tracks_cleaner.h>
+#include <tool/tool_manager.h>
+#include <tools/pcb_actions.h>
+
 #include <dialog_cleaning_options.h>
 
 
@@ -48,3 +56,35 @@ bool DIALOG_CLEANING_OPTIONS::m_mergeSegments = true;
 bool DIALOG_CLEANING_OPTIONS::m_deleteUnconnectedSegm = true;
 bool DIALOG_CLEANING_OPTIONS::m_deleteShortCircuits = true;
 
+
+/* Install the cleanup dialog frame to know what should be cleaned
+*/
+void PCB_EDIT_FRAME::Clean_Pcb()
+{
+    DIALOG_CLEANING_OPTIONS dlg( this );
+
+    if( dlg.ShowModal() != wxID_OK )
+        return;
+
+    // Old model has to be refreshed, GAL normally does not keep updating it
+    Compile_Ratsnest( NULL, false );
+
+    wxBusyCursor dummy;
+    BOARD_COMMIT commit( this );
+    TRACKS_CLEANER cleaner( GetBoard(), commit );
+
+    // Clear current selection list to avoid selection of deleted items
+    GetToolManager()->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    bool modified = cleaner.CleanupBoard( dlg.m_deleteShortCircuits, dlg.m_cleanVias,
+                            dlg.m_mergeSegments, dlg.m_deleteUnconnectedSegm );
+
+    if( modified )
+    {
+        // Clear undo and redo lists to avoid inconsistencies between lists
+        SetCurItem( NULL );
+        commit.Push( _( "Board cleanup" ) );
+    }
+
+    m_canvas->Refresh( true );
+}
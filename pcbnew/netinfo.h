@@ -226,7 +226,7 @@ public:
      */
     int GetNet() const { return m_NetCode; }
 
-    void SetNetCode( int aNetCode ) { m_NetCode = aNetCode; }
+    void SetNetCode( int aNetCode ) { m_NetCode = aNetCode; GeometryChanged(); }
 
     /**
      * Function GetNetname
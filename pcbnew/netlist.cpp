@@ -49,6 +49,8 @@ using namespace std::placeholders;
 #include <ratsnest_data.h>
 #include <pcbnew.h>
 #include <io_mgr.h>
+#include <board_commit.h>
+#include <tracks_cleaner.h>
 
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
@@ -347,3 +349,26 @@ void PCB_EDIT_FRAME::LoadFootprints( NETLIST& aNetlist, REPORTER* aReporter )
             component->SetModule( module );
     }
 }
+
+
+bool PCB_EDIT_FRAME::RemoveMisConnectedTracks()
+{
+    // Old model has to be refreshed, GAL normally does not keep updating it
+    Compile_Ratsnest( NULL, false );
+    BOARD_COMMIT commit( this );
+
+    TRACKS_CLEANER cleaner( GetBoard(), commit );
+    bool isModified = cleaner.CleanupBoard( true, false, false, false );
+
+    if( isModified )
+    {
+        // Clear undo and redo lists to avoid inconsistencies between lists
+        SetCurItem( NULL );
+        commit.Push( _( "Board cleanup" ) );
+        Compile_Ratsnest( NULL, true );
+    }
+
+    m_canvas->Refresh( true );
+
+    return isModified;
+}
@@ -112,6 +112,10 @@ PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_painter.reset( new KIGFX::PCB_PAINTER( m_gal ) );
     m_view->SetPainter( m_painter.get() );
 
+    // Items that are tiny on the screen are drawn with a reduced level of detail:
+    // texts and pads below 24 pixels are simplified, anything below 3 pixels becomes a box
+    m_view->SetDetailThresholds( 24.0, 3.0 );
+
     setDefaultLayerOrder();
     setDefaultLayerDeps();
 
@@ -141,12 +145,12 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 {
     m_view->Clear();
 
-    // Load zones
+    // Build the spatial index once all the items are loaded
+    m_view->BeginBulkAdd();
+
+    // Load zones (fill triangulation is cached by the VIEW, in parallel)
     for( auto zone : aBoard->Zones() )
-    {
-        zone->CacheTriangulation();
         m_view->Add( zone );
-    }
 
     // Load drawings
     for( auto drawing : const_cast<BOARD*>(aBoard)->Drawings() )
@@ -173,6 +177,8 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     // Ratsnest
     m_ratsnest.reset( new KIGFX::RATSNEST_VIEWITEM( aBoard->GetConnectivity() ) );
     m_view->Add( m_ratsnest.get() );
+
+    m_view->EndBulkAdd();
 }
 
 
@@ -278,6 +278,40 @@ int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 }
 
 
+bool PCB_PAINTER::drawBoundingBox( const EDA_ITEM* aItem, int aLayer )
+{
+    // Net names, holes and markers do not resemble the item bounding box. Vias are not
+    // worth it, as they are drawn with a single circle anyway.
+    if( aLayer >= PCB_LAYER_ID_COUNT && aLayer != LAYER_PADS_TH )
+        return false;
+
+    const BOX2I bbox = aItem->ViewBBox();
+
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( m_pcbSettings.GetColor( aItem, aLayer ) );
+    m_gal->DrawRectangle( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetEnd() ) );
+
+    return true;
+}
+
+
+void PCB_PAINTER::drawSimplifiedText( const EDA_TEXT* aText, double aAngle )
+{
+    // A bar through the middle of the text box, rotated around the text anchor
+    const EDA_RECT box = aText->GetTextBox( -1, -1 );
+    const VECTOR2D anchor( aText->GetTextPos() );
+    VECTOR2D start( box.GetX(), box.Centre().y );
+    VECTOR2D end( box.GetRight(), box.Centre().y );
+
+    start = anchor + ( start - anchor ).Rotate( -aAngle );
+    end = anchor + ( end - anchor ).Rotate( -aAngle );
+
+    m_gal->SetLineWidth( box.GetHeight() / 2.0 );
+    m_gal->DrawLine( start, end );
+}
+
+
 bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 {
     const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
@@ -285,6 +319,9 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     if( !item )
         return false;
 
+    if( m_detail == DETAIL_BBOX && drawBoundingBox( item, aLayer ) )
+        return true;
+
     // the "cast" applied in here clarifies which overloaded draw() is called
     switch( item->Type() )
     {
@@ -586,6 +623,10 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     // Draw description layer
     if( IsNetnameLayer( aLayer ) )
     {
+        // Descriptions of small pads would not be legible anyway
+        if( m_detail != DETAIL_FULL )
+            return;
+
         VECTOR2D position( aPad->ShapePos() );
 
         // Is anything that we can display enabled?
@@ -755,6 +796,11 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
         shape = aPad->GetShape();
     }
 
+    // Simplified pads avoid tessellating rounded corners and custom outlines
+    if( m_detail == DETAIL_SIMPLIFIED
+            && ( shape == PAD_SHAPE_ROUNDRECT || shape == PAD_SHAPE_TRAPEZOID ) )
+        shape = PAD_SHAPE_RECT;
+
     switch( shape )
     {
     case PAD_SHAPE_OVAL:
@@ -826,7 +872,12 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
         // custom shape, because it is a set of basic shapes
         // We use the custom_margin (good for solder mask, but approximative
         // for solder paste).
-        if( custom_margin )
+        if( m_detail == DETAIL_SIMPLIFIED )
+        {
+            BOX2I bbox = aPad->GetCustomShapeAsPolygon().BBox( custom_margin );
+            m_gal->DrawRectangle( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetEnd() ) );
+        }
+        else if( custom_margin )
         {
             SHAPE_POLY_SET outline;
             outline.Append( aPad->GetCustomShapeAsPolygon() );
@@ -877,6 +928,7 @@ void PCB_PAINTER::draw( const D_PAD* aPad, int aLayer )
     constexpr int clearanceFlags = /*PCB_RENDER_SETTINGS::CL_EXISTING |*/ PCB_RENDER_SETTINGS::CL_PADS;
 
     if( ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags
+            && m_detail == DETAIL_FULL
             && ( aLayer == LAYER_PAD_FR
                 || aLayer == LAYER_PAD_BK
                 || aLayer == LAYER_PADS_TH ) )
@@ -964,7 +1016,12 @@ void PCB_PAINTER::draw( const DRAWSEGMENT* aSegment, int aLayer )
         m_gal->SetLineWidth( thickness );
         m_gal->SetIsFill( true );
         m_gal->SetIsStroke( true );
-        m_gal->DrawPolygon( pointsList );
+
+        // Use the triangulation prepared by DRAWSEGMENT::ViewPrepareGeometry(), if available
+        if( aSegment->GetPolyShape().IsTriangulationUpToDate() )
+            m_gal->DrawPolygon( aSegment->GetPolyShape() );
+        else
+            m_gal->DrawPolygon( pointsList );
 
         m_gal->Restore();
         break;
@@ -1009,6 +1066,13 @@ void PCB_PAINTER::draw( const TEXTE_PCB* aText, int aLayer )
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
+
+    if( m_detail == DETAIL_SIMPLIFIED )
+    {
+        drawSimplifiedText( aText, aText->GetTextAngleRadians() );
+        return;
+    }
+
     m_gal->SetTextAttributes( aText );
     m_gal->StrokeText( shownText, position, aText->GetTextAngleRadians() );
 }
@@ -1037,6 +1101,13 @@ void PCB_PAINTER::draw( const TEXTE_MODULE* aText, int aLayer )
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
+
+    if( m_detail == DETAIL_SIMPLIFIED )
+    {
+        drawSimplifiedText( aText, aText->GetDrawRotationRadians() );
+        return;
+    }
+
     m_gal->SetTextAttributes( aText );
     m_gal->StrokeText( shownText, position, aText->GetDrawRotationRadians() );
 
@@ -227,6 +227,23 @@ protected:
      * @return the thickness to draw
      */
     int getLineThickness( int aActualThickness ) const;
+
+    /**
+     * Function drawBoundingBox()
+     * Draws an item as its filled bounding box, used when the item is only a few pixels large.
+     * @param aItem is the item to be drawn.
+     * @param aLayer is the currently drawn layer.
+     * @return false if the item should not be drawn this way on the layer (e.g. holes).
+     */
+    bool drawBoundingBox( const EDA_ITEM* aItem, int aLayer );
+
+    /**
+     * Function drawSimplifiedText()
+     * Draws a text that is too small to be legible as a bar covering the text area.
+     * @param aText is the text to be drawn.
+     * @param aAngle is the text orientation (in radians).
+     */
+    void drawSimplifiedText( const EDA_TEXT* aText, double aAngle );
 };
 } // namespace KIGFX
 
@@ -38,6 +38,19 @@
 
 #include <pcbnew_id.h>
 
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_edge_mod.h>
+#include <class_text_mod.h>
+#include <class_drawsegment.h>
+#include <class_pcb_text.h>
+#include <class_pcb_target.h>
+#include <class_dimension.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+#include <algorithm>
+
 
 #define ZOOM_FACTOR( x )       ( x * IU_PER_MILS / 10 )
 #define DMIL_GRID( x )         wxRealPoint( x * IU_PER_MILS / 10,\
@@ -176,6 +189,10 @@ PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
     m_Route_Layer_TOP    = F_Cu;     // default layers pair for vias (bottom to top)
     m_Route_Layer_BOTTOM = B_Cu;
 
+    m_undoMemoryMax = DEFAULT_MAX_UNDO_MEMORY;
+    m_undoMemory = 0;
+    m_redoMemory = 0;
+
     SetZoom( DEFAULT_ZOOM );             // a default value for zoom
 
     InitDataPoints( aPageSizeIU );
@@ -192,3 +209,214 @@ int PCB_SCREEN::MilsToIuScalar()
 {
     return (int)IU_PER_MILS;
 }
+
+
+/**
+ * Function itemMemorySize
+ * @return an estimate of the memory used by a board item and its children, in bytes.
+ * The filled polygons of a zone are shared by its copies, so each copy counts for a part.
+ */
+static size_t itemMemorySize( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t size = sizeof( MODULE );
+
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+            size += itemMemorySize( pad );
+
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+            size += itemMemorySize( item );
+
+        return size;
+    }
+
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        return sizeof( D_PAD ) + pad->GetPrimitives().size() * sizeof( PAD_CS_PRIMITIVE )
+               + pad->GetCustomShapeAsPolygon().TotalVertices() * sizeof( VECTOR2I );
+    }
+
+    case PCB_MODULE_EDGE_T:
+        return sizeof( EDGE_MODULE )
+               + static_cast<const EDGE_MODULE*>( aItem )->GetPolyShape().TotalVertices()
+                 * sizeof( VECTOR2I );
+
+    case PCB_LINE_T:
+        return sizeof( DRAWSEGMENT )
+               + static_cast<const DRAWSEGMENT*>( aItem )->GetPolyShape().TotalVertices()
+                 * sizeof( VECTOR2I );
+
+    case PCB_MODULE_TEXT_T:
+        return sizeof( TEXTE_MODULE )
+               + static_cast<const TEXTE_MODULE*>( aItem )->GetText().length() * sizeof( wxChar );
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB )
+               + static_cast<const TEXTE_PCB*>( aItem )->GetText().length() * sizeof( wxChar );
+
+    case PCB_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+        size_t size = sizeof( ZONE_CONTAINER )
+                      + zone->Outline()->TotalVertices() * sizeof( VECTOR2I )
+                      + zone->GetHatchLines().size() * sizeof( SEG )
+                      + zone->FillSegments().size() * sizeof( SEG );
+
+        size += zone->GetFilledPolysList().TotalVertices() * sizeof( VECTOR2I )
+                / std::max( zone->GetFilledPolysUseCount(), 1L );
+
+        return size;
+    }
+
+    case PCB_TRACE_T:
+    case PCB_ZONE_T:
+        return sizeof( TRACK );
+
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    case PCB_DIMENSION_T:
+        return sizeof( DIMENSION );
+
+    case PCB_TARGET_T:
+        return sizeof( PCB_TARGET );
+
+    default:
+        return sizeof( BOARD_ITEM );
+    }
+}
+
+
+/**
+ * Function commandMemorySize
+ * @return an estimate of the memory used by the items owned by an undo/redo command:
+ * the copies of the changed items, and the deleted items.
+ */
+static size_t commandMemorySize( const PICKED_ITEMS_LIST& aCommand )
+{
+    size_t size = sizeof( PICKED_ITEMS_LIST ) + aCommand.GetCount() * sizeof( ITEM_PICKER );
+
+    for( unsigned ii = 0; ii < aCommand.GetCount(); ii++ )
+    {
+        const BOARD_ITEM* image = (const BOARD_ITEM*) aCommand.GetPickedItemLink( ii );
+
+        if( image )
+            size += itemMemorySize( image );
+
+        if( aCommand.GetPickedItemStatus( ii ) == UR_DELETED && aCommand.GetPickedItem( ii ) )
+            size += itemMemorySize( (const BOARD_ITEM*) aCommand.GetPickedItem( ii ) );
+    }
+
+    return size;
+}
+
+
+size_t PCB_SCREEN::forgetCommand( const PICKED_ITEMS_LIST* aCommand )
+{
+    auto it = m_commandMemory.find( aCommand );
+
+    if( it == m_commandMemory.end() )
+        return 0;
+
+    size_t size = it->second;
+    m_commandMemory.erase( it );
+
+    return size;
+}
+
+
+void PCB_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
+{
+    // A command popped and pushed again may have been modified: estimate it again
+    size_t size = commandMemorySize( *aNewitem );
+
+    m_commandMemory[aNewitem] = size;
+    m_undoMemory += size;
+
+    BASE_SCREEN::PushCommandToUndoList( aNewitem );
+
+    if( m_undoMemoryMax == 0 )
+        return;
+
+    size_t total = GetUndoRedoMemory();
+    int    extraitems = 0;
+
+    // The oldest commands are the first ones of the list
+    for( const PICKED_ITEMS_LIST* command : m_UndoList.m_CommandsList )
+    {
+        if( total <= m_undoMemoryMax || extraitems == GetUndoCommandCount() - 1 )
+            break;
+
+        total -= m_commandMemory[command];
+        extraitems++;
+    }
+
+    if( extraitems > 0 )
+        ClearUndoORRedoList( m_UndoList, extraitems );
+}
+
+
+void PCB_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
+{
+    size_t size = commandMemorySize( *aNewitem );
+
+    m_commandMemory[aNewitem] = size;
+    m_redoMemory += size;
+
+    BASE_SCREEN::PushCommandToRedoList( aNewitem );
+}
+
+
+PICKED_ITEMS_LIST* PCB_SCREEN::PopCommandFromUndoList()
+{
+    PICKED_ITEMS_LIST* command = BASE_SCREEN::PopCommandFromUndoList();
+
+    m_undoMemory -= forgetCommand( command );
+
+    return command;
+}
+
+
+PICKED_ITEMS_LIST* PCB_SCREEN::PopCommandFromRedoList()
+{
+    PICKED_ITEMS_LIST* command = BASE_SCREEN::PopCommandFromRedoList();
+
+    m_redoMemory -= forgetCommand( command );
+
+    return command;
+}
+
+
+void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount )
+{
+    if( aItemCount == 0 )
+        return;
+
+    unsigned icnt = aList.m_CommandsList.size();
+
+    if( aItemCount > 0 )
+        icnt = aItemCount;
+
+    for( unsigned ii = 0; ii < icnt; ii++ )
+    {
+        if( aList.m_CommandsList.size() == 0 )
+            break;
+
+        PICKED_ITEMS_LIST* curr_cmd = aList.m_CommandsList[0];
+        aList.m_CommandsList.erase( aList.m_CommandsList.begin() );
+
+        if( &aList == &m_UndoList )
+            m_undoMemory -= forgetCommand( curr_cmd );
+        else if( &aList == &m_RedoList )
+            m_redoMemory -= forgetCommand( curr_cmd );
+
+        curr_cmd->ClearListAndDeleteItems();
+        delete curr_cmd;    // Delete command
+    }
+}
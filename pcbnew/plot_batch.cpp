@@ -0,0 +1,308 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_batch.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fctsys.h>
+#include <common.h>
+#include <plotter.h>
+#include <reporter.h>
+#include <wildcards_and_files_ext.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <pcbplot.h>
+#include <plot_batch.h>
+#include <gerber_jobfile_writer.h>
+#include <gendrill_Excellon_writer.h>
+#include <gendrill_gerber_writer.h>
+
+
+/**
+ * A REPORTER keeping the messages of a task, to give them to the caller's REPORTER
+ * (usually not thread safe) once all the tasks are finished.
+ */
+class BUFFERED_REPORTER : public REPORTER
+{
+public:
+    BUFFERED_REPORTER() : m_hasErrors( false ) {}
+
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.push_back( std::make_pair( aText, aSeverity ) );
+
+        if( aSeverity == RPT_ERROR )
+            m_hasErrors = true;
+
+        return *this;
+    }
+
+    bool HasMessage() const override { return !m_messages.empty(); }
+
+    bool HasErrors() const { return m_hasErrors; }
+
+    void Flush( REPORTER* aReporter ) const
+    {
+        if( !aReporter )
+            return;
+
+        for( const auto& message : m_messages )
+            aReporter->Report( message.first, message.second );
+    }
+
+private:
+    std::vector< std::pair< wxString, SEVERITY > > m_messages;
+    bool m_hasErrors;
+};
+
+
+// A task generates one or more files, and returns false on error
+typedef std::function< bool( REPORTER& aReporter ) > PLOT_TASK;
+
+
+// StartPlotBoard() plots the worksheet, using static data of the worksheet code:
+// the plotters are created one at a time
+static std::mutex s_startPlotMutex;
+
+
+static bool plotLayer( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts, PCB_LAYER_ID aLayer,
+                       const wxString& aFullFileName, REPORTER& aReporter )
+{
+    // StartPlotBoard() can modify the plot options
+    PCB_PLOT_PARAMS plotOpts = aPlotOpts;
+    PLOTTER* plotter;
+
+    {
+        std::lock_guard< std::mutex > lock( s_startPlotMutex );
+
+        plotter = StartPlotBoard( aBoard, &plotOpts, aLayer, aFullFileName, wxEmptyString );
+    }
+
+    wxString msg;
+
+    if( !plotter )
+    {
+        msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( aFullFileName ) );
+        aReporter.Report( msg, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    PlotOneBoardLayer( aBoard, plotter, aLayer, plotOpts );
+    bool ok = plotter->EndPlot();
+    delete plotter;
+
+    if( !ok )
+    {
+        msg.Printf( _( "Unable to write file \"%s\"." ), GetChars( aFullFileName ) );
+        aReporter.Report( msg, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    msg.Printf( _( "Plot file \"%s\" created." ), GetChars( aFullFileName ) );
+    aReporter.Report( msg, REPORTER::RPT_ACTION );
+
+    return true;
+}
+
+
+PLOT_BATCH::PLOT_BATCH( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts ) :
+    m_board( aBoard ),
+    m_plotOpts( aPlotOpts ),
+    m_drillFiles( false ),
+    m_gerberDrillFiles( false ),
+    m_drillMapFormat( PLOT_FORMAT_UNDEFINED ),
+    m_threadCount( 0 )
+{
+}
+
+
+void PLOT_BATCH::SetDrillFiles( bool aGerberFormat, PlotFormat aMapFormat )
+{
+    m_drillFiles = true;
+    m_gerberDrillFiles = aGerberFormat;
+    m_drillMapFormat = aMapFormat;
+}
+
+
+bool PLOT_BATCH::Run( REPORTER* aReporter )
+{
+    wxString    boardFilename = m_board->GetFileName();
+    wxFileName  outputDir = wxFileName::DirName( m_plotOpts.GetOutputDirectory() );
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename, aReporter ) )
+        return false;
+
+    const wxString  outputPath = outputDir.GetPath();
+    const bool      gerber = m_plotOpts.GetFormat() == PLOT_FORMAT_GERBER;
+
+    std::vector< PLOT_TASK > tasks;
+    std::vector< std::pair< PCB_LAYER_ID, wxString > > gerberFiles;
+
+    for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
+    {
+        PCB_LAYER_ID layer = *seq;
+
+        // All copper layers that are disabled are actually selected
+        // This is due to wonkyness in automatically selecting copper layers
+        // for plotting when adding more than two layers to a board.
+        // If plot options become accessible to the layers setup dialog
+        // please move this functionality there!
+        // This skips a copper layer if it is actually disabled on the board.
+        if( ( LSET::AllCuMask() & ~m_board->GetEnabledLayers() )[layer] )
+            continue;
+
+        // Pick the basename from the board file
+        wxFileName fn( boardFilename );
+        wxString file_ext = GetDefaultPlotExtension( m_plotOpts.GetFormat() );
+
+        // Use Gerber Extensions based on layer number
+        // (See http://en.wikipedia.org/wiki/Gerber_File)
+        if( gerber && m_plotOpts.GetUseGerberProtelExtensions() )
+            file_ext = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, outputPath, m_board->GetLayerName( layer ), file_ext );
+        gerberFiles.push_back( std::make_pair( layer, fn.GetFullName() ) );
+
+        const wxString fullname = fn.GetFullPath();
+
+        tasks.push_back( [this, layer, fullname]( REPORTER& aTaskReporter )
+                {
+                    return plotLayer( m_board, m_plotOpts, layer, fullname, aTaskReporter );
+                } );
+    }
+
+    if( gerber && m_plotOpts.GetCreateGerberJobFile() )
+    {
+        // Pick the basename from the board file
+        wxFileName fn( boardFilename );
+        // Build gerber job file from basename
+        BuildPlotFileName( &fn, outputPath, "job", GerberJobFileExtension );
+
+        const wxString fullname = fn.GetFullPath();
+
+        tasks.push_back( [this, gerberFiles, fullname]( REPORTER& aTaskReporter )
+                {
+                    GERBER_JOBFILE_WRITER jobfile_writer( m_board, &aTaskReporter );
+
+                    for( auto file : gerberFiles )
+                        jobfile_writer.AddGbrFile( file.first, file.second );
+
+                    return jobfile_writer.CreateJobFile( fullname );
+                } );
+    }
+
+    if( m_drillFiles )
+    {
+        tasks.push_back( [this, outputPath]( REPORTER& aTaskReporter )
+                {
+                    wxPoint offset;
+
+                    if( m_plotOpts.GetUseAuxOrigin() )
+                        offset = m_board->GetAuxOrigin();
+
+                    bool genMap = m_drillMapFormat != PLOT_FORMAT_UNDEFINED;
+
+                    if( m_gerberDrillFiles )
+                    {
+                        GERBER_WRITER gerberWriter( m_board );
+                        gerberWriter.SetFormat( m_plotOpts.GetGerberPrecision() );
+                        gerberWriter.SetOptions( offset );
+                        gerberWriter.SetMapFileFormat( m_drillMapFormat );
+                        gerberWriter.CreateDrillandMapFilesSet( outputPath, true, genMap,
+                                                                &aTaskReporter );
+                    }
+                    else
+                    {
+                        EXCELLON_WRITER excellonWriter( m_board );
+                        excellonWriter.SetFormat( true );
+                        excellonWriter.SetOptions( false, false, offset, false );
+                        excellonWriter.SetMapFileFormat( m_drillMapFormat );
+                        excellonWriter.CreateDrillandMapFilesSet( outputPath, true, genMap,
+                                                                  &aTaskReporter );
+                    }
+
+                    // the drill writers only report their errors
+                    return true;
+                } );
+    }
+
+    if( tasks.empty() )
+        return true;
+
+    // Keep the locale set for the whole batch: the LOCALE_IO of the plotters and
+    // writers do not change it again, from several threads
+    LOCALE_IO toggle;
+
+    // The pads cache their bounding radius on first use: compute it now, so the
+    // board is only read by the tasks
+    for( MODULE* module = m_board->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->PadsList();  pad;  pad = pad->Next() )
+            pad->GetBoundingRadius();
+    }
+
+    std::vector< BUFFERED_REPORTER > reporters( tasks.size() );
+    std::vector< char > results( tasks.size(), 0 );
+
+    size_t threadCount = m_threadCount ? m_threadCount : std::thread::hardware_concurrency();
+    threadCount = std::max( std::min( threadCount, tasks.size() ), (size_t) 1 );
+
+    std::atomic<size_t> nextTask( 0 );
+    std::vector<std::thread> plotWorkers;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+    {
+        plotWorkers.push_back( std::thread( [&]()
+        {
+            for( size_t i = nextTask.fetch_add( 1 ); i < tasks.size();
+                    i = nextTask.fetch_add( 1 ) )
+            {
+                results[i] = tasks[i]( reporters[i] ) && !reporters[i].HasErrors();
+            }
+        } ) );
+    }
+
+    for( auto& worker : plotWorkers )
+        worker.join();
+
+    // Report in the order of the tasks, as when plotting the layers one after the other
+    bool success = true;
+
+    for( size_t i = 0; i < tasks.size(); ++i )
+    {
+        reporters[i].Flush( aReporter );
+        success = success && results[i];
+    }
+
+    return success;
+}
@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_batch.h
+ */
+
+#ifndef PLOT_BATCH_H_
+#define PLOT_BATCH_H_
+
+#include <pcb_plot_params.h>
+
+class BOARD;
+class REPORTER;
+
+
+/**
+ * Class PLOT_BATCH
+ * generates the fabrication outputs of a board: the plot files of the layers
+ * selected in the plot options, the Gerber job file and the drill files.
+ * Each file is generated by its own task, the tasks run on a pool of threads.
+ *
+ * The board is only read while the batch runs, it must not be modified by
+ * another thread meanwhile. It is used by the plot dialog and from Python
+ * scripts, to package the fabrication outputs without the GUI.
+ */
+class PLOT_BATCH
+{
+public:
+    /**
+     * @param aBoard is the board to plot
+     * @param aPlotOpts are the plot options: format, layer selection, output
+     * directory (relative to the board file), Gerber job file...
+     */
+    PLOT_BATCH( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts );
+
+    /**
+     * Function SetDrillFiles
+     * adds the drill files to the outputs
+     * @param aGerberFormat = true for Gerber X2 drill files, false for Excellon
+     * @param aMapFormat = the format of the drill map files, or
+     * PLOT_FORMAT_UNDEFINED for no drill map
+     */
+    void SetDrillFiles( bool aGerberFormat, PlotFormat aMapFormat = PLOT_FORMAT_UNDEFINED );
+
+    /**
+     * Function SetThreadCount
+     * sets the number of threads generating the files; 0 (the default) uses one
+     * thread per CPU core
+     */
+    void SetThreadCount( unsigned aCount ) { m_threadCount = aCount; }
+
+    /**
+     * Function Run
+     * generates all the files
+     * @param aReporter = a REPORTER for the created files and the errors (can be NULL);
+     * it is only called from the calling thread, once all the files are generated
+     * @return true if all the files were created
+     */
+    bool Run( REPORTER* aReporter = NULL );
+
+private:
+    BOARD*          m_board;
+    PCB_PLOT_PARAMS m_plotOpts;
+    bool            m_drillFiles;
+    bool            m_gerberDrillFiles;
+    PlotFormat      m_drillMapFormat;
+    unsigned        m_threadCount;
+};
+
+#endif  // PLOT_BATCH_H_
@@ -343,11 +343,16 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
     {
         aPlotter->StartBlock( NULL );
 
-        for( D_PAD* pad = module->PadsList();  pad;  pad = pad->Next() )
+        for( D_PAD* boardPad = module->PadsList();  boardPad;  boardPad = boardPad->Next() )
         {
-            if( (pad->GetLayerSet() & aLayerMask) == 0 )
+            if( (boardPad->GetLayerSet() & aLayerMask) == 0 )
                 continue;
 
+            // The pad size is changed to the plot size: use a copy, the board is not
+            // modified when plotting, so several layers can be plotted at the same time
+            D_PAD padCopy( *boardPad );
+            D_PAD* pad = &padCopy;
+
             wxSize margin;
             double width_adj = 0;
 
@@ -373,7 +378,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -423,9 +427,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
@@ -470,9 +472,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 }
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -69,6 +69,7 @@ class BASE_SET {};
 #include <pcbnew_scripting_helpers.h>
 
 #include <plotcontroller.h>
+#include <plot_batch.h>
 #include <pcb_plot_params.h>
 #include <exporters/gendrill_file_writer_base.h>
 #include <exporters/gendrill_Excellon_writer.h>
@@ -108,6 +109,7 @@ HANDLE_EXCEPTIONS(PLUGIN::FootprintDelete)
 
 
 %include <plotcontroller.h>
+%include <plot_batch.h>
 %include <pcb_plot_params.h>
 %include <plotter.h>
 %include <exporters/gendrill_file_writer_base.h>
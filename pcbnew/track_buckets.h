@@ -0,0 +1,201 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file track_buckets.h
+ * @brief hash containers grouping track segments and vias by net, layer and position,
+ * used by the tracks cleaner instead of searching the whole track list for each item.
+ *
+ * The functions are templates on the track type, so they only need GetNetCode(),
+ * GetLayer(), Type(), GetStart() and GetEnd().
+ */
+
+#ifndef TRACK_BUCKETS_H
+#define TRACK_BUCKETS_H
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+
+/// boost::hash_combine
+inline void TrackHashCombine( size_t& aSeed, int aValue )
+{
+    aSeed ^= std::hash<int>()( aValue ) + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+struct POSITION_HASH
+{
+    size_t operator()( const wxPoint& aPos ) const
+    {
+        size_t seed = std::hash<int>()( aPos.x );
+        TrackHashCombine( seed, aPos.y );
+        return seed;
+    }
+};
+
+
+/**
+ * Struct SEGMENT_KEY
+ * identifies the items which are duplicates of each other: same type, net and layer,
+ * and same end points, maybe swapped. The end points are stored in a fixed order.
+ */
+struct SEGMENT_KEY
+{
+    int     m_Type;
+    int     m_Net;
+    int     m_Layer;
+    wxPoint m_A;
+    wxPoint m_B;
+
+    template <class T>
+    explicit SEGMENT_KEY( const T* aTrack ) :
+        m_Type( aTrack->Type() ),
+        m_Net( aTrack->GetNetCode() ),
+        m_Layer( aTrack->GetLayer() ),
+        m_A( aTrack->GetStart() ),
+        m_B( aTrack->GetEnd() )
+    {
+        if( m_B.x < m_A.x || ( m_B.x == m_A.x && m_B.y < m_A.y ) )
+            std::swap( m_A, m_B );
+    }
+
+    bool operator==( const SEGMENT_KEY& aOther ) const
+    {
+        return m_Type == aOther.m_Type && m_Net == aOther.m_Net && m_Layer == aOther.m_Layer
+               && m_A == aOther.m_A && m_B == aOther.m_B;
+    }
+};
+
+
+struct SEGMENT_KEY_HASH
+{
+    size_t operator()( const SEGMENT_KEY& aKey ) const
+    {
+        size_t seed = std::hash<int>()( aKey.m_Net );
+
+        TrackHashCombine( seed, aKey.m_Type );
+        TrackHashCombine( seed, aKey.m_Layer );
+        TrackHashCombine( seed, aKey.m_A.x );
+        TrackHashCombine( seed, aKey.m_A.y );
+        TrackHashCombine( seed, aKey.m_B.x );
+        TrackHashCombine( seed, aKey.m_B.y );
+
+        return seed;
+    }
+};
+
+
+/**
+ * Function FindDuplicateSegments
+ * finds the items of \a aTracks having the same type, net, layer and end points
+ * (maybe swapped) as a previous item of \a aTracks: the first item of each group
+ * is kept, the other ones are appended to \a aDuplicates, in the order of \a aTracks.
+ */
+template <class T, class CONTAINER>
+void FindDuplicateSegments( CONTAINER&& aTracks, std::vector<T*>& aDuplicates )
+{
+    std::unordered_set<SEGMENT_KEY, SEGMENT_KEY_HASH> keys;
+
+    for( T* track : aTracks )
+    {
+        if( !keys.insert( SEGMENT_KEY( track ) ).second )
+            aDuplicates.push_back( track );
+    }
+}
+
+
+/**
+ * Class TRACK_ENDPOINT_INDEX
+ * gives the items of a net having an end point at a given position.
+ * Items are indexed at their start and end points (once for vias): an item must be
+ * removed from the index before its end points are modified, and added again after.
+ */
+template <class T>
+class TRACK_ENDPOINT_INDEX
+{
+public:
+    void Add( T* aTrack )
+    {
+        m_buckets[KEY( aTrack->GetNetCode(), aTrack->GetStart() )].push_back( aTrack );
+
+        if( aTrack->GetEnd() != aTrack->GetStart() )
+            m_buckets[KEY( aTrack->GetNetCode(), aTrack->GetEnd() )].push_back( aTrack );
+    }
+
+    void Remove( T* aTrack )
+    {
+        remove( KEY( aTrack->GetNetCode(), aTrack->GetStart() ), aTrack );
+
+        if( aTrack->GetEnd() != aTrack->GetStart() )
+            remove( KEY( aTrack->GetNetCode(), aTrack->GetEnd() ), aTrack );
+    }
+
+    /**
+     * @return the items of net \a aNet having an end point at \a aPosition,
+     * in the order they were added
+     */
+    const std::vector<T*>& Get( int aNet, const wxPoint& aPosition ) const
+    {
+        static const std::vector<T*> empty;
+        auto it = m_buckets.find( KEY( aNet, aPosition ) );
+
+        return it == m_buckets.end() ? empty : it->second;
+    }
+
+private:
+    typedef std::pair<int, wxPoint> KEY;
+
+    struct KEY_HASH
+    {
+        size_t operator()( const KEY& aKey ) const
+        {
+            size_t seed = POSITION_HASH()( aKey.second );
+            TrackHashCombine( seed, aKey.first );
+            return seed;
+        }
+    };
+
+    void remove( const KEY& aKey, T* aTrack )
+    {
+        auto it = m_buckets.find( aKey );
+
+        if( it == m_buckets.end() )
+            return;
+
+        std::vector<T*>& bucket = it->second;
+        bucket.erase( std::remove( bucket.begin(), bucket.end(), aTrack ), bucket.end() );
+
+        if( bucket.empty() )
+            m_buckets.erase( it );
+    }
+
+    std::unordered_map<KEY, std::vector<T*>, KEY_HASH> m_buckets;
+};
+
+#endif  // TRACK_BUCKETS_H
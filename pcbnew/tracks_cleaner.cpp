@@ -30,147 +30,14 @@
 
 
 #include <fctsys.h>
-#include <class_drawpanel.h>
-#include <pcb_edit_frame.h>
 #include <pcbnew.h>
 #include <class_board.h>
 #include <class_track.h>
-#include <dialog_cleaning_options.h>
-#include <board_commit.h>
+#include <commit.h>
 #include <connectivity_data.h>
 #include <connectivity_algo.h>
-
-#include <tool/tool_manager.h>
-#include <tools/pcb_actions.h>
-
-// Helper class used to clean tracks and vias
-class TRACKS_CLEANER
-{
-public:
-    TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit );
-
-    /**
-     * the cleanup function.
-     * return true if some item was modified
-     * @param aCleanVias = true to remove superimposed vias
-     * @param aRemoveMisConnected = true to remove segments connecting 2 different nets
-     * @param aMergeSegments = true to merge collinear segmenst and remove 0 len segm
-     * @param aDeleteUnconnected = true to remove dangling tracks
-     * (short circuits)
-     */
-    bool CleanupBoard( bool aCleanVias, bool aRemoveMisConnected,
-                       bool aMergeSegments, bool aDeleteUnconnected );
-
-private:
-    /* finds and remove all track segments which are connected to more than one net.
-     * (short circuits)
-     */
-    bool removeBadTrackSegments();
-
-    /**
-     * Removes redundant vias like vias at same location
-     * or on pad through
-     */
-    bool cleanupVias();
-
-    /**
-     * Removes all the following THT vias on the same position of the
-     * specified one
-     */
-    void removeDuplicatesOfVia( const VIA *aVia, std::set<BOARD_ITEM *>& aToRemove );
-
-    /**
-     * Removes all the following duplicates tracks of the specified one
-     */
-    void removeDuplicatesOfTrack( const TRACK* aTrack, std::set<BOARD_ITEM*>& aToRemove );
-
-    /**
-     * Removes dangling tracks
-     */
-    bool deleteDanglingTracks();
-
-    /// Delete null length track segments
-    bool deleteNullSegments();
-
-    /// Try to merge the segment to a following collinear one
-    bool MergeCollinearTracks( TRACK* aSegment );
-
-    /**
-     * Merge collinear segments and remove duplicated and null len segments
-     */
-    bool cleanupSegments();
-
-    /**
-     * helper function
-     * Rebuild list of tracks, and connected tracks
-     * this info must be rebuilt when tracks are erased
-     */
-    void buildTrackConnectionInfo();
-
-    /**
-     * helper function
-     * merge aTrackRef and aCandidate, when possible,
-     * i.e. when they are colinear, same width, and obviously same layer
-     */
-    TRACK* mergeCollinearSegmentIfPossible( TRACK* aTrackRef,
-                                           TRACK* aCandidate, ENDPOINT_T aEndType );
-
-    const ZONE_CONTAINER* zoneForTrackEndpoint( const TRACK* aTrack,
-            ENDPOINT_T aEndPoint );
-
-    bool testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPoint );
-
-    BOARD* m_brd;
-    BOARD_COMMIT& m_commit;
-
-    bool removeItems(  std::set<BOARD_ITEM*>& aItems )
-    {
-        bool isModified = false;
-
-
-        for( auto item : aItems )
-        {
-            isModified = true;
-            m_brd->Remove( item );
-            m_commit.Removed( item );
-        }
-
-        return isModified;
-    }
-};
-
-
-/* Install the cleanup dialog frame to know what should be cleaned
-*/
-void PCB_EDIT_FRAME::Clean_Pcb()
-{
-    DIALOG_CLEANING_OPTIONS dlg( this );
-
-    if( dlg.ShowModal() != wxID_OK )
-        return;
-
-    // Old model has to be refreshed, GAL normally does not keep updating it
-    Compile_Ratsnest( NULL, false );
-
-    wxBusyCursor dummy;
-    BOARD_COMMIT commit( this );
-    TRACKS_CLEANER cleaner( GetBoard(), commit );
-
-    // Clear current selection list to avoid selection of deleted items
-    GetToolManager()->RunAction( PCB_ACTIONS::selectionClear, true );
-
-    bool modified = cleaner.CleanupBoard( dlg.m_deleteShortCircuits, dlg.m_cleanVias,
-                            dlg.m_mergeSegments, dlg.m_deleteUnconnectedSegm );
-
-    if( modified )
-    {
-        // Clear undo and redo lists to avoid inconsistencies between lists
-        SetCurItem( NULL );
-        commit.Push( _( "Board cleanup" ) );
-    }
-
-    m_canvas->Refresh( true );
-}
+#include <track_buckets.h>
+#include <tracks_cleaner.h>
 
 
 void TRACKS_CLEANER::buildTrackConnectionInfo()
@@ -255,12 +122,27 @@ bool TRACKS_CLEANER::CleanupBoard( bool aRemoveMisConnected,
 }
 
 
-TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit )
+TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, COMMIT& aCommit )
     : m_brd( aPcb ), m_commit( aCommit )
 {
 }
 
 
+bool TRACKS_CLEANER::removeItems( std::set<BOARD_ITEM*>& aItems )
+{
+    bool isModified = false;
+
+    for( auto item : aItems )
+    {
+        isModified = true;
+        m_brd->Remove( item );
+        m_commit.Removed( item );
+    }
+
+    return isModified;
+}
+
+
 bool TRACKS_CLEANER::removeBadTrackSegments()
 {
     auto connectivity = m_brd->GetConnectivity();
@@ -288,28 +170,20 @@ bool TRACKS_CLEANER::removeBadTrackSegments()
 }
 
 
-void TRACKS_CLEANER::removeDuplicatesOfVia( const VIA *aVia, std::set<BOARD_ITEM *>& aToRemove )
-{
-    VIA* next_via;
-
-    for( VIA* alt_via = GetFirstVia( aVia->Next() ); alt_via != NULL; alt_via = next_via )
-    {
-        next_via = GetFirstVia( alt_via->Next() );
-
-        if( ( alt_via->GetViaType() == VIA_THROUGH ) &&
-                ( alt_via->GetStart() == aVia->GetStart() ) )
-            aToRemove.insert ( alt_via );
-    }
-}
-
-
 bool TRACKS_CLEANER::cleanupVias()
 {
     std::set<BOARD_ITEM*> toRemove;
 
+    // Positions of the unlocked through vias already seen: the following through
+    // vias at the same position are removed
+    std::unordered_set<wxPoint, POSITION_HASH> throughVias;
+
     for( VIA* via = GetFirstVia( m_brd->m_Track ); via != NULL;
             via = GetFirstVia( via->Next() ) )
     {
+        if( via->GetViaType() == VIA_THROUGH && throughVias.count( via->GetStart() ) )
+            toRemove.insert( via );
+
         if( via->GetFlags() & TRACK_LOCKED )
             continue;
 
@@ -324,7 +198,7 @@ bool TRACKS_CLEANER::cleanupVias()
          * (yet) handle high density interconnects */
         if( via->GetViaType() == VIA_THROUGH )
         {
-            removeDuplicatesOfVia( via, toRemove );
+            throughVias.insert( via->GetStart() );
 
             /* To delete through Via on THT pads at same location
              * Examine the list of connected pads:
@@ -447,89 +321,69 @@ bool TRACKS_CLEANER::deleteNullSegments()
     return removeItems( toRemove );
 }
 
-void TRACKS_CLEANER::removeDuplicatesOfTrack( const TRACK *aTrack, std::set<BOARD_ITEM*>& aToRemove )
-{
-    if( aTrack->GetFlags() & STRUCT_DELETED )
-        return;
 
-    for( auto other : m_brd->Tracks() )
-    {
-        // New netcode, break out (can't be there any other)
-        if( aTrack->GetNetCode() != other->GetNetCode() )
-            continue;
+bool TRACKS_CLEANER::removeDuplicatesOfTracks()
+{
+    std::vector<TRACK*> duplicates;
 
-        if( aTrack == other )
-            continue;
+    FindDuplicateSegments( m_brd->Tracks(), duplicates );
 
-        if( other->GetFlags() & STRUCT_DELETED )
-            continue;
+    std::set<BOARD_ITEM*> toRemove( duplicates.begin(), duplicates.end() );
 
-        // Must be of the same type, on the same layer and the endpoints
-        // must be the same (maybe swapped)
-        if( ( aTrack->Type() == other->Type() ) &&
-            ( aTrack->GetLayer() == other->GetLayer() ) )
-        {
-            if( ( ( aTrack->GetStart() == other->GetStart() ) &&
-                 ( aTrack->GetEnd() == other->GetEnd() ) ) ||
-                ( ( aTrack->GetStart() == other->GetEnd() ) &&
-                 ( aTrack->GetEnd() == other->GetStart() ) ) )
-            {
-                other->SetFlags( STRUCT_DELETED );
-                aToRemove.insert( other );
-            }
-        }
-    }
+    return removeItems( toRemove );
 }
 
 
-bool TRACKS_CLEANER::MergeCollinearTracks( TRACK* aSegment )
+bool TRACKS_CLEANER::MergeCollinearTracks( TRACK* aSegment, TRACK_ENDPOINT_INDEX<TRACK>& aIndex )
 {
     bool merged_this = false;
 
-
     for( ENDPOINT_T endpoint = ENDPOINT_START; endpoint <= ENDPOINT_END;
             endpoint = ENDPOINT_T( endpoint + 1 ) )
     {
-        // search for a possible segment connected to the current endpoint of the current one
-        TRACK* other = aSegment->Next();
+        // search for the segments connected to the current endpoint of the current one
+        TRACK* other = NULL;
+        int connected = 0;
 
-        if( other )
+        for( TRACK* candidate : aIndex.Get( aSegment->GetNetCode(),
+                                            aSegment->GetEndPoint( endpoint ) ) )
         {
-            other = aSegment->GetTrack( other, NULL, endpoint, true, false );
+            if( candidate == aSegment || candidate->GetState( BUSY | IS_DELETED ) )
+                continue;
 
-            if( other )
-            {
-                // the two segments must have the same width and the other
-                // cannot be a via
-                if( ( aSegment->GetWidth() == other->GetWidth() ) &&
-                        ( other->Type() == PCB_TRACE_T ) )
-                {
-                    // There can be only one segment connected
-                    other->SetState( BUSY, true );
-                    TRACK* yet_another = aSegment->GetTrack( m_brd->m_Track, NULL,
-                            endpoint, true, false );
-                    other->SetState( BUSY, false );
-
-                    if( !yet_another )
-                    {
-                        // Try to merge them
-                        TRACK* segDelete = mergeCollinearSegmentIfPossible( aSegment,
-                                other, endpoint );
-
-                        // Merge succesful, the other one has to go away
-                        if( segDelete )
-                        {
-                            m_brd->Remove( segDelete );
-                            m_commit.Removed( segDelete );
-                            merged_this = true;
-                        }
-                    }
-                }
-            }
+            if( ( aSegment->GetLayerSet() & candidate->GetLayerSet() ).none() )
+                continue;
+
+            other = candidate;
+            connected++;
         }
-    }
 
+        // There can be only one segment connected, with the same width,
+        // and it cannot be a via
+        if( connected != 1 || aSegment->GetWidth() != other->GetWidth()
+                || other->Type() != PCB_TRACE_T )
+            continue;
 
+        // Try to merge them
+        aIndex.Remove( aSegment );
+        aIndex.Remove( other );
+
+        TRACK* segDelete = mergeCollinearSegmentIfPossible( aSegment, other, endpoint );
+
+        aIndex.Add( aSegment );
+
+        // Merge succesful, the other one has to go away
+        if( segDelete )
+        {
+            m_brd->Remove( segDelete );
+            m_commit.Removed( segDelete );
+            merged_this = true;
+        }
+        else
+        {
+            aIndex.Add( other );
+        }
+    }
 
     return merged_this;
 }
@@ -545,29 +399,29 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     buildTrackConnectionInfo();
 
-    std::set<BOARD_ITEM*> toRemove;
-
     // Delete redundant segments, i.e. segments having the same end points and layers
     // (can happens when blocks are copied on themselve)
-    for( auto segment : m_brd->Tracks() )
-        removeDuplicatesOfTrack( segment, toRemove );
-
-    modified |= removeItems( toRemove );
+    modified |= removeDuplicatesOfTracks();
     modified = true;
 
     if( modified )
         buildTrackConnectionInfo();
 
     // merge collinear segments:
+    TRACK_ENDPOINT_INDEX<TRACK> index;
+
+    for( auto segment : m_brd->Tracks() )
+        index.Add( segment );
+
     TRACK* nextsegment;
 
-	for( TRACK* segment = m_brd->m_Track; segment; segment = nextsegment )
+    for( TRACK* segment = m_brd->m_Track; segment; segment = nextsegment )
     {
         nextsegment = segment->Next();
 
         if( segment->Type() == PCB_TRACE_T )
         {
-            bool merged_this = MergeCollinearTracks( segment );
+            bool merged_this = MergeCollinearTracks( segment, index );
 
             if( merged_this ) // The current segment was modified, retry to merge it again
             {
@@ -723,26 +577,3 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
 
     return NULL;
 }
-
-
-bool PCB_EDIT_FRAME::RemoveMisConnectedTracks()
-{
-    // Old model has to be refreshed, GAL normally does not keep updating it
-    Compile_Ratsnest( NULL, false );
-    BOARD_COMMIT commit( this );
-
-    TRACKS_CLEANER cleaner( GetBoard(), commit );
-    bool isModified = cleaner.CleanupBoard( true, false, false, false );
-
-    if( isModified )
-    {
-        // Clear undo and redo lists to avoid inconsistencies between lists
-        SetCurItem( NULL );
-        commit.Push( _( "Board cleanup" ) );
-        Compile_Ratsnest( NULL, true );
-    }
-
-    m_canvas->Refresh( true );
-
-    return isModified;
-}
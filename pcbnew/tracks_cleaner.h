@@ -0,0 +1,131 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2004-2018 Jean-Pierre Charras, jp.charras at wanadoo.fr
+ * Copyright (C) 1992-2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file tracks_cleaner.h
+ */
+
+#ifndef TRACKS_CLEANER_H
+#define TRACKS_CLEANER_H
+
+#include <set>
+
+#include <pcbnew.h>
+#include <track_buckets.h>
+
+class BOARD;
+class BOARD_ITEM;
+class COMMIT;
+class TRACK;
+class ZONE_CONTAINER;
+
+
+/**
+ * Class TRACKS_CLEANER
+ * cleans the tracks and vias of a board; the removed and modified items are staged
+ * in the given commit, which the caller pushes.
+ */
+class TRACKS_CLEANER
+{
+public:
+    TRACKS_CLEANER( BOARD* aPcb, COMMIT& aCommit );
+
+    /**
+     * the cleanup function.
+     * return true if some item was modified
+     * @param aRemoveMisConnected = true to remove segments connecting 2 different nets
+     * (short circuits)
+     * @param aCleanVias = true to remove superimposed vias
+     * @param aMergeSegments = true to merge collinear segmenst and remove 0 len segm
+     * @param aDeleteUnconnected = true to remove dangling tracks
+     */
+    bool CleanupBoard( bool aRemoveMisConnected, bool aCleanVias,
+                       bool aMergeSegments, bool aDeleteUnconnected );
+
+private:
+    /* finds and remove all track segments which are connected to more than one net.
+     * (short circuits)
+     */
+    bool removeBadTrackSegments();
+
+    /**
+     * Removes redundant vias like vias at same location
+     * or on pad through
+     */
+    bool cleanupVias();
+
+    /**
+     * Removes the items having the same end points, type, layer and net as
+     * a previous item of the track list
+     */
+    bool removeDuplicatesOfTracks();
+
+    /**
+     * Removes dangling tracks
+     */
+    bool deleteDanglingTracks();
+
+    /// Delete null length track segments
+    bool deleteNullSegments();
+
+    /**
+     * Try to merge the segment to a collinear one connected to one of its ends
+     * @param aIndex = the end points of the tracks of the board, kept up to date
+     */
+    bool MergeCollinearTracks( TRACK* aSegment, TRACK_ENDPOINT_INDEX<TRACK>& aIndex );
+
+    /**
+     * Merge collinear segments and remove duplicated and null len segments
+     */
+    bool cleanupSegments();
+
+    /**
+     * helper function
+     * Rebuild list of tracks, and connected tracks
+     * this info must be rebuilt when tracks are erased
+     */
+    void buildTrackConnectionInfo();
+
+    /**
+     * helper function
+     * merge aTrackRef and aCandidate, when possible,
+     * i.e. when they are colinear, same width, and obviously same layer
+     */
+    TRACK* mergeCollinearSegmentIfPossible( TRACK* aTrackRef,
+                                           TRACK* aCandidate, ENDPOINT_T aEndType );
+
+    const ZONE_CONTAINER* zoneForTrackEndpoint( const TRACK* aTrack,
+            ENDPOINT_T aEndPoint );
+
+    bool testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPoint );
+
+    /// Removes \a aItems from the board, return true if there was some
+    bool removeItems( std::set<BOARD_ITEM*>& aItems );
+
+    BOARD* m_brd;
+    COMMIT& m_commit;
+};
+
+
+#endif  // TRACKS_CLEANER_H
@@ -333,11 +333,13 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
 
     if( commandToUndo->GetCount() )
     {
+        /* Clear redo list, because after a new command one cannot redo a command.
+         * It is cleared first, so it does not count in the memory limit of the push
+         */
+        GetScreen()->ClearUndoORRedoList( GetScreen()->m_RedoList );
+
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
-
-        /* Clear redo list, because after a new command one cannot redo a command */
-        GetScreen()->ClearUndoORRedoList( GetScreen()->m_RedoList );
     }
     else
     {
@@ -589,29 +591,3 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         Compile_Ratsnest( NULL, false );
     }
 }
-
-
-
-
-void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount )
-{
-    if( aItemCount == 0 )
-        return;
-
-    unsigned icnt = aList.m_CommandsList.size();
-
-    if( aItemCount > 0 )
-        icnt = aItemCount;
-
-    for( unsigned ii = 0; ii < icnt; ii++ )
-    {
-        if( aList.m_CommandsList.size() == 0 )
-            break;
-
-        PICKED_ITEMS_LIST* curr_cmd = aList.m_CommandsList[0];
-        aList.m_CommandsList.erase( aList.m_CommandsList.begin() );
-
-        curr_cmd->ClearListAndDeleteItems();
-        delete curr_cmd;    // Delete command
-    }
-}
@@ -74,15 +74,24 @@ static SCENEGRAPH* vrmlToSG( VRML_LAYER& vpcb, int idxColor, SGNODE* aParent, do
 
 class LOCALESWITCH
 {
+    // Store the user locale name, to restore this locale later, in dtor
+    std::string m_locale;
+
 public:
     LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, "C" );
+        m_locale = setlocale( LC_NUMERIC, 0 );
+
+        // the locale is not switched if the caller already did it; setlocale()
+        // must not be called while other threads are loading models
+        if( m_locale != "C" )
+            setlocale( LC_NUMERIC, "C" );
     }
 
     ~LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, "" );
+        if( m_locale != "C" )
+            setlocale( LC_NUMERIC, m_locale.c_str() );
     }
 };
 
@@ -27,7 +27,9 @@
 #include <string>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <vector>
+#include <atomic>
 #include <wx/string.h>
 #include <wx/wfstream.h>
 
@@ -54,6 +56,7 @@
 #include <XCAFDoc_ColorTool.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
 
+#include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 
@@ -72,6 +75,7 @@
 #include <TDF_ChildIterator.hxx>
 
 #include "plugins/3dapi/ifsg_all.h"
+#include "plugins/3d/3d_lod.h"
 
 // log mask for wxLogTrace
 #define MASK_OCE "PLUGIN_OCE"
@@ -85,6 +89,32 @@
 // 30 deg (12 faces per circle) = 0.52359878
 #define USER_ANGLE (0.52359878)
 
+// coarse deflections of the preview level of detail, for the footprint previews
+// 45 deg (8 faces per circle) = 0.78539816
+#define PREVIEW_PREC (0.5)
+#define PREVIEW_ANGLE (0.78539816)
+
+// deflections of the fine level of detail, for the raytracer
+// 10 deg (36 faces per circle) = 0.17453293
+#define FINE_PREC (0.035)
+#define FINE_ANGLE (0.17453293)
+
+// linear and angular deflections of the mesh at each level of detail (S3D::LOD)
+static const struct
+{
+    Standard_Real linear;
+    Standard_Real angular;
+} lodDeflection[S3D::LOD_END] =
+{
+    { PREVIEW_PREC, PREVIEW_ANGLE },    // S3D::LOD_PREVIEW
+    { USER_PREC, USER_ANGLE },          // S3D::LOD_NORMAL
+    { FINE_PREC, FINE_ANGLE }           // S3D::LOD_FINE
+};
+
+// the XCAF application and the translation parameters of the readers are shared by
+// all documents; models are read one at a time, the meshing runs in parallel
+static std::mutex readLock;
+
 typedef std::map< Standard_Real, SGNODE* > COLORMAP;
 typedef std::map< std::string, SGNODE* >   FACEMAP;
 typedef std::map< std::string, std::vector< SGNODE* > > NODEMAP;
@@ -114,6 +144,8 @@ struct DATA
     FACEMAP  faces;     // SGSHAPE items representing a TopoDS_FACE
     bool renderBoth;    // set TRUE if we're processing IGES
     bool hasSolid;      // set TRUE if there is no parent SOLID
+    Standard_Real linDeflection;    // deflections of the mesh at the requested level
+    Standard_Real angDeflection;
 
     DATA()
     {
@@ -122,6 +154,8 @@ struct DATA
         refColor.SetValues( Quantity_NOC_BLACK );
         renderBoth = false;
         hasSolid = false;
+        linDeflection = USER_PREC;
+        angDeflection = USER_ANGLE;
     }
 
     ~DATA()
@@ -453,36 +487,46 @@ bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 }
 
 
-SCENEGRAPH* LoadModel( char const* filename )
+SCENEGRAPH* LoadModel( char const* filename, int aLevel )
 {
     DATA data;
-
-    Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
-    m_app->NewDocument( "MDTV-XCAF", data.m_doc );
     FormatType modelFmt = fileType( filename );
 
-    switch( modelFmt )
+    if( aLevel < 0 || aLevel >= S3D::LOD_END )
+        aLevel = S3D::LOD_NORMAL;
+
+    data.linDeflection = lodDeflection[aLevel].linear;
+    data.angDeflection = lodDeflection[aLevel].angular;
+
     {
-        case FMT_IGES:
-            data.renderBoth = true;
+        std::lock_guard<std::mutex> lock( readLock );
 
-            if( !readIGES( data.m_doc, filename ) )
-                return NULL;
-            break;
+        Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
+        m_app->NewDocument( "MDTV-XCAF", data.m_doc );
 
-        case FMT_STEP:
-            if( !readSTEP( data.m_doc, filename ) )
+        switch( modelFmt )
+        {
+            case FMT_IGES:
+                data.renderBoth = true;
+
+                if( !readIGES( data.m_doc, filename ) )
+                    return NULL;
+                break;
+
+            case FMT_STEP:
+                if( !readSTEP( data.m_doc, filename ) )
+                    return NULL;
+                break;
+
+            default:
                 return NULL;
-            break;
+                break;
+        }
 
-        default:
-            return NULL;
-            break;
+        data.m_assy = XCAFDoc_DocumentTool::ShapeTool( data.m_doc->Main() );
+        data.m_color = XCAFDoc_DocumentTool::ColorTool( data.m_doc->Main() );
     }
 
-    data.m_assy = XCAFDoc_DocumentTool::ShapeTool( data.m_doc->Main() );
-    data.m_color = XCAFDoc_DocumentTool::ColorTool( data.m_doc->Main() );
-
     // retrieve all free shapes
     TDF_LabelSequence frshapes;
     data.m_assy->GetFreeShapes( frshapes );
@@ -491,6 +535,26 @@ SCENEGRAPH* LoadModel( char const* filename )
     int id = 1;
     bool ret = false;
 
+    // mesh all the faces at once, in parallel; the faces shared by several shapes
+    // are meshed once and processFace() only meshes the faces left without a
+    // triangulation fine enough for the requested level
+    {
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound( compound );
+
+        for( int i = 1; i <= nshapes; ++i )
+        {
+            TopoDS_Shape shape = data.m_assy->GetShape( frshapes.Value( i ) );
+
+            if( !shape.IsNull() )
+                builder.Add( compound, shape );
+        }
+
+        BRepMesh_IncrementalMesh mesh( compound, data.linDeflection, Standard_False,
+                                       data.angDeflection, Standard_True );
+    }
+
     // create the top level SG node
     IFSG_TRANSFORM topNode( true );
     data.scene = topNode.GetRawPtr();
@@ -565,7 +629,7 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
 
     if( label.IsNull() )
     {
-        static int i = 0;
+        static std::atomic<int> i( 0 );
         std::ostringstream ostr;
         ostr << "KMISC_" << i++;
         partID = ostr.str();
@@ -788,12 +852,14 @@ bool processFace( const TopoDS_Face& face, DATA& data, SGNODE* parent,
     Standard_Boolean isTessellate (Standard_False);
     Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation( face, loc );
 
-    if( triangulation.IsNull() || triangulation->Deflection() > USER_PREC + Precision::Confusion() )
+    if( triangulation.IsNull()
+        || triangulation->Deflection() > data.linDeflection + Precision::Confusion() )
         isTessellate = Standard_True;
 
     if (isTessellate)
     {
-        BRepMesh_IncrementalMesh IM(face, USER_PREC, Standard_False, USER_ANGLE );
+        BRepMesh_IncrementalMesh IM( face, data.linDeflection, Standard_False,
+                                     data.angDeflection );
         triangulation = BRep_Tool::Triangulation( face, loc );
     }
 
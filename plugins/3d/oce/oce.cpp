@@ -30,11 +30,11 @@
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
 
-SCENEGRAPH* LoadModel( char const* filename );
+SCENEGRAPH* LoadModel( char const* filename, int aLevel );
 
 #define PLUGIN_OCE_MAJOR 1
-#define PLUGIN_OCE_MINOR 1
-#define PLUGIN_OCE_PATCH 1
+#define PLUGIN_OCE_MINOR 2
+#define PLUGIN_OCE_PATCH 0
 #define PLUGIN_OCE_REVNO 0
 
 
@@ -153,7 +153,20 @@ bool CanRender( void )
 }
 
 
+bool IsThreadSafe( void )
+{
+    // the document reading is serialized by LoadModel()
+    return true;
+}
+
+
 SCENEGRAPH* Load( char const* aFileName )
+{
+    return LoadLOD( aFileName, S3D::LOD_NORMAL );
+}
+
+
+SCENEGRAPH* LoadLOD( char const* aFileName, int aLevel )
 {
     if( NULL == aFileName )
         return NULL;
@@ -163,5 +176,5 @@ SCENEGRAPH* Load( char const* aFileName )
     if( !wxFileName::FileExists( fname ) )
         return NULL;
 
-    return LoadModel( aFileName );
+    return LoadModel( aFileName, aLevel );
 }
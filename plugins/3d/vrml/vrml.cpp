@@ -34,7 +34,6 @@
 #include <locale.h>
 #include <wx/log.h>
 #include <wx/filename.h>
-#include "richio.h"
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "wrlproc.h"
@@ -46,7 +45,7 @@
 #define PLUGIN_VRML_MAJOR 1
 #define PLUGIN_VRML_MINOR 3
 #define PLUGIN_VRML_PATCH 2
-#define PLUGIN_VRML_REVNO 2
+#define PLUGIN_VRML_REVNO 3
 
 
 const char* GetKicadPluginName( void )
@@ -165,36 +164,27 @@ public:
     LOCALESWITCH()
     {
         m_locale = setlocale( LC_NUMERIC, 0 );
-        setlocale( LC_NUMERIC, "C" );
+
+        // the locale is not switched if the caller already did it; setlocale()
+        // must not be called while other threads are loading models
+        if( m_locale != "C" )
+            setlocale( LC_NUMERIC, "C" );
     }
 
     ~LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, m_locale.c_str() );
+        if( m_locale != "C" )
+            setlocale( LC_NUMERIC, m_locale.c_str() );
     }
 };
 
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
 {
-    FILE_LINE_READER* modelFile = NULL;
     SCENEGRAPH* scene = NULL;
 
-    try
-    {
-        // set the max char limit to 8MB; if a VRML file contains
-        // longer lines then perhaps it shouldn't be used
-        modelFile = new FILE_LINE_READER( aFileName, 0, 8388608 );
-    }
-    catch( IO_ERROR & )
-    {
-        wxLogError( _( " * [INFO] load failed: input line too long\n" ) );
-        return NULL;
-    }
-
-
-    // VRML file processor
-    WRLPROC proc( modelFile );
+    // VRML file processor; the file is mapped in memory
+    WRLPROC proc( aFileName );
 
     if( proc.GetVRMLType() == VRML_V1 )
     {
@@ -239,9 +229,6 @@ SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
         delete bp;
     }
 
-    if( NULL != modelFile )
-        delete modelFile;
-
     // DEBUG: WRITE OUT VRML2 FILE TO CONFIRM STRUCTURE
     #if ( defined( DEBUG_VRML1 ) && DEBUG_VRML1 > 3 ) \
         || ( defined( DEBUG_VRML2 ) && DEBUG_VRML2 > 3 )
@@ -22,61 +22,65 @@
  */
 
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
+#include <boost/interprocess/file_mapping.hpp>
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
+#include "streamwrapper.h"
 #include "wrlproc.h"
 
-#define GETLINE do {\
-    try { \
-        char* cp = m_file->ReadLine(); \
-        if( NULL == cp ) { \
-            m_eof = true; \
-            m_buf.clear(); \
-        } else { \
-            m_buf = cp; \
-            m_bufpos = 0; \
-        } \
-        m_fileline = m_file->LineNumber(); \
-    } catch( ... ) { \
-        m_error = " * [INFO] input line too long"; \
-        m_eof = true; \
-        m_buf.clear(); \
-    } } while( 0 )
-
-
-WRLPROC::WRLPROC( LINE_READER* aLineReader )
+
+WRLPROC::WRLPROC( const wxString& aFileName )
 {
     m_fileVersion = VRML_INVALID;
     m_eof = false;
     m_fileline = 0;
     m_bufpos = 0;
-    m_file = aLineReader;
-
-    if( NULL == aLineReader )
-    {
-        m_eof = true;
-        return;
-    }
+    m_file = NULL;
+    m_fileEnd = NULL;
+    m_nextLine = NULL;
 
     m_error.clear();
-    wxString tname = m_file->GetSource();
-    m_filename = tname.ToUTF8();
-    wxFileName fn( tname );
+    m_filename = aFileName.ToUTF8();
+    wxFileName fn( aFileName );
 
     if( fn.IsRelative() )
         fn.Normalize();
 
     m_filedir = fn.GetPathWithSep().ToUTF8();
 
-    m_buf.clear();
-    GETLINE;
+    try
+    {
+        using namespace boost::interprocess;
 
-    if( m_eof )
+        OPEN_FILE_MAPPING( mapping, m_filename.c_str(), read_only );
+        mapped_region region( mapping, read_only );
+
+        m_region.swap( region );
+    }
+    catch( const boost::interprocess::interprocess_exception& e )
+    {
+        m_eof = true;
+
+        m_error = "could not read file: '";
+        m_error.append( m_filename );
+        m_error.append( "': " );
+        m_error.append( e.what() );
+
+        return;
+    }
+
+    m_file = (const char*) m_region.get_address();
+    m_fileEnd = m_file + m_region.get_size();
+    m_nextLine = m_file;
+
+    if( !getRawLine() )
         return;
 
-    if( m_buf.compare( 0, 16, "#VRML V1.0 ascii"  ) == 0 )
+    if( m_buf.size() >= 16 && strncmp( m_buf.data(), "#VRML V1.0 ascii", 16 ) == 0 )
     {
         m_fileVersion = VRML_V1;
         // nothing < 0x20, and no:
@@ -89,7 +93,7 @@ WRLPROC::WRLPROC( LINE_READER* aLineReader )
         return;
     }
 
-    if( m_buf.compare( 0, 15, "#VRML V2.0 utf8" ) == 0 )
+    if( m_buf.size() >= 15 && strncmp( m_buf.data(), "#VRML V2.0 utf8", 15 ) == 0 )
     {
         m_fileVersion = VRML_V2;
         // nothing < 0x20, and no:
@@ -149,29 +153,42 @@ bool WRLPROC::getRawLine( void )
     if( m_eof )
         return false;
 
-    GETLINE;
-
-    if( m_eof && m_buf.empty() )
+    if( m_nextLine == m_fileEnd )
+    {
+        m_eof = true;
         return false;
+    }
 
-    // strip the EOL characters
-    while( !m_buf.empty() && ( *m_buf.rbegin() == '\r' || *m_buf.rbegin() == '\n' ) )
-        m_buf.erase( --m_buf.end() );
+    const char* lineStart = m_nextLine;
+    const char* lineEnd = (const char*) memchr( lineStart, '\n', m_fileEnd - lineStart );
 
-    if( VRML_V1 == m_fileVersion && !m_buf.empty() )
+    if( lineEnd )
+    {
+        m_nextLine = lineEnd + 1;
+    }
+    else
     {
-        std::string::iterator sS = m_buf.begin();
-        std::string::iterator eS = m_buf.end();
+        lineEnd = m_fileEnd;
+        m_nextLine = m_fileEnd;
+    }
+
+    // strip the EOL characters
+    while( lineEnd > lineStart && '\r' == lineEnd[-1] )
+        --lineEnd;
+
+    m_buf.assign( lineStart, lineEnd - lineStart );
+    m_bufpos = 0;
+    ++m_fileline;
 
-        while( sS != eS )
+    if( VRML_V1 == m_fileVersion )
+    {
+        for( size_t i = 0; i < m_buf.size(); ++i )
         {
-            if( ((*sS) & 0x80) )
+            if( (m_buf[i] & 0x80) )
             {
                 m_error = " non-ASCII character sequence in VRML1 file";
                 return false;
             }
-
-            ++sS;
         }
     }
 
@@ -179,6 +196,86 @@ bool WRLPROC::getRawLine( void )
 }
 
 
+bool WRLPROC::readNumber( char* aNumber, size_t aMaxSize )
+{
+    if( !EatSpace() )
+        return false;
+
+    // white space is allowed before a comma separating the numbers
+    if( ',' == m_buf[m_bufpos] )
+    {
+        ++m_bufpos;
+
+        if( !EatSpace() )
+            return false;
+    }
+
+    size_t ssize = m_buf.size();
+    size_t end = m_bufpos;
+
+    while( end < ssize && m_buf[end] > 0x20 && ',' != m_buf[end]
+           && '[' != m_buf[end] && ']' != m_buf[end]
+           && '{' != m_buf[end] && '}' != m_buf[end] )
+        ++end;
+
+    size_t len = end - m_bufpos;
+
+    if( 0 == len || len >= aMaxSize )
+        return false;
+
+    memcpy( aNumber, m_buf.data() + m_bufpos, len );
+    aNumber[len] = 0;
+    m_bufpos = end;
+
+    // the comma is a special instance of blank space
+    if( m_bufpos < ssize && ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::readFloats( float* aValues, int aCount )
+{
+    // a float written with the maximum precision is less than 32 characters long
+    char number[64];
+    char* end;
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        if( !readNumber( number, sizeof( number ) ) )
+            return false;
+
+        // the "C" numeric locale is set by LoadVRML()
+        aValues[i] = strtof( number, &end );
+
+        if( end == number || *end )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool WRLPROC::readInt( int& aValue )
+{
+    char number[64];
+    char* end;
+
+    if( !readNumber( number, sizeof( number ) ) )
+        return false;
+
+    // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
+    // this instance we do no enforce case.
+    if( NULL != strstr( number, "0x" ) )
+        aValue = (int) strtol( number, &end, 16 );
+    else
+        aValue = (int) strtol( number, &end, 10 );
+
+    return end != number && !*end;
+}
+
+
 bool WRLPROC::EatSpace( void )
 {
     if( !m_file )
@@ -811,26 +908,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !readFloats( &aSFFloat, 1 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -856,6 +934,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
     }
 
     aSFInt32 = 0;
+
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
@@ -871,36 +950,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline<< ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    if( std::string::npos != tmp.find( "0x" ) )
-    {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !readInt( aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -945,41 +995,19 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
     float trot[4];
 
-    for( int i = 0; i < 4; ++i )
+    if( !readFloats( trot, 4 ) )
     {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited quartet";
-            m_error = ostr.str();
-
-            return false;
-        }
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] invalid character in space delimited quartet";
+        m_error = ostr.str();
 
+        return false;
     }
 
     aSFRotation.x = trot[0];
@@ -1017,42 +1045,19 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[2];
 
-    for( int i = 0; i < 2; ++i )
+    if( !readFloats( tcol, 2 ) )
     {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited pair";
-            m_error = ostr.str();
-
-            return false;
-        }
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] invalid character in space delimited pair";
+        m_error = ostr.str();
 
+        return false;
     }
 
     aSFVec2f.x = tcol[0];
@@ -1089,49 +1094,19 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[3];
 
-    for( int i = 0; i < 3; ++i )
+    if( !readFloats( tcol, 3 ) )
     {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited triplet";
-            m_error = ostr.str();
-
-            return false;
-        }
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] invalid character in space delimited triplet";
+        m_error = ostr.str();
 
+        return false;
     }
 
     aSFVec3f.x = tcol[0];
@@ -1548,48 +1523,35 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
 
     ++m_bufpos;
 
+    // the values of large index arrays are converted directly from the line buffer
     while( true )
     {
         if( !EatSpace() )
             return false;
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFInt( temp ) )
+        if( ',' == m_buf[m_bufpos] )
         {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
+            Pop();
+            continue;
         }
 
-        aMFInt32.push_back( temp );
+        if( ']' == m_buf[m_bufpos] )
+            break;
 
-        if( !EatSpace() )
+        if( !readInt( temp ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
+            ostr << " * [INFO] invalid character in MFInt";
             m_error = ostr.str();
 
             return false;
         }
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
+        aMFInt32.push_back( temp );
     }
 
     ++m_bufpos;
@@ -1884,51 +1846,37 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
 
     ++m_bufpos;
 
+    // the values of large coordinate arrays are converted directly from the line buffer
+    float tcol[3];
+
     while( true )
     {
         if( !EatSpace() )
             return false;
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFVec3f( lvec3f ) )
+        if( ',' == m_buf[m_bufpos] )
         {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
+            Pop();
+            continue;
         }
 
-        aMFVec3f.push_back( lvec3f );
+        if( ']' == m_buf[m_bufpos] )
+            break;
 
-        if( !EatSpace() )
+        if( !readFloats( tcol, 3 ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
+            ostr << " * [INFO] invalid character in space delimited triplet";
             m_error = ostr.str();
 
             return false;
         }
 
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
+        aMFVec3f.push_back( WRLVEC3F( tcol[0], tcol[1], tcol[2] ) );
     }
 
     ++m_bufpos;
@@ -1972,7 +1920,7 @@ std::string WRLPROC::GetFileName( void )
         return "";
     }
 
-    return std::string( m_file->GetSource().ToUTF8() );
+    return m_filename;
 }
 
 
@@ -30,18 +30,46 @@
 #ifndef WRLPROC_H
 #define WRLPROC_H
 
-#include <fstream>
 #include <string>
 #include <vector>
 
-#include "richio.h"
+#include <boost/interprocess/mapped_region.hpp>
+#include <wx/string.h>
+
 #include "wrltypes.h"
 
+// a line of the file being parsed; it points to the mapped file data
+// so the lines are not copied
+class WRLLINE
+{
+private:
+    const char* m_data;
+    size_t m_size;
+
+public:
+    WRLLINE() : m_data( NULL ), m_size( 0 ) {}
+
+    void assign( const char* aData, size_t aSize )
+    {
+        m_data = aData;
+        m_size = aSize;
+    }
+
+    char operator[]( size_t aIndex ) const { return m_data[aIndex]; }
+    const char* data( void ) const { return m_data; }
+    size_t size( void ) const { return m_size; }
+    bool empty( void ) const { return 0 == m_size; }
+    void clear( void ) { m_size = 0; }
+};
+
 class WRLPROC
 {
 private:
-    LINE_READER* m_file;
-    std::string m_buf;          // string being parsed
+    boost::interprocess::mapped_region m_region;    // the mapped file
+    const char* m_file;         // file data or NULL if no file is open
+    const char* m_fileEnd;      // end of the file data
+    const char* m_nextLine;     // start of the line following m_buf
+    WRLLINE m_buf;              // line being parsed
     bool m_eof;
     unsigned int m_fileline;
     unsigned int m_bufpos;
@@ -58,8 +86,21 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // readNumber copies the next number of the current line, which ends at white
+    // space, a comma, a bracket or a brace, to aNumber as a nul terminated string;
+    // a comma following the number is discarded. Returns false if there is no
+    // number or if it does not fit in aNumber.
+    bool readNumber( char* aNumber, size_t aMaxSize );
+
+    // readFloats and readInt are the fast paths of the single variable and array
+    // readers; they convert the numbers without copying them to a std::string.
+    // No error message is set on failure, it is up to the caller to report it.
+    bool readFloats( float* aValues, int aCount );
+    bool readInt( int& aValue );
+
 public:
-    WRLPROC( LINE_READER* aLineReader );
+    // the file is mapped in memory and parsed in place
+    WRLPROC( const wxString& aFileName );
     ~WRLPROC();
 
     bool eof( void );
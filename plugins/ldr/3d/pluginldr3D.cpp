@@ -44,6 +44,8 @@ KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_isThreadSafe = NULL;
+    m_loadLOD = NULL;
 
     return;
 }
@@ -94,6 +96,14 @@ bool KICAD_PLUGIN_LDR_3D::Open( const wxString& aFullFileName )
     LINK_ITEM( m_canRender, PLUGIN_3D_CAN_RENDER, "CanRender" );
     LINK_ITEM( m_load, PLUGIN_3D_LOAD, "Load" );
 
+    // optional function; plugins which do not export it are assumed not to be thread safe
+    if( m_PluginLoader.HasSymbol( wxT( "IsThreadSafe" ) ) )
+        LINK_ITEM( m_isThreadSafe, PLUGIN_3D_IS_THREAD_SAFE, "IsThreadSafe" );
+
+    // optional function; plugins which do not export it ignore the level of detail
+    if( m_PluginLoader.HasSymbol( wxT( "LoadLOD" ) ) )
+        LINK_ITEM( m_loadLOD, PLUGIN_3D_LOAD_LOD, "LoadLOD" );
+
     #ifdef DEBUG
         bool fail = false;
 
@@ -250,6 +260,8 @@ void KICAD_PLUGIN_LDR_3D::Close( void )
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_isThreadSafe = NULL;
+    m_loadLOD = NULL;
     close();
 
     return;
@@ -426,10 +438,53 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 }
 
 
-SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
+bool KICAD_PLUGIN_LDR_3D::IsThreadSafe( void )
+{
+    m_error.clear();
+
+    if( !ok && !reopen() )
+    {
+        if( m_error.empty() )
+            m_error = "[INFO] no open plugin / plugin could not be opened";
+
+        return false;
+    }
+
+    if( NULL == m_isThreadSafe )
+        return false;
+
+    return m_isThreadSafe();
+}
+
+
+bool KICAD_PLUGIN_LDR_3D::HasLevelsOfDetail( void )
 {
     m_error.clear();
 
+    if( !ok && !reopen() )
+    {
+        if( m_error.empty() )
+            m_error = "[INFO] no open plugin / plugin could not be opened";
+
+        return false;
+    }
+
+    return NULL != m_loadLOD;
+}
+
+
+SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName, int aLevel )
+{
+    // thread safe plugins may be loading models from several threads; the loader
+    // state is only modified when the plugin has to be reopened
+    if( ok && NULL != m_loadLOD )
+        return m_loadLOD( aFileName, aLevel );
+
+    if( ok && NULL != m_load )
+        return m_load( aFileName );
+
+    m_error.clear();
+
     if( !ok && !reopen() )
     {
         if( m_error.empty() )
@@ -452,5 +507,8 @@ SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
         return NULL;
     }
 
+    if( NULL != m_loadLOD )
+        return m_loadLOD( aFileName, aLevel );
+
     return m_load( aFileName );
 }
@@ -31,6 +31,7 @@
 #define PLUGINLDR3D_H
 
 #include "../pluginldr.h"
+#include "plugins/3d/3d_lod.h"
 
 class SCENEGRAPH;
 
@@ -47,6 +48,10 @@ typedef bool (*PLUGIN_3D_CAN_RENDER) ( void );
 
 typedef SCENEGRAPH* (*PLUGIN_3D_LOAD) ( char const* aFileName );
 
+typedef bool (*PLUGIN_3D_IS_THREAD_SAFE) ( void );
+
+typedef SCENEGRAPH* (*PLUGIN_3D_LOAD_LOD) ( char const* aFileName, int aLevel );
+
 
 class KICAD_PLUGIN_LDR_3D : public KICAD_PLUGIN_LDR
 {
@@ -58,6 +63,8 @@ private:
     PLUGIN_3D_GET_FILE_FILTER       m_getFileFilter;
     PLUGIN_3D_CAN_RENDER            m_canRender;
     PLUGIN_3D_LOAD                  m_load;
+    PLUGIN_3D_IS_THREAD_SAFE        m_isThreadSafe;    // optional
+    PLUGIN_3D_LOAD_LOD              m_loadLOD;         // optional
 
 public:
     KICAD_PLUGIN_LDR_3D();
@@ -84,7 +91,23 @@ public:
 
     bool CanRender( void );
 
-    SCENEGRAPH* Load( char const* aFileName );
+    /**
+     * returns true if the plugin Load() function may be called from several
+     * threads at once; plugins which do not export IsThreadSafe() are not
+     */
+    bool IsThreadSafe( void );
+
+    /**
+     * returns true if the plugin exports LoadLOD(), that is the models it loads
+     * depend on the level of detail
+     */
+    bool HasLevelsOfDetail( void );
+
+    /**
+     * loads a model at the level of detail aLevel (one of S3D::LOD); plugins
+     * which do not export LoadLOD() load all the levels through Load()
+     */
+    SCENEGRAPH* Load( char const* aFileName, int aLevel = S3D::LOD_NORMAL );
 };
 
 #endif  // PLUGINMGR3D_H
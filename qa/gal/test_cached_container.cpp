@@ -0,0 +1,322 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <gal/opengl/cached_container.h>
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace KIGFX;
+
+/**
+ * CACHED_CONTAINER storing vertices in the system memory, without uploading them to GPU,
+ * so it is used without an OpenGL context.
+ * Counts the full defragmentations and the time spent on them.
+ */
+class TEST_CACHED_CONTAINER : public CACHED_CONTAINER
+{
+public:
+    TEST_CACHED_CONTAINER( unsigned int aSize ) :
+        CACHED_CONTAINER( aSize ), m_defragmentations( 0 ), m_defragmentTime( 0.0 )
+    {
+        m_vertices = static_cast<VERTEX*>( malloc( aSize * VERTEX_SIZE ) );
+    }
+
+    ~TEST_CACHED_CONTAINER()
+    {
+        free( m_vertices );
+    }
+
+    void Map() override {}
+    void Unmap() override {}
+
+    bool IsMapped() const override
+    {
+        return true;
+    }
+
+    unsigned int GetBufferHandle() const override
+    {
+        return 0;
+    }
+
+    unsigned int GetUsedSpace() const
+    {
+        return usedSpace();
+    }
+
+    int     m_defragmentations;
+    double  m_defragmentTime;
+
+protected:
+    bool defragmentResize( unsigned int aNewSize ) override
+    {
+        if( usedSpace() > aNewSize )
+            return false;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        VERTEX* newBufferMem = static_cast<VERTEX*>( malloc( aNewSize * VERTEX_SIZE ) );
+
+        if( !newBufferMem )
+            return false;
+
+        defragment( newBufferMem );
+        free( m_vertices );
+        m_vertices = newBufferMem;
+
+        m_freeSpace += ( aNewSize - m_currentSize );
+        m_currentSize = aNewSize;
+        resetFreeChunks( m_currentSize - m_freeSpace, m_freeSpace );
+
+        m_defragmentTime += std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start ).count();
+        ++m_defragmentations;
+
+        return true;
+    }
+};
+
+
+struct CachedContainerFixture
+{
+    CachedContainerFixture() :
+        m_container( new TEST_CACHED_CONTAINER( 4096 ) ),
+        m_manager( m_container )
+    {
+    }
+
+    VERTEX_ITEM* addItem( unsigned int aSize )
+    {
+        // A new item is the current item of the container
+        VERTEX_ITEM* item = new VERTEX_ITEM( m_manager );
+        m_items.emplace_back( item );
+
+        // Allocate in a few steps, like a painter drawing primitives one by one
+        for( unsigned int done = 0; done < aSize; )
+        {
+            unsigned int step = std::min( aSize - done, 1u + aSize / 3 );
+            VERTEX* v = m_container->Allocate( step );
+            BOOST_REQUIRE( v != NULL );
+
+            for( unsigned int i = 0; i < step; ++i )
+                v[i].x = tag( item, done + i );
+
+            done += step;
+        }
+
+        m_manager.FinishItem();
+
+        return item;
+    }
+
+    void removeItem( unsigned int aIndex )
+    {
+        // The item is removed from the container by its destructor
+        m_items.erase( m_items.begin() + aIndex );
+    }
+
+    ///> Checks that every item still holds its own vertices and no chunks overlap
+    void checkItems()
+    {
+        std::vector<std::pair<unsigned int, unsigned int>> ranges;
+
+        for( const auto& item : m_items )
+        {
+            VERTEX* v = m_container->GetVertices( item->GetOffset() );
+
+            for( unsigned int i = 0; i < item->GetSize(); ++i )
+                BOOST_REQUIRE_EQUAL( v[i].x, tag( item.get(), i ) );
+
+            ranges.emplace_back( item->GetOffset(), item->GetSize() );
+        }
+
+        std::sort( ranges.begin(), ranges.end() );
+
+        for( size_t i = 1; i < ranges.size(); ++i )
+            BOOST_REQUIRE( ranges[i - 1].first + ranges[i - 1].second <= ranges[i].first );
+    }
+
+    static float tag( const VERTEX_ITEM* aItem, unsigned int aIndex )
+    {
+        return (float) ( ( (size_t) aItem / sizeof( void* ) + aIndex ) % 100000 );
+    }
+
+    TEST_CACHED_CONTAINER*                      m_container;    // owned by m_manager
+    VERTEX_MANAGER                              m_manager;
+    std::vector<std::unique_ptr<VERTEX_ITEM>>   m_items;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( CachedContainer, CachedContainerFixture )
+
+
+BOOST_AUTO_TEST_CASE( SizeClasses )
+{
+    BOOST_CHECK_EQUAL( CACHED_CONTAINER::GetSizeClass( 0 ), 0u );
+    BOOST_CHECK_EQUAL( CACHED_CONTAINER::GetSizeClass( 1 ), 8u );
+    BOOST_CHECK_EQUAL( CACHED_CONTAINER::GetSizeClass( 9 ), 9u );
+    BOOST_CHECK_EQUAL( CACHED_CONTAINER::GetSizeClass( 17 ), 18u );
+    BOOST_CHECK_EQUAL( CACHED_CONTAINER::GetSizeClass( 1000 ), 1024u );
+
+    for( unsigned int size = 1; size < 100000; size += 7 )
+    {
+        unsigned int sizeClass = CACHED_CONTAINER::GetSizeClass( size );
+        BOOST_CHECK( sizeClass >= size );
+        BOOST_CHECK( sizeClass <= std::max( 8u, size + size / 8 ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( FreeChunksMerge )
+{
+    for( int i = 0; i < 4; ++i )
+        addItem( 100 );
+
+    // Remove the two middle items, the freed chunks have to become a single hole
+    removeItem( 1 );
+    removeItem( 1 );
+
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 2u );
+    checkItems();
+
+    m_container->Compact( 1000000 );
+
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 1u );
+    BOOST_CHECK_EQUAL( m_container->GetFragmentation(), 0.0 );
+    checkItems();
+}
+
+
+/**
+ * Scripted churn: items are repeatedly added and removed, like while editing a board.
+ * Reports fragmentation and compares incremental compaction with full defragmentation.
+ */
+BOOST_AUTO_TEST_CASE( ChurnWorkload )
+{
+    const unsigned int budget = 4096;
+    std::mt19937 rng( 1 );
+    std::uniform_int_distribution<unsigned int> sizeDist( 6, 600 );
+
+    for( int i = 0; i < 2000; ++i )
+        addItem( sizeDist( rng ) );
+
+    double maxFragmentation = 0.0;
+    double compactTime = 0.0;
+    int compactSteps = 0;
+    bool compacting = false;
+
+    for( int round = 0; round < 200; ++round )
+    {
+        for( int i = 0; i < 50; ++i )
+        {
+            std::uniform_int_distribution<unsigned int> indexDist( 0, m_items.size() - 1 );
+            removeItem( indexDist( rng ) );
+        }
+
+        for( int i = 0; i < 50; ++i )
+            addItem( sizeDist( rng ) );
+
+        maxFragmentation = std::max( maxFragmentation, m_container->GetFragmentation() );
+
+        // The same policy as VERTEX_MANAGER::Unmap(), but with a lower threshold so the
+        // compaction runs during most of the workload
+        if( compacting || m_container->GetFragmentation() > 0.05 )
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            compacting = m_container->Compact( budget );
+            compactTime += std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start ).count();
+            ++compactSteps;
+        }
+
+        checkItems();
+    }
+
+    BOOST_TEST_MESSAGE( "Max fragmentation: " << maxFragmentation );
+    BOOST_TEST_MESSAGE( "Compaction: " << compactSteps << " steps, "
+                        << m_container->GetCompactedVertices() << " vertices moved, "
+                        << compactTime << " ms" );
+    BOOST_TEST_MESSAGE( "Full defragmentation: " << m_container->m_defragmentations
+                        << " times, " << m_container->m_defragmentTime << " ms" );
+
+    // The compacted data must fit in the container without waiting for a full defragmentation
+    while( m_container->Compact( budget ) )
+        ;
+
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 1u );
+    checkItems();
+}
+
+
+/**
+ * VERTEX_MANAGER::Unmap() compacts the container only once it is fragmented enough
+ */
+BOOST_AUTO_TEST_CASE( UnmapCompacts )
+{
+    for( int i = 0; i < 30; ++i )
+        addItem( 100 );
+
+    // A single hole: not worth moving the vertices
+    removeItem( 0 );
+    m_manager.Unmap();
+
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 2u );
+
+    // Holes everywhere: most of the free space is not usable for large items
+    for( int i = 0; i < 14; ++i )
+        removeItem( i );
+
+    BOOST_REQUIRE( m_container->GetFragmentation() > 0.5 );
+
+    m_manager.Unmap();
+
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 1u );
+    checkItems();
+}
+
+
+BOOST_AUTO_TEST_CASE( ClearContainer )
+{
+    for( int i = 0; i < 10; ++i )
+        addItem( 50 );
+
+    m_container->Clear();
+
+    for( const auto& item : m_items )
+        BOOST_CHECK_EQUAL( item->GetSize(), 0u );
+
+    BOOST_CHECK_EQUAL( m_container->GetUsedSpace(), 0u );
+    BOOST_CHECK_EQUAL( m_container->GetFreeChunkCount(), 1u );
+
+    m_items.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
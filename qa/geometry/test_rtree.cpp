@@ -0,0 +1,219 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <vector>
+
+// The same tree parameters as VIEW_RTREE
+typedef RTree<int*, int, 2, float> TEST_RTREE;
+
+struct RTreeFixture
+{
+    /**
+     * Generates aCount items distributed over a board-like area: mostly small items
+     * (pads, vias, track segments) and a few large ones (zones, board outline).
+     */
+    void generate( size_t aCount )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_int_distribution<int> posDist( 0, 300000000 );
+        std::uniform_int_distribution<int> smallDist( 100000, 5000000 );
+        std::uniform_int_distribution<int> largeDist( 10000000, 100000000 );
+
+        m_data.resize( aCount );
+        m_entries.resize( aCount );
+
+        for( size_t i = 0; i < aCount; ++i )
+        {
+            TEST_RTREE::BulkEntry& entry = m_entries[i];
+            bool large = ( i % 1000 ) == 0;
+
+            entry.m_min[0] = posDist( rng );
+            entry.m_min[1] = posDist( rng );
+            entry.m_max[0] = entry.m_min[0] + ( large ? largeDist( rng ) : smallDist( rng ) );
+            entry.m_max[1] = entry.m_min[1] + ( large ? largeDist( rng ) : smallDist( rng ) );
+            entry.m_data = &m_data[i];
+        }
+    }
+
+    void insertAll( TEST_RTREE& aTree )
+    {
+        for( const auto& entry : m_entries )
+            aTree.Insert( entry.m_min, entry.m_max, entry.m_data );
+    }
+
+    ///> Returns the sorted list of items found in the area
+    std::vector<int*> query( TEST_RTREE& aTree, const int aMin[2], const int aMax[2] )
+    {
+        std::vector<int*> result;
+
+        auto visitor = [&result]( int* aItem ) -> bool
+        {
+            result.push_back( aItem );
+            return true;
+        };
+
+        aTree.Search( aMin, aMax, visitor );
+        std::sort( result.begin(), result.end() );
+
+        return result;
+    }
+
+    ///> Runs a series of viewport-like queries, returns the total number of hits
+    size_t queryViewports( TEST_RTREE& aTree, int aCount )
+    {
+        std::mt19937 rng( 2 );
+        std::uniform_int_distribution<int> posDist( 0, 250000000 );
+        size_t hits = 0;
+
+        auto visitor = [&hits]( int* ) -> bool
+        {
+            ++hits;
+            return true;
+        };
+
+        for( int i = 0; i < aCount; ++i )
+        {
+            int mmin[2] = { posDist( rng ), posDist( rng ) };
+            int mmax[2] = { mmin[0] + 30000000, mmin[1] + 20000000 };
+            aTree.Search( mmin, mmax, visitor );
+        }
+
+        return hits;
+    }
+
+    static double elapsed( std::chrono::high_resolution_clock::time_point aStart )
+    {
+        return std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - aStart ).count();
+    }
+
+    std::vector<int> m_data;
+    std::vector<TEST_RTREE::BulkEntry> m_entries;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( RTreeBulkLoad, RTreeFixture )
+
+
+BOOST_AUTO_TEST_CASE( BulkLoadMatchesInsert )
+{
+    generate( 20000 );
+
+    TEST_RTREE inserted, packed;
+    insertAll( inserted );
+    packed.BulkLoad( m_entries );
+
+    BOOST_CHECK_EQUAL( packed.Count(), (int) m_entries.size() );
+
+    std::mt19937 rng( 3 );
+    std::uniform_int_distribution<int> posDist( 0, 300000000 );
+
+    for( int i = 0; i < 200; ++i )
+    {
+        int mmin[2] = { posDist( rng ), posDist( rng ) };
+        int mmax[2] = { mmin[0] + 20000000, mmin[1] + 20000000 };
+
+        auto expected = query( inserted, mmin, mmax );
+        auto found = query( packed, mmin, mmax );
+
+        BOOST_REQUIRE( expected == found );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ModifyAfterBulkLoad )
+{
+    generate( 5000 );
+
+    TEST_RTREE tree;
+    tree.BulkLoad( m_entries );
+
+    // Remove every other item and insert it back, the packed nodes get split and freed
+    for( size_t i = 0; i < m_entries.size(); i += 2 )
+        BOOST_CHECK( !tree.Remove( m_entries[i].m_min, m_entries[i].m_max, m_entries[i].m_data ) );
+
+    BOOST_CHECK_EQUAL( tree.Count(), (int) m_entries.size() / 2 );
+
+    for( size_t i = 0; i < m_entries.size(); i += 2 )
+        tree.Insert( m_entries[i].m_min, m_entries[i].m_max, m_entries[i].m_data );
+
+    BOOST_CHECK_EQUAL( tree.Count(), (int) m_entries.size() );
+
+    const int mmin[2] = { INT_MIN, INT_MIN };
+    const int mmax[2] = { INT_MAX, INT_MAX };
+    BOOST_CHECK_EQUAL( query( tree, mmin, mmax ).size(), m_entries.size() );
+
+    // Bulk loading a modified tree replaces its contents
+    tree.BulkLoad( std::vector<TEST_RTREE::BulkEntry>() );
+    BOOST_CHECK_EQUAL( tree.Count(), 0 );
+
+    tree.Insert( m_entries[0].m_min, m_entries[0].m_max, m_entries[0].m_data );
+    BOOST_CHECK_EQUAL( tree.Count(), 1 );
+}
+
+
+/**
+ * Compares building the tree by inserting items one by one with bulk loading,
+ * and the query time of the resulting trees, for a large board.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    const int queryCount = 2000;
+
+    generate( 500000 );
+
+    auto start = std::chrono::high_resolution_clock::now();
+    TEST_RTREE inserted;
+    insertAll( inserted );
+    double insertTime = elapsed( start );
+
+    start = std::chrono::high_resolution_clock::now();
+    TEST_RTREE packed;
+    packed.BulkLoad( m_entries );
+    double bulkLoadTime = elapsed( start );
+
+    start = std::chrono::high_resolution_clock::now();
+    size_t insertedHits = queryViewports( inserted, queryCount );
+    double insertedQueryTime = elapsed( start );
+
+    start = std::chrono::high_resolution_clock::now();
+    size_t packedHits = queryViewports( packed, queryCount );
+    double packedQueryTime = elapsed( start );
+
+    BOOST_CHECK_EQUAL( insertedHits, packedHits );
+
+    BOOST_TEST_MESSAGE( "Build of " << m_entries.size() << " items: insert " << insertTime
+                        << " ms, bulk load " << bulkLoadTime << " ms" );
+    BOOST_TEST_MESSAGE( queryCount << " queries: inserted tree " << insertedQueryTime
+                        << " ms, packed tree " << packedQueryTime << " ms" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,372 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Compares the copper Gerber files plotted from a board with the copper of the
+ * board itself, and reports the area and the location of the differences.
+ *
+ * The board layers are converted to polygons by BOARD::ConvertBrdLayerToPolygonalContours(),
+ * the Gerber files by GERBER_POLYGON_READER, then each layer is compared by boolean
+ * operations, on a pool of threads. The differences thinner than the tolerance (the
+ * approximation of arcs and circles) are ignored.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_line_chain.h>
+
+#include <common.h>
+#include <convert_to_biu.h>
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+
+#include <class_board.h>
+
+#include "gerber_polygon_reader.h"
+
+
+// Number of differences listed for each layer
+static const size_t MAX_LISTED_DIFFS = 10;
+
+
+enum RET_CODES
+{
+    NO_DIFFERENCES = 0,
+    DIFFERENCES = 1,
+    ERRORS = 2,
+};
+
+
+struct DIFFERENCE
+{
+    wxPoint m_Position;
+    double  m_Area;        ///< in mm2
+};
+
+
+struct LAYER_COMPARISON
+{
+    PCB_LAYER_ID            m_Layer;
+    wxString                m_File;
+    SHAPE_POLY_SET          m_Board;
+    wxString                m_Error;
+    double                  m_MissingArea;  ///< in mm2, on the board but not in the file
+    double                  m_ExtraArea;    ///< in mm2, in the file but not on the board
+    std::vector<DIFFERENCE> m_Diffs;
+};
+
+
+static BOARD* loadBoard( const wxString& aFileName )
+{
+    PLUGIN::RELEASER pi( new PCB_IO );
+    BOARD* brd = nullptr;
+
+    try
+    {
+        brd = pi->Load( aFileName, NULL, NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "Error loading board.\n%s\n", (const char*) ioe.Problem().mb_str() );
+        return nullptr;
+    }
+
+    return brd;
+}
+
+
+/**
+ * @return the copper layer of a Gerber file from its .FileFunction attribute
+ * (like "Copper,L2,Inr"), or UNDEFINED_LAYER
+ */
+static PCB_LAYER_ID copperLayerFromFileFunction( const wxArrayString& aFunction,
+                                                 int aCopperCount )
+{
+    long index;
+
+    if( aFunction.GetCount() < 2 || aFunction[0] != "Copper"
+        || !aFunction[1].StartsWith( "L" ) || !aFunction[1].Mid( 1 ).ToLong( &index ) )
+    {
+        return UNDEFINED_LAYER;
+    }
+
+    if( index == 1 )
+        return F_Cu;
+
+    if( index == aCopperCount )
+        return B_Cu;
+
+    if( index < 1 || index > aCopperCount )
+        return UNDEFINED_LAYER;
+
+    return ToLAYER_ID( In1_Cu + index - 2 );
+}
+
+
+static double areaMm2( const SHAPE_LINE_CHAIN& aChain )
+{
+    return std::fabs( aChain.Area() ) / ( IU_PER_MM * IU_PER_MM );
+}
+
+
+/**
+ * Removes from \a aPolys the parts thinner than 2 * \a aTolerance, and appends
+ * the remaining areas to \a aDiffs.
+ * @return the remaining area, in mm2
+ */
+static double keepDifferences( SHAPE_POLY_SET& aPolys, int aTolerance,
+                               std::vector<DIFFERENCE>& aDiffs )
+{
+    if( aTolerance > 0 )
+    {
+        aPolys.Inflate( -aTolerance, 16 );
+        aPolys.Inflate( aTolerance, 16 );
+    }
+
+    double total = 0.0;
+
+    for( int ii = 0; ii < aPolys.OutlineCount(); ++ii )
+    {
+        double area = areaMm2( aPolys.COutline( ii ) );
+
+        for( int jj = 0; jj < aPolys.HoleCount( ii ); ++jj )
+            area -= areaMm2( aPolys.CHole( ii, jj ) );
+
+        aDiffs.push_back( { (wxPoint) aPolys.COutline( ii ).BBox().Centre(), area } );
+        total += area;
+    }
+
+    return total;
+}
+
+
+static void compareLayer( LAYER_COMPARISON& aComparison, const wxPoint& aOffset,
+                          int aTolerance )
+{
+    GERBER_POLYGON_READER reader;
+
+    reader.SetOffset( aOffset );
+
+    if( !reader.Load( aComparison.m_File ) )
+    {
+        aComparison.m_Error = reader.GetError();
+        return;
+    }
+
+    SHAPE_POLY_SET missing = aComparison.m_Board;
+    SHAPE_POLY_SET extra = reader.GetImage();
+
+    missing.BooleanSubtract( reader.GetImage(), SHAPE_POLY_SET::PM_FAST );
+    extra.BooleanSubtract( aComparison.m_Board, SHAPE_POLY_SET::PM_FAST );
+
+    aComparison.m_MissingArea = keepDifferences( missing, aTolerance, aComparison.m_Diffs );
+    aComparison.m_ExtraArea = keepDifferences( extra, aTolerance, aComparison.m_Diffs );
+
+    std::sort( aComparison.m_Diffs.begin(), aComparison.m_Diffs.end(),
+               []( const DIFFERENCE& a, const DIFFERENCE& b )
+               {
+                   return a.m_Area > b.m_Area;
+               } );
+}
+
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 3 )
+    {
+        printf( "A tool comparing the copper Gerber files plotted from a board with the board.\n" );
+        printf( "usage : %s board_file.kicad_pcb [--tolerance mm] [-j threads] "
+                "[LAYER=]gerber_file...\n\n", argv[0] );
+        printf( "The layer of a file is given by its FileFunction attribute, or by LAYER "
+                "(like B.Cu=board-B_Cu.gbr).\n" );
+        printf( "All the copper layers of the board must be given.\n" );
+        printf( "Default tolerance: 0.025 mm\n" );
+        return ERRORS;
+    }
+
+    std::unique_ptr<BOARD> brd( loadBoard( argv[1] ) );
+
+    if( !brd )
+        return ERRORS;
+
+    double tolerance = 0.025;
+    unsigned long threadCount = 0;
+    std::vector<LAYER_COMPARISON> comparisons;
+    int result = NO_DIFFERENCES;
+
+    // Parse the numbers and the files in the C locale
+    LOCALE_IO toggle;
+
+    for( int ii = 2; ii < argc; ++ii )
+    {
+        wxString arg( argv[ii] );
+
+        if( arg == "--tolerance" && ii + 1 < argc )
+        {
+            wxString( argv[++ii] ).ToCDouble( &tolerance );
+            continue;
+        }
+
+        if( arg == "-j" && ii + 1 < argc )
+        {
+            wxString( argv[++ii] ).ToULong( &threadCount );
+            continue;
+        }
+
+        LAYER_COMPARISON comparison;
+
+        comparison.m_Layer = UNDEFINED_LAYER;
+        comparison.m_File = arg;
+        comparison.m_MissingArea = 0.0;
+        comparison.m_ExtraArea = 0.0;
+
+        if( arg.Contains( "=" ) )
+        {
+            comparison.m_Layer = brd->GetLayerID( arg.BeforeFirst( '=' ) );
+            comparison.m_File = arg.AfterFirst( '=' );
+        }
+        else
+        {
+            // The layer is given by the attributes of the file. The file is read again,
+            // with the right offset, by compareLayer()
+            GERBER_POLYGON_READER reader;
+
+            if( !reader.Load( comparison.m_File ) )
+            {
+                printf( "%s: error: %s\n", (const char*) arg.mb_str(),
+                        (const char*) reader.GetError().mb_str() );
+                result = ERRORS;
+                continue;
+            }
+
+            comparison.m_Layer = copperLayerFromFileFunction( reader.GetFileFunction(),
+                                                              brd->GetCopperLayerCount() );
+        }
+
+        if( !IsCopperLayer( comparison.m_Layer ) )
+        {
+            printf( "%s: not a copper layer, skipped\n", (const char*) arg.mb_str() );
+            continue;
+        }
+
+        comparisons.push_back( comparison );
+    }
+
+    // A copper layer without file is not checked: it is an error, not a missing difference
+    for( PCB_LAYER_ID layer : brd->GetEnabledLayers().CuStack() )
+    {
+        auto covers = [layer]( const LAYER_COMPARISON& aComparison )
+        {
+            return aComparison.m_Layer == layer;
+        };
+
+        if( std::none_of( comparisons.begin(), comparisons.end(), covers ) )
+        {
+            printf( "%s: no Gerber file\n", (const char*) brd->GetLayerName( layer ).mb_str() );
+            result = ERRORS;
+        }
+    }
+
+    if( comparisons.empty() )
+        return ERRORS;
+
+    wxPoint offset;
+
+    if( brd->GetPlotOptions().GetUseAuxOrigin() )
+        offset = brd->GetAuxOrigin();
+
+    // The board items share some static data to build their polygons (texts):
+    // convert the layers one after the other, before the comparisons
+    for( LAYER_COMPARISON& comparison : comparisons )
+    {
+        brd->ConvertBrdLayerToPolygonalContours( comparison.m_Layer, comparison.m_Board );
+        MergeOutlines( comparison.m_Board );
+    }
+
+    if( threadCount == 0 )
+        threadCount = std::thread::hardware_concurrency();
+
+    threadCount = std::max( std::min( (size_t) threadCount, comparisons.size() ), (size_t) 1 );
+
+    int toleranceIU = Millimeter2iu( tolerance );
+    std::atomic<size_t> nextLayer( 0 );
+    std::vector<std::thread> workers;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+    {
+        workers.push_back( std::thread( [&]()
+        {
+            for( size_t i = nextLayer.fetch_add( 1 ); i < comparisons.size();
+                    i = nextLayer.fetch_add( 1 ) )
+            {
+                compareLayer( comparisons[i], offset, toleranceIU );
+            }
+        } ) );
+    }
+
+    for( auto& worker : workers )
+        worker.join();
+
+    for( const LAYER_COMPARISON& comparison : comparisons )
+    {
+        printf( "%s (%s): ", (const char*) brd->GetLayerName( comparison.m_Layer ).mb_str(),
+                (const char*) comparison.m_File.mb_str() );
+
+        if( !comparison.m_Error.IsEmpty() )
+        {
+            printf( "error: %s\n", (const char*) comparison.m_Error.mb_str() );
+            result = ERRORS;
+            continue;
+        }
+
+        if( comparison.m_Diffs.empty() )
+        {
+            printf( "identical\n" );
+            continue;
+        }
+
+        printf( "%d differences, xor area %.4f mm2 (missing %.4f mm2, extra %.4f mm2)\n",
+                (int) comparison.m_Diffs.size(),
+                comparison.m_MissingArea + comparison.m_ExtraArea,
+                comparison.m_MissingArea, comparison.m_ExtraArea );
+
+        for( size_t ii = 0; ii < comparison.m_Diffs.size() && ii < MAX_LISTED_DIFFS; ++ii )
+        {
+            const DIFFERENCE& diff = comparison.m_Diffs[ii];
+
+            printf( "    at (%.4f, %.4f) mm: %.4f mm2\n",
+                    diff.m_Position.x / IU_PER_MM, diff.m_Position.y / IU_PER_MM,
+                    diff.m_Area );
+        }
+
+        if( result == NO_DIFFERENCES )
+            result = DIFFERENCES;
+    }
+
+    return result;
+}
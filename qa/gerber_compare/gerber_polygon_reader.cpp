@@ -0,0 +1,708 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <convert_basic_shapes_to_polygon.h>
+
+#include "gerber_polygon_reader.h"
+
+
+// Number of segments to approximate a circle (flashes, round ends and arcs)
+static const int CIRCLE_SEGMENTS = 64;
+
+
+void MergeOutlines( SHAPE_POLY_SET& aPolys )
+{
+    for( int ii = 0; ii < aPolys.OutlineCount(); ++ii )
+    {
+        SHAPE_LINE_CHAIN& outline = aPolys.Outline( ii );
+
+        if( outline.Area() < 0 )
+            outline = outline.Reverse();
+    }
+
+    aPolys.Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
+GERBER_POLYGON_READER::GERBER_POLYGON_READER() :
+    m_omitTrailingZeros( false ),
+    m_intDigits( 3 ),
+    m_decDigits( 4 ),
+    m_unitToMm( 25.4 ),
+    m_aperture( NULL ),
+    m_interpolation( 1 ),
+    m_multiQuadrant( false ),
+    m_regionMode( false ),
+    m_lastDCode( 2 ),
+    m_clearPolarity( false )
+{
+}
+
+
+bool GERBER_POLYGON_READER::Load( const wxString& aFileName )
+{
+    FILE* file = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !file )
+    {
+        m_error.Printf( "cannot open \"%s\"", GetChars( aFileName ) );
+        return false;
+    }
+
+    std::string text;
+    char buffer[65536];
+    size_t count;
+
+    while( ( count = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+        text.append( buffer, count );
+
+    fclose( file );
+
+    // Split the file in extended commands (%...%, made of one or more '*' terminated
+    // words) and data blocks ('*' terminated). Line ends are not significant.
+    size_t pos = 0;
+
+    while( pos < text.size() )
+    {
+        char c = text[pos];
+
+        if( isspace( (unsigned char) c ) )
+        {
+            pos++;
+            continue;
+        }
+
+        if( c == '%' )
+        {
+            size_t end = text.find( '%', pos + 1 );
+
+            if( end == std::string::npos )
+                end = text.size();
+
+            std::string word;
+            bool macro = false;
+
+            for( size_t ii = pos + 1; ii < end; ++ii )
+            {
+                if( text[ii] == '*' )
+                {
+                    // The words of an aperture macro are its primitives
+                    if( !macro && !word.empty() && !parseExtendedCommand( word ) )
+                        return false;
+
+                    macro = macro || word.compare( 0, 2, "AM" ) == 0;
+                    word.clear();
+                }
+                else if( text[ii] != '\n' && text[ii] != '\r' )
+                {
+                    word += text[ii];
+                }
+            }
+
+            pos = end + 1;
+            continue;
+        }
+
+        size_t end = text.find( '*', pos );
+
+        if( end == std::string::npos )
+            end = text.size();
+
+        std::string block;
+
+        for( size_t ii = pos; ii < end; ++ii )
+        {
+            if( text[ii] != '\n' && text[ii] != '\r' )
+                block += text[ii];
+        }
+
+        if( !parseDataBlock( block ) )
+            return false;
+
+        pos = end + 1;
+    }
+
+    if( m_regionMode )
+        closeContour();
+
+    flushPolarity();
+
+    return true;
+}
+
+
+bool GERBER_POLYGON_READER::parseExtendedCommand( const std::string& aCommand )
+{
+    const char* text = aCommand.c_str();
+
+    if( aCommand.compare( 0, 2, "FS" ) == 0 )
+    {
+        // Like FSLAX46Y46: zero omission, absolute notation, digits of X and Y
+        m_omitTrailingZeros = text[2] == 'T';
+
+        if( text[3] == 'I' )
+        {
+            m_error = "incremental coordinates are not supported";
+            return false;
+        }
+
+        const char* x = strchr( text, 'X' );
+
+        if( !x || !isdigit( (unsigned char) x[1] ) || !isdigit( (unsigned char) x[2] ) )
+        {
+            m_error.Printf( "invalid format command \"%s\"", aCommand.c_str() );
+            return false;
+        }
+
+        m_intDigits = x[1] - '0';
+        m_decDigits = x[2] - '0';
+    }
+    else if( aCommand == "MOMM" )
+    {
+        m_unitToMm = 1.0;
+    }
+    else if( aCommand == "MOIN" )
+    {
+        m_unitToMm = 25.4;
+    }
+    else if( aCommand.compare( 0, 3, "ADD" ) == 0 )
+    {
+        // Like ADD10C,0.1 or ADD11R,1.5X0.8
+        char* next;
+        int dcode = strtol( text + 3, &next, 10 );
+        std::string name;
+
+        while( *next && *next != ',' )
+            name += *next++;
+
+        APERTURE aperture;
+
+        if( name.size() != 1 || !strchr( "CROP", name[0] ) )
+        {
+            m_error.Printf( "aperture D%d: aperture macros (%s) are not supported",
+                            dcode, name.c_str() );
+            return false;
+        }
+
+        aperture.m_Type = name[0];
+
+        while( *next == ',' || *next == 'X' )
+            aperture.m_Params.push_back( strtod( next + 1, &next ) * m_unitToMm );
+
+        if( aperture.m_Params.empty()
+            || ( aperture.m_Type != 'C' && aperture.m_Params.size() < 2 ) )
+        {
+            m_error.Printf( "invalid aperture definition \"%s\"", aCommand.c_str() );
+            return false;
+        }
+
+        m_apertures[dcode] = aperture;
+    }
+    else if( aCommand == "LPD" || aCommand == "LPC" )
+    {
+        bool clear = aCommand == "LPC";
+
+        if( clear != m_clearPolarity )
+        {
+            flushPolarity();
+            m_clearPolarity = clear;
+        }
+    }
+    else if( aCommand.compare( 0, 2, "SR" ) == 0 )
+    {
+        // A SR command without parameters closes the step and repeat block
+        if( aCommand.size() > 2 )
+        {
+            m_error = "step and repeat is not supported";
+            return false;
+        }
+    }
+    else if( aCommand.compare( 0, 15, "TF.FileFunction" ) == 0 )
+    {
+        parseFileFunction( aCommand );
+    }
+
+    // Other commands (attributes, image name...) do not change the image
+    return true;
+}
+
+
+void GERBER_POLYGON_READER::parseFileFunction( const std::string& aAttribute )
+{
+    // Like TF.FileFunction,Copper,L1,Top
+    m_fileFunction.Clear();
+
+    wxArrayString params = wxSplit( wxString::FromUTF8( aAttribute.c_str() ), ',' );
+
+    for( size_t ii = 1; ii < params.GetCount(); ++ii )
+        m_fileFunction.Add( params[ii] );
+}
+
+
+bool GERBER_POLYGON_READER::parseCoordinate( const char*& aText, double& aValue )
+{
+    const char* start = aText;
+    bool negative = false;
+
+    if( *aText == '+' || *aText == '-' )
+        negative = *aText++ == '-';
+
+    long long value = 0;
+    int digits = 0;
+
+    while( isdigit( (unsigned char) *aText ) )
+    {
+        value = value * 10 + ( *aText++ - '0' );
+        digits++;
+    }
+
+    if( digits == 0 )
+    {
+        m_error.Printf( "invalid coordinate \"%s\"", start );
+        return false;
+    }
+
+    double coord = (double) value;
+
+    // With trailing zeros omitted, the digits are the most significant ones
+    if( m_omitTrailingZeros )
+        coord *= pow( 10.0, m_intDigits + m_decDigits - digits );
+
+    coord /= pow( 10.0, m_decDigits );
+    aValue = ( negative ? -coord : coord ) * m_unitToMm;
+
+    return true;
+}
+
+
+bool GERBER_POLYGON_READER::parseDataBlock( const std::string& aBlock )
+{
+    if( aBlock.compare( 0, 3, "G04" ) == 0 )
+    {
+        // Comment, maybe holding a X1 structured attribute
+        size_t attr = aBlock.find( "#@! TF.FileFunction" );
+
+        if( attr != std::string::npos )
+            parseFileFunction( aBlock.substr( attr + 4 ) );
+
+        return true;
+    }
+
+    const char* text = aBlock.c_str();
+    DPOINT target = m_position;
+    DPOINT centerOffset( 0.0, 0.0 );
+    bool hasCoordinate = false;
+    int dcode = 0;
+
+    while( *text )
+    {
+        char letter = *text++;
+        char* next;
+
+        switch( letter )
+        {
+        case 'G':
+        {
+            int gcode = strtol( text, &next, 10 );
+            text = next;
+
+            switch( gcode )
+            {
+            case 1:
+            case 2:
+            case 3:
+                m_interpolation = gcode;
+                break;
+
+            case 36:
+                m_regionMode = true;
+                m_contour.clear();
+                break;
+
+            case 37:
+                closeContour();
+                m_regionMode = false;
+                break;
+
+            case 70:
+                m_unitToMm = 25.4;
+                break;
+
+            case 71:
+                m_unitToMm = 1.0;
+                break;
+
+            case 74:
+                m_multiQuadrant = false;
+                break;
+
+            case 75:
+                m_multiQuadrant = true;
+                break;
+
+            case 91:
+                m_error = "incremental coordinates are not supported";
+                return false;
+
+            default:    // G54 (select aperture), G90 (absolute)...
+                break;
+            }
+
+            break;
+        }
+
+        case 'X':
+        case 'Y':
+        case 'I':
+        case 'J':
+        {
+            double value;
+
+            if( !parseCoordinate( text, value ) )
+                return false;
+
+            if( letter == 'X' )
+                target.x = value;
+            else if( letter == 'Y' )
+                target.y = value;
+            else if( letter == 'I' )
+                centerOffset.x = value;
+            else
+                centerOffset.y = value;
+
+            hasCoordinate = true;
+            break;
+        }
+
+        case 'D':
+            dcode = strtol( text, &next, 10 );
+            text = next;
+            break;
+
+        case 'M':       // M02: end of file
+            return true;
+
+        default:
+            m_error.Printf( "unexpected block \"%s\"", aBlock.c_str() );
+            return false;
+        }
+    }
+
+    if( dcode >= 10 )
+    {
+        auto aperture = m_apertures.find( dcode );
+
+        if( aperture == m_apertures.end() )
+        {
+            m_error.Printf( "aperture D%d is not defined", dcode );
+            return false;
+        }
+
+        m_aperture = &aperture->second;
+        return true;
+    }
+
+    // A coordinate without operation code uses the previous one (deprecated)
+    if( dcode == 0 && hasCoordinate )
+        dcode = m_lastDCode;
+
+    if( dcode == 0 )
+        return true;
+
+    m_lastDCode = dcode;
+
+    return execute( dcode, target, centerOffset );
+}
+
+
+bool GERBER_POLYGON_READER::execute( int aDCode, const DPOINT& aTarget,
+                                     const DPOINT& aCenterOffset )
+{
+    switch( aDCode )
+    {
+    case 1:     // Interpolate
+    {
+        std::vector<DPOINT> points;
+
+        if( !interpolate( aTarget, aCenterOffset, points ) )
+            return false;
+
+        if( m_regionMode )
+        {
+            if( m_contour.empty() )
+                m_contour.push_back( m_position );
+
+            m_contour.insert( m_contour.end(), points.begin() + 1, points.end() );
+        }
+        else if( !stroke( points ) )
+        {
+            return false;
+        }
+
+        break;
+    }
+
+    case 2:     // Move
+        if( m_regionMode )
+            closeContour();
+
+        break;
+
+    case 3:     // Flash
+        if( m_regionMode )
+        {
+            m_error = "flash in a region";
+            return false;
+        }
+
+        if( !flash( aTarget ) )
+            return false;
+
+        break;
+
+    default:
+        m_error.Printf( "invalid operation D%02d", aDCode );
+        return false;
+    }
+
+    m_position = aTarget;
+
+    return true;
+}
+
+
+bool GERBER_POLYGON_READER::interpolate( const DPOINT& aTarget, const DPOINT& aCenterOffset,
+                                         std::vector<DPOINT>& aPoints )
+{
+    aPoints.push_back( m_position );
+
+    if( m_interpolation == 1 )
+    {
+        aPoints.push_back( aTarget );
+        return true;
+    }
+
+    bool clockwise = m_interpolation == 2;
+    DPOINT center = m_position + aCenterOffset;
+
+    if( !m_multiQuadrant )
+    {
+        // Single quadrant mode: the offset is unsigned, the center is the one giving
+        // an arc of 90 degrees at most in the right direction, with the same radius
+        // at both ends
+        double bestError = -1.0;
+
+        for( int sign = 0; sign < 4; ++sign )
+        {
+            DPOINT candidate( m_position.x + ( sign & 1 ? -1 : 1 ) * aCenterOffset.x,
+                              m_position.y + ( sign & 2 ? -1 : 1 ) * aCenterOffset.y );
+            DPOINT start = m_position - candidate;
+            DPOINT end = aTarget - candidate;
+            double sweep = atan2( end.y, end.x ) - atan2( start.y, start.x );
+
+            if( clockwise )
+                sweep = -sweep;
+
+            if( sweep < 0 )
+                sweep += 2 * M_PI;
+
+            if( sweep > M_PI / 2 + 1e-6 )
+                continue;
+
+            double error = std::fabs( start.EuclideanNorm() - end.EuclideanNorm() );
+
+            if( bestError < 0 || error < bestError )
+            {
+                bestError = error;
+                center = candidate;
+            }
+        }
+    }
+
+    DPOINT start = m_position - center;
+    DPOINT end = aTarget - center;
+    double radius = start.EuclideanNorm();
+    double startAngle = atan2( start.y, start.x );
+    double sweep = atan2( end.y, end.x ) - startAngle;
+
+    // The Gerber Y axis goes up: clockwise arcs have a negative sweep
+    if( clockwise )
+    {
+        if( sweep > 0 || ( sweep == 0 && m_multiQuadrant ) )
+            sweep -= 2 * M_PI;
+    }
+    else
+    {
+        if( sweep < 0 || ( sweep == 0 && m_multiQuadrant ) )
+            sweep += 2 * M_PI;
+    }
+
+    int count = std::max( 1, (int) ceil( std::fabs( sweep ) * CIRCLE_SEGMENTS / ( 2 * M_PI ) ) );
+
+    for( int ii = 1; ii < count; ++ii )
+    {
+        double angle = startAngle + sweep * ii / count;
+        aPoints.push_back( center + DPOINT( radius * cos( angle ), radius * sin( angle ) ) );
+    }
+
+    aPoints.push_back( aTarget );
+
+    return true;
+}
+
+
+wxPoint GERBER_POLYGON_READER::toBoard( const DPOINT& aPosition ) const
+{
+    // The Gerber Y axis goes up, the board Y axis goes down
+    return wxPoint( m_offset.x + Millimeter2iu( aPosition.x ),
+                    m_offset.y - Millimeter2iu( aPosition.y ) );
+}
+
+
+bool GERBER_POLYGON_READER::flash( const DPOINT& aPosition )
+{
+    if( !m_aperture )
+    {
+        m_error = "flash without aperture";
+        return false;
+    }
+
+    const std::vector<double>& prms = m_aperture->m_Params;
+    wxPoint pos = toBoard( aPosition );
+
+    switch( m_aperture->m_Type )
+    {
+    case 'C':
+        TransformCircleToPolygon( m_pending, pos, Millimeter2iu( prms[0] / 2 ), CIRCLE_SEGMENTS );
+        break;
+
+    case 'R':
+    {
+        DPOINT half( prms[0] / 2, prms[1] / 2 );
+
+        m_pending.NewOutline();
+        m_pending.Append( toBoard( aPosition + DPOINT( -half.x, -half.y ) ) );
+        m_pending.Append( toBoard( aPosition + DPOINT( half.x, -half.y ) ) );
+        m_pending.Append( toBoard( aPosition + DPOINT( half.x, half.y ) ) );
+        m_pending.Append( toBoard( aPosition + DPOINT( -half.x, half.y ) ) );
+        break;
+    }
+
+    case 'O':
+    {
+        // A segment with round ends, along the largest size
+        double len = std::fabs( prms[0] - prms[1] ) / 2;
+        DPOINT delta = prms[0] > prms[1] ? DPOINT( len, 0.0 ) : DPOINT( 0.0, len );
+
+        TransformRoundedEndsSegmentToPolygon( m_pending, toBoard( aPosition - delta ),
+                                              toBoard( aPosition + delta ), CIRCLE_SEGMENTS,
+                                              Millimeter2iu( std::min( prms[0], prms[1] ) ) );
+        break;
+    }
+
+    case 'P':
+    {
+        // Regular polygon: diameter, vertex count, rotation in degrees
+        int vertices = std::max( 3, KiROUND( prms[1] / m_unitToMm ) );
+        double rotation = prms.size() > 2 ? prms[2] / m_unitToMm : 0.0;
+
+        m_pending.NewOutline();
+
+        for( int ii = 0; ii < vertices; ++ii )
+        {
+            double angle = ( rotation + 360.0 * ii / vertices ) * M_PI / 180.0;
+            m_pending.Append( toBoard( aPosition + DPOINT( prms[0] / 2 * cos( angle ),
+                                                           prms[0] / 2 * sin( angle ) ) ) );
+        }
+
+        break;
+    }
+    }
+
+    return true;
+}
+
+
+bool GERBER_POLYGON_READER::stroke( const std::vector<DPOINT>& aPoints )
+{
+    if( !m_aperture )
+    {
+        m_error = "stroke without aperture";
+        return false;
+    }
+
+    // The plotter strokes only with circle apertures. A stroke with another aperture
+    // is approximated with round ends, using its smallest size as width.
+    const std::vector<double>& prms = m_aperture->m_Params;
+    double width = prms.size() > 1 ? std::min( prms[0], prms[1] ) : prms[0];
+
+    if( m_aperture->m_Type == 'P' )
+        width = prms[0];
+
+    for( size_t ii = 1; ii < aPoints.size(); ++ii )
+    {
+        TransformRoundedEndsSegmentToPolygon( m_pending, toBoard( aPoints[ii - 1] ),
+                                              toBoard( aPoints[ii] ), CIRCLE_SEGMENTS,
+                                              Millimeter2iu( width ) );
+    }
+
+    return true;
+}
+
+
+void GERBER_POLYGON_READER::closeContour()
+{
+    if( m_contour.size() >= 3 )
+    {
+        m_pending.NewOutline();
+
+        for( const DPOINT& point : m_contour )
+            m_pending.Append( toBoard( point ) );
+    }
+
+    m_contour.clear();
+}
+
+
+void GERBER_POLYGON_READER::flushPolarity()
+{
+    if( m_pending.OutlineCount() == 0 )
+        return;
+
+    MergeOutlines( m_pending );
+
+    // Clear objects erase the image drawn before them
+    if( m_clearPolarity )
+        m_image.BooleanSubtract( m_pending, SHAPE_POLY_SET::PM_FAST );
+    else
+        m_image.BooleanAdd( m_pending, SHAPE_POLY_SET::PM_FAST );
+
+    m_pending.RemoveAllContours();
+}
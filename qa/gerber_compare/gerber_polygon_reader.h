@@ -0,0 +1,138 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GERBER_POLYGON_READER_H
+#define GERBER_POLYGON_READER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wx/arrstr.h>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+#include <math/vector2d.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Function MergeOutlines
+ * gives the same orientation to all the outlines of \a aPolys, so overlapping
+ * outlines are not seen as holes, and merges them.
+ * Use it for sets of outlines built one item after the other.
+ */
+void MergeOutlines( SHAPE_POLY_SET& aPolys );
+
+
+/**
+ * Class GERBER_POLYGON_READER
+ * reads a RS274X Gerber file and converts its image to polygons, in board internal
+ * units, without the Gerbview frame and data structures.
+ *
+ * It handles the part of the format written by the Gerber plotter: circle, rectangle,
+ * obround and polygon apertures, linear and circular interpolations, regions and
+ * polarity changes. Aperture macros, step and repeat and incremental coordinates
+ * are reported as errors.
+ */
+class GERBER_POLYGON_READER
+{
+public:
+    GERBER_POLYGON_READER();
+
+    /**
+     * Function SetOffset
+     * @param aOffset = the position, on the board, of the origin of the Gerber file
+     * (the plot offset, i.e. the auxiliary axis origin, or (0,0))
+     */
+    void SetOffset( const wxPoint& aOffset ) { m_offset = aOffset; }
+
+    /**
+     * Function Load
+     * reads \a aFileName and converts its image
+     * @return true on success, false on error: see GetError()
+     */
+    bool Load( const wxString& aFileName );
+
+    /**
+     * @return the image of the file: merged polygons, in board internal units
+     */
+    const SHAPE_POLY_SET& GetImage() const { return m_image; }
+
+    /**
+     * @return the parameters of the .FileFunction attribute of the file, if any
+     * (for instance "Copper", "L1", "Top")
+     */
+    const wxArrayString& GetFileFunction() const { return m_fileFunction; }
+
+    const wxString& GetError() const { return m_error; }
+
+private:
+    struct APERTURE
+    {
+        char                m_Type;     ///< 'C', 'R', 'O' or 'P'
+        std::vector<double> m_Params;   ///< sizes in mm, as in the %AD command
+    };
+
+    bool parseExtendedCommand( const std::string& aCommand );
+    bool parseDataBlock( const std::string& aBlock );
+    void parseFileFunction( const std::string& aAttribute );
+    bool parseCoordinate( const char*& aText, double& aValue );
+
+    bool execute( int aDCode, const DPOINT& aTarget, const DPOINT& aCenterOffset );
+    bool interpolate( const DPOINT& aTarget, const DPOINT& aCenterOffset,
+                      std::vector<DPOINT>& aPoints );
+    bool flash( const DPOINT& aPosition );
+    bool stroke( const std::vector<DPOINT>& aPoints );
+    void closeContour();
+    void flushPolarity();
+
+    /// Converts a position in the file (in mm) to a position on the board
+    wxPoint toBoard( const DPOINT& aPosition ) const;
+
+    wxPoint                     m_offset;
+    wxString                    m_error;
+    wxArrayString               m_fileFunction;
+
+    // Coordinate format
+    bool                        m_omitTrailingZeros;
+    int                         m_intDigits;
+    int                         m_decDigits;
+    double                      m_unitToMm;
+
+    // Graphics state
+    std::map<int, APERTURE>     m_apertures;
+    const APERTURE*             m_aperture;
+    int                         m_interpolation;        ///< 1 (linear), 2 (CW) or 3 (CCW)
+    bool                        m_multiQuadrant;
+    bool                        m_regionMode;
+    int                         m_lastDCode;
+    DPOINT                      m_position;             ///< in mm
+
+    std::vector<DPOINT>         m_contour;              ///< the region contour being read
+    bool                        m_clearPolarity;
+    SHAPE_POLY_SET              m_pending;              ///< objects of the current polarity
+    SHAPE_POLY_SET              m_image;
+};
+
+#endif  // GERBER_POLYGON_READER_H
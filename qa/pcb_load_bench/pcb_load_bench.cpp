@@ -0,0 +1,166 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcb_load_bench.cpp
+ * @brief Measures the time to load, copy (as the undo commands do) and delete a board,
+ * and the peak memory use, to compare the builds with and without KICAD_BOARD_ITEM_POOL.
+ */
+
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+#include <profile.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <memory_pool.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/resource.h>
+#endif
+
+
+/// @return the peak resident set size of the process, in MiB, or -1 if unknown
+static double peakRss()
+{
+#if defined( __APPLE__ )
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+        return usage.ru_maxrss / ( 1024.0 * 1024.0 );   // in bytes
+#elif defined( __unix__ )
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+        return usage.ru_maxrss / 1024.0;                // in KiB
+#endif
+
+    return -1.0;
+}
+
+
+static BOARD* loadBoard( const wxString& aFileName )
+{
+    PLUGIN::RELEASER pi( new PCB_IO );
+    BOARD* brd = nullptr;
+
+    try
+    {
+        brd = pi->Load( aFileName, NULL, NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "Error loading board.\n%s\n", (const char*) ioe.Problem().mb_str() );
+        return nullptr;
+    }
+
+    return brd;
+}
+
+
+/**
+ * Copies all the items of a board, as PCB_BASE_EDIT_FRAME::SaveCopyInUndoList() does,
+ * then deletes the copies.
+ * @return the number of copied items
+ */
+static size_t copyItems( BOARD* aBoard )
+{
+    std::vector<BOARD_ITEM*> copies;
+
+    for( auto track : aBoard->Tracks() )
+        copies.push_back( static_cast<BOARD_ITEM*>( track->Clone() ) );
+
+    for( auto module : aBoard->Modules() )
+        copies.push_back( static_cast<BOARD_ITEM*>( module->Clone() ) );
+
+    for( auto drawing : aBoard->Drawings() )
+        copies.push_back( static_cast<BOARD_ITEM*>( drawing->Clone() ) );
+
+    for( auto zone : aBoard->Zones() )
+        copies.push_back( static_cast<BOARD_ITEM*>( zone->Clone() ) );
+
+    for( BOARD_ITEM* copy : copies )
+        delete copy;
+
+    return copies.size();
+}
+
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 2 )
+    {
+        printf( "A tool measuring the load, copy and delete times of a board.\n" );
+        printf( "usage : %s board_file.kicad_pcb [run count]\n", argv[0] );
+        return -1;
+    }
+
+    int runCount = argc > 2 ? std::max( atoi( argv[2] ), 1 ) : 3;
+
+#ifdef KICAD_BOARD_ITEM_POOL
+    printf( "Board items allocated from a memory pool\n" );
+#else
+    printf( "Board items allocated from the heap\n" );
+#endif
+
+    for( int run = 0; run < runCount; ++run )
+    {
+        PROF_COUNTER loadCounter( "load" );
+        std::unique_ptr<BOARD> brd( loadBoard( argv[1] ) );
+        loadCounter.Stop();
+
+        if( !brd )
+            return -1;
+
+        PROF_COUNTER copyCounter( "copy" );
+        size_t count = copyItems( brd.get() );
+        copyCounter.Stop();
+
+        PROF_COUNTER deleteCounter( "delete" );
+        brd.reset();
+        deleteCounter.Stop();
+
+        printf( "run %d: load %.1f ms, copy of %u items %.1f ms, delete %.1f ms\n", run + 1,
+                loadCounter.msecs(), (unsigned) count, copyCounter.msecs(),
+                deleteCounter.msecs() );
+    }
+
+    printf( "peak RSS: %.1f MiB\n", peakRss() );
+
+#ifdef KICAD_BOARD_ITEM_POOL
+    const MEMORY_POOL& pool = BOARD_ITEM::GetMemoryPool();
+
+    printf( "pool: %.1f MiB reserved, %.1f MiB used\n",
+            pool.GetReservedSize() / ( 1024.0 * 1024.0 ),
+            pool.GetUsedSize() / ( 1024.0 * 1024.0 ) );
+#endif
+
+    return 0;
+}
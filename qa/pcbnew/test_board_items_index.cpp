@@ -0,0 +1,285 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <board_items_index.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+
+#include <random>
+#include <vector>
+
+
+// The grid of the generated items: many of them share end points
+static const int GRID_STEP = 1000000;
+static const int GRID_SIZE = 12;
+
+
+struct BoardItemsIndexFixture
+{
+    BoardItemsIndexFixture() :
+        m_index( &m_board )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_int_distribution<int> gridDist( 0, GRID_SIZE - 1 );
+        std::uniform_int_distribution<int> kindDist( 0, 3 );
+
+        for( int ii = 0; ii < 300; ++ii )
+        {
+            wxPoint start = gridPoint( gridDist( rng ), gridDist( rng ) );
+
+            if( kindDist( rng ) == 0 )
+            {
+                VIA* via = new VIA( &m_board );
+
+                via->SetPosition( start );
+                via->SetEnd( start );
+                via->SetWidth( GRID_STEP / 4 );
+                via->SetLayerPair( F_Cu, B_Cu );
+                m_board.Add( via, ADD_APPEND );
+            }
+            else
+            {
+                TRACK* track = new TRACK( &m_board );
+
+                track->SetStart( start );
+                track->SetEnd( gridPoint( gridDist( rng ), gridDist( rng ) ) );
+                track->SetWidth( GRID_STEP / 10 );
+                track->SetLayer( kindDist( rng ) < 2 ? F_Cu : B_Cu );
+                m_board.Add( track, ADD_APPEND );
+            }
+        }
+
+        // Footprints with a pad at a grid point, some of them overlapping
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            MODULE* module = new MODULE( &m_board );
+            D_PAD* pad = new D_PAD( module );
+
+            pad->SetSize( wxSize( GRID_STEP / 2, GRID_STEP / 2 ) );
+            pad->SetLayerSet( ii % 2 ? D_PAD::SMDMask() : D_PAD::StandardMask() );
+            module->Add( pad );
+            module->SetPosition( gridPoint( gridDist( rng ), gridDist( rng ) ) );
+            m_board.Add( module, ADD_APPEND );
+        }
+    }
+
+    static wxPoint gridPoint( int aX, int aY )
+    {
+        return wxPoint( aX * GRID_STEP, aY * GRID_STEP );
+    }
+
+    /**
+     * Queries the index until it is built (it is built only after a few queries
+     * of the same board state)
+     */
+    void buildIndex()
+    {
+        int queries = 1;
+
+        while( !m_index.IsUsable() && queries < 10 )
+            queries++;
+
+        BOOST_REQUIRE( m_index.IsUsable() );
+    }
+
+    /// The search of BOARD::GetPad() without the index
+    D_PAD* getPadReference( const wxPoint& aPosition, LSET aLayerSet )
+    {
+        for( MODULE* module = m_board.m_Modules; module; module = module->Next() )
+        {
+            D_PAD* pad = NULL;
+
+            if( module->HitTest( aPosition ) )
+                pad = module->GetPad( aPosition, aLayerSet );
+
+            if( pad )
+                return pad;
+        }
+
+        return NULL;
+    }
+
+    /// The search of BOARD::GetPad() with the index
+    D_PAD* getPadIndexed( const wxPoint& aPosition, LSET aLayerSet )
+    {
+        std::vector<MODULE*> modules;
+
+        m_index.GetModulesAt( aPosition, modules );
+
+        for( MODULE* module : modules )
+        {
+            D_PAD* pad = module->GetPad( aPosition, aLayerSet );
+
+            if( pad )
+                return pad;
+        }
+
+        return NULL;
+    }
+
+    /**
+     * Checks the queries of the index give the items found by the walks of the lists,
+     * at the grid points and between them, from several tracks of the list
+     */
+    void checkQueries()
+    {
+        buildIndex();
+
+        std::vector<TRACK*> startTracks;
+        int rank = 0;
+
+        for( TRACK* track = m_board.m_Track; track; track = track->Next(), ++rank )
+        {
+            if( rank % 50 == 0 )
+                startTracks.push_back( track );
+        }
+
+        const LSET layerSets[] = { LSET( F_Cu ), LSET( B_Cu ), LSET::AllCuMask() };
+
+        for( int x = 0; x < 2 * GRID_SIZE; ++x )
+        {
+            for( int y = 0; y < 2 * GRID_SIZE; ++y )
+            {
+                const wxPoint position( x * GRID_STEP / 2, y * GRID_STEP / 2 );
+
+                for( const LSET& layers : layerSets )
+                {
+                    for( TRACK* start : startTracks )
+                    {
+                        BOOST_CHECK( m_index.GetTrack( start, position, layers )
+                                     == ::GetTrack( start, NULL, position, layers ) );
+                        BOOST_CHECK( m_index.GetVia( start, position, layers )
+                                     == start->GetVia( NULL, position, layers ) );
+                    }
+
+                    BOOST_CHECK( getPadIndexed( position, layers )
+                                 == getPadReference( position, layers ) );
+                }
+            }
+        }
+    }
+
+    BOARD               m_board;
+    BOARD_ITEMS_INDEX   m_index;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BoardItemsIndex, BoardItemsIndexFixture )
+
+
+/**
+ * The index is used only after a few queries of the same board state
+ */
+BOOST_AUTO_TEST_CASE( BuiltAfterQueries )
+{
+    BOOST_CHECK( !m_index.IsUsable() );
+
+    buildIndex();
+}
+
+
+BOOST_AUTO_TEST_CASE( MatchesListWalk )
+{
+    checkQueries();
+}
+
+
+/**
+ * Moving items changes the geometry revision: the index is rebuilt
+ */
+BOOST_AUTO_TEST_CASE( MovedItems )
+{
+    checkQueries();
+
+    int ii = 0;
+
+    for( TRACK* track = m_board.m_Track; track; track = track->Next(), ++ii )
+    {
+        if( ii % 3 == 0 )
+            track->SetEnd( track->GetStart() + wxPoint( GRID_STEP, 0 ) );
+    }
+
+    BOOST_CHECK( !m_index.IsUsable() );
+    checkQueries();
+
+    for( MODULE* module = m_board.m_Modules; module; module = module->Next() )
+        module->SetPosition( module->GetPosition() + wxPoint( 0, GRID_STEP ) );
+
+    BOOST_CHECK( !m_index.IsUsable() );
+    checkQueries();
+}
+
+
+/**
+ * Adding and removing items changes the list revisions: the index is rebuilt
+ */
+BOOST_AUTO_TEST_CASE( ChangedLists )
+{
+    checkQueries();
+
+    TRACK* removed = m_board.m_Track.GetFirst()->Next();
+    m_board.Remove( removed );
+    delete removed;
+
+    BOOST_CHECK( !m_index.IsUsable() );
+    checkQueries();
+
+    VIA* via = new VIA( &m_board );
+    via->SetPosition( gridPoint( 1, 1 ) );
+    via->SetEnd( gridPoint( 1, 1 ) );
+    via->SetLayerPair( F_Cu, B_Cu );
+    m_board.Add( via );
+
+    BOOST_CHECK( !m_index.IsUsable() );
+    checkQueries();
+
+    MODULE* module = m_board.m_Modules.GetFirst();
+    m_board.Remove( module );
+    delete module;
+
+    BOOST_CHECK( !m_index.IsUsable() );
+    checkQueries();
+}
+
+
+/**
+ * The BUSY and IS_DELETED flags are not indexed: the queries test them
+ */
+BOOST_AUTO_TEST_CASE( FlaggedItems )
+{
+    int ii = 0;
+
+    for( TRACK* track = m_board.m_Track; track; track = track->Next(), ++ii )
+    {
+        if( ii % 4 == 0 )
+            track->SetState( ii % 8 ? BUSY : IS_DELETED, true );
+    }
+
+    checkQueries();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
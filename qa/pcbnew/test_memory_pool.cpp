@@ -0,0 +1,138 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory_pool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( MemoryPool )
+
+
+/**
+ * The blocks must be aligned, must not overlap, and must be reused once freed
+ */
+BOOST_AUTO_TEST_CASE( AllocateAndReuse )
+{
+    MEMORY_POOL pool( 256, 1024 );
+    std::vector<std::pair<char*, size_t>> blocks;
+    std::mt19937 rng( 1 );
+    std::uniform_int_distribution<size_t> sizeDist( 1, 300 );
+
+    for( int ii = 0; ii < 2000; ++ii )
+    {
+        size_t size = sizeDist( rng );
+        char* block = static_cast<char*>( pool.Allocate( size ) );
+
+        BOOST_CHECK_EQUAL( reinterpret_cast<uintptr_t>( block ) % MEMORY_POOL::BLOCK_ALIGNMENT, 0 );
+
+        memset( block, ii & 0xFF, size );
+        blocks.emplace_back( block, size );
+    }
+
+    // Check the contents: an overlap would have overwritten a block
+    for( size_t ii = 0; ii < blocks.size(); ++ii )
+    {
+        for( size_t jj = 0; jj < blocks[ii].second; ++jj )
+        {
+            if( (unsigned char) blocks[ii].first[jj] != ( ii & 0xFF ) )
+            {
+                BOOST_FAIL( "overlapping blocks" );
+            }
+        }
+    }
+
+    size_t reserved = pool.GetReservedSize();
+    BOOST_CHECK( pool.GetUsedSize() > 0 );
+
+    for( auto& block : blocks )
+        pool.Free( block.first, block.second );
+
+    BOOST_CHECK_EQUAL( pool.GetUsedSize(), 0 );
+
+    // The same allocations do not need new chunks
+    for( auto& block : blocks )
+        block.first = static_cast<char*>( pool.Allocate( block.second ) );
+
+    BOOST_CHECK_EQUAL( pool.GetReservedSize(), reserved );
+
+    for( auto& block : blocks )
+        pool.Free( block.first, block.second );
+}
+
+
+/**
+ * Blocks allocated and freed by several threads at the same time
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentUse )
+{
+    MEMORY_POOL pool;
+    std::vector<std::thread> workers;
+    std::atomic<int> errors( 0 );
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        workers.push_back( std::thread( [&pool, &errors, ii]()
+        {
+            // Boost.Test assertions are not thread safe
+            std::deque<int*> blocks;
+
+            for( int jj = 0; jj < 20000; ++jj )
+            {
+                int* block = static_cast<int*>( pool.Allocate( sizeof( int ) * 8 ) );
+                *block = ii;
+                blocks.push_back( block );
+
+                if( jj % 3 == 0 )
+                {
+                    if( *blocks.front() != ii )
+                        errors++;
+
+                    pool.Free( blocks.front(), sizeof( int ) * 8 );
+                    blocks.pop_front();
+                }
+            }
+
+            for( int* block : blocks )
+                pool.Free( block, sizeof( int ) * 8 );
+        } ) );
+    }
+
+    for( auto& worker : workers )
+        worker.join();
+
+    BOOST_CHECK_EQUAL( errors.load(), 0 );
+    BOOST_CHECK_EQUAL( pool.GetUsedSize(), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,259 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <track_buckets.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+
+// The members of TRACK used by the tracks cleaner buckets
+struct TEST_TRACK
+{
+    int     m_type;
+    int     m_net;
+    int     m_layer;
+    wxPoint m_start;
+    wxPoint m_end;
+    bool    m_deleted;
+
+    int Type() const                { return m_type; }
+    int GetNetCode() const          { return m_net; }
+    int GetLayer() const            { return m_layer; }
+    const wxPoint& GetStart() const { return m_start; }
+    const wxPoint& GetEnd() const   { return m_end; }
+};
+
+
+struct TrackBucketsFixture
+{
+    /**
+     * Generates tracks on a coarse grid, so many of them share end points,
+     * with duplicates (maybe swapped) and vias.
+     */
+    void generate( size_t aCount )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_int_distribution<int> gridDist( 0, 40 );
+        std::uniform_int_distribution<int> netDist( 1, 8 );
+        std::uniform_int_distribution<int> layerDist( 0, 1 );
+        std::uniform_int_distribution<int> kindDist( 0, 9 );
+
+        m_tracks.reserve( aCount );
+
+        while( m_tracks.size() < aCount )
+        {
+            int kind = kindDist( rng );
+
+            if( kind < 2 && !m_tracks.empty() )
+            {
+                // A copy of a previous item, maybe with swapped ends
+                TEST_TRACK copy = m_tracks[rng() % m_tracks.size()];
+
+                if( kind == 1 )
+                    std::swap( copy.m_start, copy.m_end );
+
+                m_tracks.push_back( copy );
+                continue;
+            }
+
+            TEST_TRACK track;
+
+            track.m_type = kind == 2 ? 1 : 0;        // 1: via
+            track.m_net = netDist( rng );
+            track.m_layer = layerDist( rng );
+            track.m_start = wxPoint( gridDist( rng ) * 1000, gridDist( rng ) * 1000 );
+            track.m_end = track.m_type ? track.m_start
+                                       : wxPoint( gridDist( rng ) * 1000, gridDist( rng ) * 1000 );
+            track.m_deleted = false;
+
+            m_tracks.push_back( track );
+        }
+
+        for( TEST_TRACK& track : m_tracks )
+            m_pointers.push_back( &track );
+    }
+
+    /**
+     * The search done by TRACKS_CLEANER::removeDuplicatesOfTrack() for each track
+     * of the board, before the buckets.
+     */
+    std::set<TEST_TRACK*> findDuplicatesReference()
+    {
+        std::set<TEST_TRACK*> toRemove;
+
+        for( TEST_TRACK* track : m_pointers )
+        {
+            if( track->m_deleted )
+                continue;
+
+            for( TEST_TRACK* other : m_pointers )
+            {
+                if( track->GetNetCode() != other->GetNetCode() || track == other
+                        || other->m_deleted )
+                    continue;
+
+                if( track->Type() == other->Type() && track->GetLayer() == other->GetLayer() )
+                {
+                    if( ( track->GetStart() == other->GetStart()
+                            && track->GetEnd() == other->GetEnd() )
+                        || ( track->GetStart() == other->GetEnd()
+                            && track->GetEnd() == other->GetStart() ) )
+                    {
+                        other->m_deleted = true;
+                        toRemove.insert( other );
+                    }
+                }
+            }
+        }
+
+        return toRemove;
+    }
+
+    std::vector<TEST_TRACK*> findConnectedReference( int aNet, const wxPoint& aPos,
+                                                     const std::set<TEST_TRACK*>& aRemoved )
+    {
+        std::vector<TEST_TRACK*> found;
+
+        for( TEST_TRACK* track : m_pointers )
+        {
+            if( !aRemoved.count( track ) && track->GetNetCode() == aNet
+                    && ( track->GetStart() == aPos || track->GetEnd() == aPos ) )
+                found.push_back( track );
+        }
+
+        return found;
+    }
+
+    std::vector<TEST_TRACK> m_tracks;
+    std::vector<TEST_TRACK*> m_pointers;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( TrackBuckets, TrackBucketsFixture )
+
+
+/**
+ * The buckets must remove exactly the items the pairwise search removed
+ */
+BOOST_AUTO_TEST_CASE( DuplicatesMatchPairwiseSearch )
+{
+    generate( 5000 );
+
+    std::vector<TEST_TRACK*> duplicates;
+    FindDuplicateSegments( m_pointers, duplicates );
+
+    std::set<TEST_TRACK*> found( duplicates.begin(), duplicates.end() );
+    std::set<TEST_TRACK*> expected = findDuplicatesReference();
+
+    BOOST_CHECK_EQUAL( found.size(), duplicates.size() );
+    BOOST_CHECK( !expected.empty() );
+    BOOST_CHECK( found == expected );
+}
+
+
+/**
+ * The first item of each group of duplicates is kept
+ */
+BOOST_AUTO_TEST_CASE( DuplicatesKeepFirst )
+{
+    TEST_TRACK a = { 0, 1, 0, wxPoint( 0, 0 ), wxPoint( 100, 0 ), false };
+    TEST_TRACK b = { 0, 1, 0, wxPoint( 100, 0 ), wxPoint( 0, 0 ), false };
+    TEST_TRACK otherNet = { 0, 2, 0, wxPoint( 0, 0 ), wxPoint( 100, 0 ), false };
+    TEST_TRACK otherLayer = { 0, 1, 1, wxPoint( 0, 0 ), wxPoint( 100, 0 ), false };
+    TEST_TRACK via = { 1, 1, 0, wxPoint( 0, 0 ), wxPoint( 0, 0 ), false };
+    TEST_TRACK via2 = via;
+
+    std::vector<TEST_TRACK*> tracks = { &a, &b, &otherNet, &otherLayer, &via, &via2 };
+    std::vector<TEST_TRACK*> duplicates;
+
+    FindDuplicateSegments( tracks, duplicates );
+
+    BOOST_REQUIRE_EQUAL( duplicates.size(), 2 );
+    BOOST_CHECK( duplicates[0] == &b );
+    BOOST_CHECK( duplicates[1] == &via2 );
+}
+
+
+/**
+ * The endpoint index must give the items a scan of the whole list gives,
+ * while items are moved and removed as the collinear segment merge does
+ */
+BOOST_AUTO_TEST_CASE( EndpointIndexMatchesScan )
+{
+    generate( 3000 );
+
+    TRACK_ENDPOINT_INDEX<TEST_TRACK> index;
+    std::set<TEST_TRACK*> removed;
+
+    for( TEST_TRACK* track : m_pointers )
+        index.Add( track );
+
+    std::mt19937 rng( 2 );
+    std::uniform_int_distribution<int> gridDist( 0, 40 );
+
+    for( int ii = 0; ii < 2000; ++ii )
+    {
+        TEST_TRACK* track = m_pointers[rng() % m_pointers.size()];
+
+        if( removed.count( track ) )
+            continue;
+
+        index.Remove( track );
+
+        if( ii % 3 == 0 )
+        {
+            removed.insert( track );
+        }
+        else
+        {
+            if( track->m_type == 0 )
+                track->m_end = wxPoint( gridDist( rng ) * 1000, gridDist( rng ) * 1000 );
+
+            index.Add( track );
+        }
+    }
+
+    for( int x = 0; x <= 40; ++x )
+    {
+        for( int y = 0; y <= 40; ++y )
+        {
+            for( int net = 1; net <= 8; ++net )
+            {
+                wxPoint pos( x * 1000, y * 1000 );
+                std::vector<TEST_TRACK*> found = index.Get( net, pos );
+                std::vector<TEST_TRACK*> expected = findConnectedReference( net, pos, removed );
+
+                std::sort( found.begin(), found.end() );
+
+                BOOST_CHECK( found == expected );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,265 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <commit.h>
+#include <netinfo.h>
+#include <tracks_cleaner.h>
+
+
+/**
+ * A commit which only records the changes; the removed items are deleted with it,
+ * as BOARD_COMMIT::Push() does
+ */
+class TEST_COMMIT : public COMMIT
+{
+public:
+    ~TEST_COMMIT()
+    {
+        for( COMMIT_LINE& ent : m_changes )
+        {
+            if( ( ent.m_type & CHT_TYPE ) == CHT_REMOVE )
+                delete ent.m_item;
+        }
+    }
+
+    void Push( const wxString& aMessage, bool aCreateUndoEntry, bool aSetDirtyBit ) override
+    {
+    }
+
+    void Revert() override
+    {
+    }
+
+private:
+    EDA_ITEM* parentObject( EDA_ITEM* aItem ) const override
+    {
+        return aItem;
+    }
+};
+
+
+struct TracksCleanerFixture
+{
+    TracksCleanerFixture()
+    {
+        for( int netCode = 1; netCode <= 2; ++netCode )
+        {
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "N%d", netCode ),
+                                           netCode ) );
+        }
+    }
+
+    TRACK* addTrack( int aNetCode, const wxPoint& aStart, const wxPoint& aEnd,
+                     PCB_LAYER_ID aLayer = F_Cu, int aWidth = 200000 )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetLayer( aLayer );
+        track->SetWidth( aWidth );
+        track->SetNetCode( aNetCode );
+        m_board.Add( track, ADD_APPEND );
+
+        return track;
+    }
+
+    VIA* addVia( int aNetCode, const wxPoint& aPosition )
+    {
+        VIA* via = new VIA( &m_board );
+
+        via->SetPosition( aPosition );
+        via->SetEnd( aPosition );
+        via->SetLayerPair( F_Cu, B_Cu );
+        via->SetNetCode( aNetCode );
+        m_board.Add( via, ADD_APPEND );
+
+        return via;
+    }
+
+    /// Runs the cleanup of the vias and of the segments, as the cleanup dialog does
+    bool cleanup()
+    {
+        TRACKS_CLEANER cleaner( &m_board, m_commit );
+
+        return cleaner.CleanupBoard( false, true, true, false );
+    }
+
+    /// @return true if \a aItem is still in the track list of the board
+    bool onBoard( const TRACK* aItem )
+    {
+        for( TRACK* track = m_board.m_Track; track; track = track->Next() )
+        {
+            if( track == aItem )
+                return true;
+        }
+
+        return false;
+    }
+
+    /// @return true if a track of the board joins \a aA and \a aB
+    bool hasTrack( const wxPoint& aA, const wxPoint& aB )
+    {
+        for( TRACK* track = m_board.m_Track; track; track = track->Next() )
+        {
+            if( track->Type() != PCB_TRACE_T )
+                continue;
+
+            if( ( track->GetStart() == aA && track->GetEnd() == aB )
+                    || ( track->GetStart() == aB && track->GetEnd() == aA ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    // The commit is destroyed after the board: the removed items are not in the board
+    TEST_COMMIT m_commit;
+    BOARD       m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( TracksCleaner, TracksCleanerFixture )
+
+
+/**
+ * The following through vias at the position of a through via are removed
+ */
+BOOST_AUTO_TEST_CASE( DuplicateVias )
+{
+    VIA* first = addVia( 1, wxPoint( 0, 0 ) );
+    addVia( 1, wxPoint( 0, 0 ) );
+    addVia( 1, wxPoint( 0, 0 ) );
+    VIA* other = addVia( 1, wxPoint( 1000000, 0 ) );
+
+    BOOST_CHECK( cleanup() );
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 2u );
+    BOOST_CHECK( onBoard( first ) );
+    BOOST_CHECK( onBoard( other ) );
+}
+
+
+/**
+ * The copies of a track (maybe with swapped ends) on the same layer and net are removed,
+ * the first one of the list is kept
+ */
+BOOST_AUTO_TEST_CASE( DuplicateTracks )
+{
+    const wxPoint a( 0, 0 );
+    const wxPoint b( 1000000, 500000 );
+
+    TRACK* first = addTrack( 1, a, b );
+    addTrack( 1, a, b );
+    addTrack( 1, b, a );
+    TRACK* otherLayer = addTrack( 1, a, b, B_Cu );
+    TRACK* otherNet = addTrack( 2, a, b );
+
+    BOOST_CHECK( cleanup() );
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 3u );
+    BOOST_CHECK( onBoard( first ) );
+    BOOST_CHECK( onBoard( otherLayer ) );
+    BOOST_CHECK( onBoard( otherNet ) );
+}
+
+
+/**
+ * Chains of collinear segments are merged into one segment, on each net
+ */
+BOOST_AUTO_TEST_CASE( CollinearMerge )
+{
+    for( int netCode = 1; netCode <= 2; ++netCode )
+    {
+        const int y = netCode * 1000000;
+
+        addTrack( netCode, wxPoint( 0, y ), wxPoint( 1000000, y ) );
+        addTrack( netCode, wxPoint( 1000000, y ), wxPoint( 2000000, y ) );
+        addTrack( netCode, wxPoint( 3000000, y ), wxPoint( 2000000, y ) );
+    }
+
+    cleanup();
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 2u );
+    BOOST_CHECK( hasTrack( wxPoint( 0, 1000000 ), wxPoint( 3000000, 1000000 ) ) );
+    BOOST_CHECK( hasTrack( wxPoint( 0, 2000000 ), wxPoint( 3000000, 2000000 ) ) );
+}
+
+
+/**
+ * The segments are not merged when their common end is also the end of another track,
+ * on the first net of the list or on another one
+ */
+BOOST_AUTO_TEST_CASE( JunctionKept )
+{
+    for( int netCode = 1; netCode <= 2; ++netCode )
+    {
+        const int y = netCode * 1000000;
+
+        addTrack( netCode, wxPoint( 0, y ), wxPoint( 1000000, y ) );
+        addTrack( netCode, wxPoint( 1000000, y ), wxPoint( 2000000, y ) );
+        addTrack( netCode, wxPoint( 1000000, y ), wxPoint( 1000000, y + 500000 ) );
+    }
+
+    cleanup();
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 6u );
+}
+
+
+/**
+ * The segments are not merged when their common end is on a via
+ */
+BOOST_AUTO_TEST_CASE( ViaKept )
+{
+    addTrack( 1, wxPoint( 0, 0 ), wxPoint( 1000000, 0 ) );
+    addTrack( 1, wxPoint( 1000000, 0 ), wxPoint( 2000000, 0 ) );
+    addVia( 1, wxPoint( 1000000, 0 ) );
+
+    cleanup();
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 3u );
+}
+
+
+/**
+ * The segments having a different width or direction are not merged
+ */
+BOOST_AUTO_TEST_CASE( NotMergeable )
+{
+    addTrack( 1, wxPoint( 0, 0 ), wxPoint( 1000000, 0 ) );
+    addTrack( 1, wxPoint( 1000000, 0 ), wxPoint( 2000000, 0 ), F_Cu, 300000 );
+
+    addTrack( 2, wxPoint( 0, 1000000 ), wxPoint( 1000000, 1000000 ) );
+    addTrack( 2, wxPoint( 1000000, 1000000 ), wxPoint( 2000000, 2000000 ) );
+
+    cleanup();
+
+    BOOST_CHECK_EQUAL( m_board.m_Track.GetCount(), 4u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
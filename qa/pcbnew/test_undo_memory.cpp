@@ -0,0 +1,263 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <pcb_screen.h>
+
+#include <functional>
+#include <vector>
+
+
+/**
+ * A board with a filled zone (a square)
+ */
+struct ZoneFillFixture
+{
+    ZoneFillFixture() :
+        m_zone( &m_board )
+    {
+        SHAPE_POLY_SET fill;
+
+        fill.NewOutline();
+        fill.Append( 0, 0 );
+        fill.Append( 1000, 0 );
+        fill.Append( 1000, 1000 );
+        fill.Append( 0, 1000 );
+
+        m_zone.Outline()->Append( fill );
+        m_zone.SetFilledPolysList( fill );
+    }
+
+    /**
+     * Checks a copy of the zone shares the fill until \a aTransform modifies it,
+     * and the fill of the zone is unchanged
+     */
+    void checkCopyOnWrite( std::function<void( ZONE_CONTAINER& )> aTransform )
+    {
+        ZONE_CONTAINER copy( m_zone );
+
+        BOOST_CHECK_EQUAL( m_zone.GetFilledPolysUseCount(), 2 );
+        BOOST_CHECK( &copy.GetFilledPolysList() == &m_zone.GetFilledPolysList() );
+
+        aTransform( copy );
+
+        BOOST_CHECK_EQUAL( m_zone.GetFilledPolysUseCount(), 1 );
+        BOOST_CHECK_EQUAL( copy.GetFilledPolysUseCount(), 1 );
+        BOOST_CHECK( copy.GetFilledPolysList().CVertex( 2 ) != VECTOR2I( 1000, 1000 ) );
+
+        const SHAPE_POLY_SET& fill = m_zone.GetFilledPolysList();
+
+        BOOST_REQUIRE_EQUAL( fill.TotalVertices(), 4 );
+        BOOST_CHECK_EQUAL( fill.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+        BOOST_CHECK_EQUAL( fill.CVertex( 1 ), VECTOR2I( 1000, 0 ) );
+        BOOST_CHECK_EQUAL( fill.CVertex( 2 ), VECTOR2I( 1000, 1000 ) );
+        BOOST_CHECK_EQUAL( fill.CVertex( 3 ), VECTOR2I( 0, 1000 ) );
+    }
+
+    BOARD           m_board;
+    ZONE_CONTAINER  m_zone;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillSharing, ZoneFillFixture )
+
+
+BOOST_AUTO_TEST_CASE( MoveCopy )
+{
+    checkCopyOnWrite( []( ZONE_CONTAINER& aZone )
+                      {
+                          aZone.Move( wxPoint( 500, 0 ) );
+                      } );
+}
+
+
+BOOST_AUTO_TEST_CASE( RotateCopy )
+{
+    checkCopyOnWrite( []( ZONE_CONTAINER& aZone )
+                      {
+                          aZone.Rotate( wxPoint( 0, 0 ), 900 );
+                      } );
+}
+
+
+BOOST_AUTO_TEST_CASE( MirrorCopy )
+{
+    checkCopyOnWrite( []( ZONE_CONTAINER& aZone )
+                      {
+                          aZone.Mirror( wxPoint( 0, 0 ) );
+                      } );
+}
+
+
+/**
+ * A refill of the zone does not modify the fill kept by its copies
+ */
+BOOST_AUTO_TEST_CASE( RefillKeepsCopy )
+{
+    ZONE_CONTAINER copy( m_zone );
+
+    m_zone.UnFill();
+
+    BOOST_CHECK( m_zone.GetFilledPolysList().IsEmpty() );
+    BOOST_CHECK_EQUAL( copy.GetFilledPolysList().TotalVertices(), 4 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/**
+ * Undo commands, each one holding a deleted track
+ */
+struct UndoMemoryFixture
+{
+    UndoMemoryFixture() :
+        m_screen( wxSize( 100000, 100000 ) )
+    {
+        // Disable the count limit: only the memory limit is tested
+        m_screen.SetMaxUndoItems( 0 );
+    }
+
+    PICKED_ITEMS_LIST* newCommand()
+    {
+        PICKED_ITEMS_LIST* command = new PICKED_ITEMS_LIST;
+
+        command->PushItem( ITEM_PICKER( new TRACK( &m_board ), UR_DELETED ) );
+
+        return command;
+    }
+
+    size_t commandSize()
+    {
+        PCB_SCREEN screen( wxSize( 100000, 100000 ) );
+
+        screen.PushCommandToUndoList( newCommand() );
+
+        return screen.GetUndoRedoMemory();
+    }
+
+    BOARD       m_board;
+    PCB_SCREEN  m_screen;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( UndoMemory, UndoMemoryFixture )
+
+
+/**
+ * The oldest commands are dropped when the limit is reached
+ */
+BOOST_AUTO_TEST_CASE( OldestDropped )
+{
+    const size_t size = commandSize();
+
+    BOOST_REQUIRE( size > 0 );
+
+    m_screen.SetMaxUndoMemory( 3 * size + size / 2 );
+
+    std::vector<PICKED_ITEMS_LIST*> commands;
+
+    for( int ii = 0; ii < 5; ++ii )
+    {
+        commands.push_back( newCommand() );
+        m_screen.PushCommandToUndoList( commands.back() );
+    }
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoCommandCount(), 3 );
+    BOOST_CHECK_EQUAL( m_screen.GetUndoRedoMemory(), 3 * size );
+
+    // The kept commands are the last ones
+    BOOST_CHECK( m_screen.m_UndoList.m_CommandsList.front() == commands[2] );
+    BOOST_CHECK( m_screen.m_UndoList.m_CommandsList.back() == commands[4] );
+}
+
+
+/**
+ * The last command is kept, even if it is larger than the limit
+ */
+BOOST_AUTO_TEST_CASE( LastKept )
+{
+    m_screen.SetMaxUndoMemory( 1 );
+
+    m_screen.PushCommandToUndoList( newCommand() );
+    m_screen.PushCommandToUndoList( newCommand() );
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoCommandCount(), 1 );
+}
+
+
+/**
+ * The totals follow the commands moved between the lists and cleared
+ */
+BOOST_AUTO_TEST_CASE( RunningTotals )
+{
+    const size_t size = commandSize();
+
+    for( int ii = 0; ii < 4; ++ii )
+        m_screen.PushCommandToUndoList( newCommand() );
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoRedoMemory(), 4 * size );
+
+    // Undo twice
+    m_screen.PushCommandToRedoList( m_screen.PopCommandFromUndoList() );
+    m_screen.PushCommandToRedoList( m_screen.PopCommandFromUndoList() );
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoRedoMemory(), 4 * size );
+
+    m_screen.ClearUndoORRedoList( m_screen.m_RedoList );
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoRedoMemory(), 2 * size );
+
+    m_screen.ClearUndoRedoList();
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoRedoMemory(), (size_t) 0 );
+}
+
+
+/**
+ * The redo commands, cleared by a new command, do not make it drop undo commands
+ * when the redo list is cleared first (see PCB_BASE_EDIT_FRAME::SaveCopyInUndoList())
+ */
+BOOST_AUTO_TEST_CASE( RedoClearedFirst )
+{
+    const size_t size = commandSize();
+
+    m_screen.SetMaxUndoMemory( 3 * size );
+
+    for( int ii = 0; ii < 3; ++ii )
+        m_screen.PushCommandToUndoList( newCommand() );
+
+    m_screen.PushCommandToRedoList( m_screen.PopCommandFromUndoList() );
+    m_screen.PushCommandToRedoList( m_screen.PopCommandFromUndoList() );
+
+    m_screen.ClearUndoORRedoList( m_screen.m_RedoList );
+    m_screen.PushCommandToUndoList( newCommand() );
+
+    BOOST_CHECK_EQUAL( m_screen.GetUndoCommandCount(), 2 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file raytrace_render.cpp
+ * @brief Renders a board with the 3D viewer raytracer to a PNG file, without OpenGL.
+ */
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+#include <wx/image.h>
+
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+#include <reporter.h>
+#include <profile.h>
+
+#include <class_board.h>
+
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+static const wxCmdLineEntryDesc commandLineDesc[] =
+{
+    { wxCMD_LINE_PARAM,  NULL, NULL, "board file", wxCMD_LINE_VAL_STRING, 0 },
+    { wxCMD_LINE_PARAM,  NULL, NULL, "output PNG file", wxCMD_LINE_VAL_STRING, 0 },
+    { wxCMD_LINE_OPTION, "w", "width", "image width in pixels (default 1600)",
+      wxCMD_LINE_VAL_NUMBER, 0 },
+    { wxCMD_LINE_OPTION, "h", "height", "image height in pixels (default 1200)",
+      wxCMD_LINE_VAL_NUMBER, 0 },
+    { wxCMD_LINE_OPTION, "x", "rotate-x", "camera rotation around X axis in degrees",
+      wxCMD_LINE_VAL_DOUBLE, 0 },
+    { wxCMD_LINE_OPTION, "y", "rotate-y", "camera rotation around Y axis in degrees",
+      wxCMD_LINE_VAL_DOUBLE, 0 },
+    { wxCMD_LINE_OPTION, "z", "rotate-z", "camera rotation around Z axis in degrees",
+      wxCMD_LINE_VAL_DOUBLE, 0 },
+    { wxCMD_LINE_OPTION, "f", "zoom", "zoom factor (default 1.0)",
+      wxCMD_LINE_VAL_DOUBLE, 0 },
+    { wxCMD_LINE_SWITCH, "o", "orthographic", "use an orthographic projection",
+      wxCMD_LINE_VAL_NONE, 0 },
+    { wxCMD_LINE_SWITCH, "q", "quick", "disable shadows, reflections, refractions, "
+                                       "anti-aliasing and post processing",
+      wxCMD_LINE_VAL_NONE, 0 },
+    { wxCMD_LINE_NONE }
+};
+
+
+BOARD* loadBoard( const wxString& aFilename )
+{
+    PLUGIN::RELEASER pi( new PCB_IO );
+    BOARD* brd = nullptr;
+
+    try
+    {
+        brd = pi->Load( aFilename, NULL, NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxString msg = wxString::Format( _( "Error loading board.\n%s" ),
+                ioe.Problem() );
+
+        printf( "%s\n", (const char*) msg.mb_str() );
+        return nullptr;
+    }
+
+    return brd;
+}
+
+
+bool savePNG( const wxString& aFilename, const std::vector<unsigned char>& aRGBA,
+              int aWidth, int aHeight )
+{
+    const unsigned int nPixels = aWidth * aHeight;
+
+    // wxImage takes the ownership of the buffers, they have to be allocated with malloc()
+    unsigned char* rgb = (unsigned char*) malloc( nPixels * 3 );
+    unsigned char* alpha = (unsigned char*) malloc( nPixels );
+
+    for( unsigned int i = 0; i < nPixels; ++i )
+    {
+        rgb[i * 3 + 0] = aRGBA[i * 4 + 0];
+        rgb[i * 3 + 1] = aRGBA[i * 4 + 1];
+        rgb[i * 3 + 2] = aRGBA[i * 4 + 2];
+        alpha[i] = aRGBA[i * 4 + 3];
+    }
+
+    wxImage image( aWidth, aHeight );
+    image.SetData( rgb );
+    image.SetAlpha( alpha );
+
+    return image.SaveFile( aFilename, wxBITMAP_TYPE_PNG );
+}
+
+
+int main( int argc, char* argv[] )
+{
+    wxInitializer initializer( argc, argv );
+
+    if( !initializer.IsOk() )
+        return -1;
+
+    wxCmdLineParser parser( commandLineDesc, argc, argv );
+
+    if( parser.Parse() != 0 )
+        return -1;
+
+    long width = 1600, height = 1200;
+    double rotX = 0.0, rotY = 0.0, rotZ = 0.0, zoom = 1.0;
+
+    parser.Found( "w", &width );
+    parser.Found( "h", &height );
+    parser.Found( "x", &rotX );
+    parser.Found( "y", &rotY );
+    parser.Found( "z", &rotZ );
+    parser.Found( "f", &zoom );
+
+    if( width <= 0 || height <= 0 || zoom <= 0.0 )
+    {
+        printf( "Invalid image size or zoom factor\n" );
+        return -1;
+    }
+
+    wxImage::AddHandler( new wxPNGHandler );
+
+    STDOUT_REPORTER reporter;
+
+    // Board loading
+    // /////////////////////////////////////////////////////////////////////////
+    unsigned startTime = GetRunningMicroSecs();
+
+    std::unique_ptr<BOARD> brd( loadBoard( parser.GetParam( 0 ) ) );
+
+    if( !brd )
+        return -1;
+
+    printf( "Board loading time %.3f s\n", (double)( GetRunningMicroSecs() - startTime ) / 1e6 );
+
+    // Render settings and camera
+    // /////////////////////////////////////////////////////////////////////////
+    CINFO3D_VISU settings;
+
+    settings.SetBoard( brd.get() );
+    settings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+
+    const bool quick = parser.Found( "q" );
+
+    settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, !quick );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, !quick );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, !quick );
+    settings.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, !quick );
+    settings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, !quick );
+    settings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, !quick );
+
+    CCAMERA& camera = settings.CameraGet();
+
+    if( parser.Found( "o" ) )
+        camera.SetProjection( PROJECTION_ORTHO );
+
+    camera.RotateX( glm::radians( (float) rotX ) );
+    camera.RotateY( glm::radians( (float) rotY ) );
+    camera.RotateZ( glm::radians( (float) rotZ ) );
+    camera.Zoom( (float) zoom );
+
+    // Scene build and render
+    // /////////////////////////////////////////////////////////////////////////
+    C3D_RENDER_RAYTRACING renderer( settings );
+    std::vector<unsigned char> image;
+
+    startTime = GetRunningMicroSecs();
+
+    if( !renderer.RenderOffscreen( wxSize( width, height ), image, &reporter ) )
+    {
+        printf( "Failed to render the board\n" );
+        return -1;
+    }
+
+    printf( "Total scene build and render time %.3f s\n",
+            (double)( GetRunningMicroSecs() - startTime ) / 1e6 );
+
+    if( !savePNG( parser.GetParam( 1 ), image, width, height ) )
+    {
+        printf( "Failed to write %s\n", (const char*) parser.GetParam( 1 ).mb_str() );
+        return -1;
+    }
+
+    return 0;
+}
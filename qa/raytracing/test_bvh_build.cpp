@@ -0,0 +1,201 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <openmp_mutex.h>
+#include <3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_render_raytracing/cmaterial.h>
+#include <3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <random>
+
+
+static int getMaxThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+static void setThreads( int aThreads )
+{
+#ifdef _OPENMP
+    omp_set_num_threads( aThreads );
+#else
+    (void) aThreads;
+#endif
+}
+
+
+/**
+ * Deterministic scene of small random triangles, the size of a board with many models.
+ */
+struct BvhBuildFixture
+{
+    BvhBuildFixture() :
+        m_maxThreads( getMaxThreads() )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_real_distribution<float> posDist( -4.0f, 4.0f );
+        std::uniform_real_distribution<float> sizeDist( -0.05f, 0.05f );
+
+        for( int i = 0; i < 300000; ++i )
+        {
+            // Separate statements, so the random sequence does not depend on the compiler
+            const float x = posDist( rng );
+            const float y = posDist( rng );
+            const float z = 0.1f * posDist( rng );
+            const float dx0 = sizeDist( rng );
+            const float dy0 = sizeDist( rng );
+            const float dx1 = sizeDist( rng );
+            const float dy1 = sizeDist( rng );
+            const float dz = sizeDist( rng );
+
+            const SFVEC3F a( x, y, z );
+
+            CTRIANGLE* triangle = new CTRIANGLE( a, a + SFVEC3F( dx0, dy0, dz ),
+                                                 a + SFVEC3F( dx1, dy1, -dz ) );
+
+            triangle->SetMaterial( &m_material );
+            m_container.Add( triangle );
+        }
+    }
+
+    ~BvhBuildFixture()
+    {
+        setThreads( m_maxThreads );
+    }
+
+    CBVH_PBRT* build( SPLITMETHOD aSplitMethod, int aThreads )
+    {
+        setThreads( aThreads );
+
+        return new CBVH_PBRT( m_container, 4, aSplitMethod );
+    }
+
+    ///> Traces rays crossing the scene, returns the hits
+    std::vector<HITINFO> trace( const CBVH_PBRT& aBvh ) const
+    {
+        std::mt19937 rng( 2 );
+        std::uniform_real_distribution<float> posDist( -4.0f, 4.0f );
+        std::vector<HITINFO> hits( 20000 );
+
+        for( HITINFO& hit : hits )
+        {
+            const float x0 = posDist( rng );
+            const float y0 = posDist( rng );
+            const float x1 = posDist( rng );
+            const float y1 = posDist( rng );
+
+            const SFVEC3F origin( x0, y0, 2.0f );
+
+            RAY ray;
+            ray.Init( origin, glm::normalize( SFVEC3F( x1, y1, -2.0f ) - origin ) );
+
+            hit.m_tHit = std::numeric_limits<float>::infinity();
+            hit.pHitObject = NULL;
+
+            aBvh.Intersect( ray, hit );
+        }
+
+        return hits;
+    }
+
+    CBLINN_PHONG_MATERIAL   m_material;
+    CCONTAINER              m_container;
+    int                     m_maxThreads;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BvhBuild, BvhBuildFixture )
+
+
+/**
+ * The subtrees built in parallel have to give the same tree as the serial build,
+ * so the rays hit the same objects.
+ */
+BOOST_AUTO_TEST_CASE( ParallelMatchesSerial )
+{
+    const SPLITMETHOD methods[] = { SPLIT_SAH, SPLIT_HLBVH };
+
+    for( SPLITMETHOD method : methods )
+    {
+        std::unique_ptr<CBVH_PBRT> serial( build( method, 1 ) );
+        std::unique_ptr<CBVH_PBRT> parallel( build( method, m_maxThreads ) );
+
+        const std::vector<HITINFO> expected = trace( *serial );
+        const std::vector<HITINFO> found = trace( *parallel );
+
+        unsigned int hitCount = 0;
+
+        for( size_t i = 0; i < found.size(); ++i )
+        {
+            BOOST_REQUIRE( found[i].pHitObject == expected[i].pHitObject );
+            BOOST_REQUIRE_EQUAL( found[i].m_tHit, expected[i].m_tHit );
+
+            hitCount += found[i].pHitObject ? 1 : 0;
+        }
+
+        BOOST_CHECK( hitCount > found.size() / 10 );
+    }
+}
+
+
+/**
+ * Build time of each split method with an increasing number of threads.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    const SPLITMETHOD methods[] = { SPLIT_SAH, SPLIT_HLBVH };
+    const char* names[] = { "SAH", "HLBVH" };
+
+    for( int m = 0; m < 2; ++m )
+    {
+        double serialTime = 0.0;
+
+        for( int threads = 1; threads <= m_maxThreads; threads *= 2 )
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            std::unique_ptr<CBVH_PBRT> bvh( build( methods[m], threads ) );
+
+            const double time = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start ).count();
+
+            if( threads == 1 )
+                serialTime = time;
+
+            BOOST_TEST_MESSAGE( names[m] << ", " << threads << " threads: " << time
+                                << " ms, speedup " << serialTime / time );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
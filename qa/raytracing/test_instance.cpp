@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_render_raytracing/cmaterial.h>
+#include <3d_render_raytracing/shapes3D/cinstance.h>
+#include <3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <limits>
+#include <memory>
+#include <random>
+
+
+static SFVEC3F randomVector( std::mt19937& aRng )
+{
+    std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+
+    // Separate statements, so the random sequence does not depend on the compiler
+    const float x = dist( aRng );
+    const float y = dist( aRng );
+    const float z = dist( aRng );
+
+    return SFVEC3F( x, y, z );
+}
+
+
+/**
+ * A model made of random triangles, placed in the scene both as an instance and as
+ * triangles transformed to world coordinates.
+ */
+struct InstanceFixture
+{
+    InstanceFixture()
+    {
+        std::mt19937 rng( 1 );
+
+        m_modelMatrix = glm::translate( glm::mat4( 1.0f ), SFVEC3F( 3.0f, -2.0f, 0.5f ) );
+        m_modelMatrix = glm::rotate( m_modelMatrix, 0.7f, SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+        m_modelMatrix = glm::rotate( m_modelMatrix, 0.3f, SFVEC3F( 1.0f, 0.0f, 0.0f ) );
+        m_modelMatrix = glm::scale( m_modelMatrix, SFVEC3F( 0.5f, 0.8f, 0.3f ) );
+
+        for( int i = 0; i < 200; ++i )
+        {
+            const SFVEC3F a = randomVector( rng );
+            const SFVEC3F b = a + 0.3f * randomVector( rng );
+            const SFVEC3F c = a + 0.3f * randomVector( rng );
+
+            addTriangle( m_modelTriangles, a, b, c );
+            addTriangle( m_worldTriangles, toWorld( a ), toWorld( b ), toWorld( c ) );
+        }
+
+        m_modelBvh.reset( new CBVH_PBRT( m_modelTriangles ) );
+
+        CINSTANCE* instance = new CINSTANCE( m_modelBvh.get(), m_modelTriangles.GetBBox(),
+                                             m_modelMatrix );
+        m_instances.Add( instance );
+
+        m_instanceBvh.reset( new CBVH_PBRT( m_instances ) );
+        m_worldBvh.reset( new CBVH_PBRT( m_worldTriangles ) );
+    }
+
+    SFVEC3F toWorld( const SFVEC3F& aPoint ) const
+    {
+        return SFVEC3F( m_modelMatrix * glm::vec4( aPoint, 1.0f ) );
+    }
+
+    void addTriangle( CCONTAINER& aContainer, const SFVEC3F& aA, const SFVEC3F& aB,
+                      const SFVEC3F& aC )
+    {
+        CTRIANGLE* triangle = new CTRIANGLE( aA, aB, aC );
+
+        triangle->SetMaterial( &m_material );
+        aContainer.Add( triangle );
+    }
+
+    CBLINN_PHONG_MATERIAL       m_material;
+    glm::mat4                   m_modelMatrix;
+    CCONTAINER                  m_modelTriangles;
+    CCONTAINER                  m_worldTriangles;
+    CCONTAINER                  m_instances;
+    std::unique_ptr<CBVH_PBRT>  m_modelBvh;
+    std::unique_ptr<CBVH_PBRT>  m_instanceBvh;
+    std::unique_ptr<CBVH_PBRT>  m_worldBvh;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Instance, InstanceFixture )
+
+
+/**
+ * Rays hitting the instance have to hit it at the same distance, point and normal
+ * as the triangles transformed to world coordinates.
+ */
+BOOST_AUTO_TEST_CASE( MatchesWorldTriangles )
+{
+    std::mt19937 rng( 2 );
+
+    unsigned int hitCount = 0;
+    unsigned int mismatches = 0;
+
+    for( int i = 0; i < 10000; ++i )
+    {
+        const SFVEC3F target = toWorld( randomVector( rng ) );
+        const SFVEC3F offset = randomVector( rng );
+        const SFVEC3F origin = target + 5.0f * SFVEC3F( offset.x, offset.y, 1.0f );
+
+        RAY ray;
+        ray.Init( origin, glm::normalize( target - origin ) );
+
+        HITINFO instanceHit;
+        instanceHit.m_tHit = std::numeric_limits<float>::infinity();
+        instanceHit.pHitObject = NULL;
+
+        HITINFO worldHit;
+        worldHit.m_tHit = std::numeric_limits<float>::infinity();
+        worldHit.pHitObject = NULL;
+
+        const bool hitInstance = m_instanceBvh->Intersect( ray, instanceHit );
+        const bool hitWorld = m_worldBvh->Intersect( ray, worldHit );
+
+        // The rays grazing a triangle edge may differ, as the transformation is not exact
+        if( hitInstance != hitWorld
+            || ( hitWorld && glm::abs( instanceHit.m_tHit - worldHit.m_tHit ) > 1e-3f ) )
+        {
+            ++mismatches;
+            continue;
+        }
+
+        if( !hitInstance )
+            continue;
+
+        ++hitCount;
+
+        BOOST_CHECK( instanceHit.pHitInstance == m_instances.GetList().front() );
+        BOOST_CHECK_SMALL( glm::length( instanceHit.m_HitPoint - worldHit.m_HitPoint ), 1e-3f );
+        BOOST_CHECK_SMALL( glm::length( instanceHit.m_HitNormal - worldHit.m_HitNormal ), 1e-3f );
+        BOOST_CHECK( m_instanceBvh->IntersectP( ray, worldHit.m_tHit + 1e-3f ) );
+    }
+
+    BOOST_CHECK( mismatches <= 10 );
+    BOOST_CHECK( hitCount > 1000 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
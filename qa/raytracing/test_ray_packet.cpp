@@ -0,0 +1,256 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <ctrack_ball.h>
+#include <3d_render_raytracing/accelerators/cbvh_pbrt.h>
+#include <3d_render_raytracing/accelerators/ccontainer.h>
+#include <3d_render_raytracing/cmaterial.h>
+#include <3d_render_raytracing/shapes3D/ctriangle.h>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+static const int IMAGE_SIZE = 256;
+
+
+static void initHitPacket( HITINFO_PACKET *aHitPacket )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        aHitPacket[i].m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
+        aHitPacket[i].m_HitInfo.m_acc_node_info = 0;
+        aHitPacket[i].m_HitInfo.pHitObject = NULL;
+        aHitPacket[i].m_hitresult = false;
+    }
+}
+
+
+/**
+ * Deterministic benchmark scene: a bumpy board-sized surface made of small triangles,
+ * with randomly placed small triangles above it (component bodies), seen by the
+ * default camera.
+ */
+struct RayPacketFixture
+{
+    RayPacketFixture() :
+        m_camera( 8.0f )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_real_distribution<float> posDist( -3.5f, 3.5f );
+        std::uniform_real_distribution<float> sizeDist( 0.01f, 0.1f );
+
+        const int gridSize = 200;
+        const float cell = 8.0f / gridSize;
+
+        auto height = []( float x, float y )
+        {
+            return 0.05f * std::sin( x * 3.0f ) * std::cos( y * 2.0f );
+        };
+
+        for( int iy = 0; iy < gridSize; ++iy )
+        {
+            for( int ix = 0; ix < gridSize; ++ix )
+            {
+                const float x0 = -4.0f + ix * cell, x1 = x0 + cell;
+                const float y0 = -4.0f + iy * cell, y1 = y0 + cell;
+
+                const SFVEC3F a( x0, y0, height( x0, y0 ) );
+                const SFVEC3F b( x1, y0, height( x1, y0 ) );
+                const SFVEC3F c( x1, y1, height( x1, y1 ) );
+                const SFVEC3F d( x0, y1, height( x0, y1 ) );
+
+                addTriangle( a, b, c );
+                addTriangle( a, c, d );
+            }
+        }
+
+        for( int i = 0; i < 20000; ++i )
+        {
+            // Separate statements, so the random sequence does not depend on the compiler
+            const float x = posDist( rng );
+            const float y = posDist( rng );
+            const float z = -0.1f - sizeDist( rng );
+            const float dx = sizeDist( rng );
+            const float dy = sizeDist( rng );
+            const float dz = sizeDist( rng );
+
+            const SFVEC3F a( x, y, z );
+
+            addTriangle( a, a + SFVEC3F( dx, 0.0f, -dz ), a + SFVEC3F( 0.0f, dy, -dz ) );
+        }
+
+        m_bvh.reset( new CBVH_PBRT( m_container ) );
+        m_camera.SetCurWindowSize( wxSize( IMAGE_SIZE, IMAGE_SIZE ) );
+    }
+
+    ///> Adds a triangle facing the camera
+    void addTriangle( const SFVEC3F& aA, const SFVEC3F& aB, const SFVEC3F& aC )
+    {
+        const bool facesCamera = glm::cross( aC - aA, aB - aA ).z < 0.0f;
+
+        CTRIANGLE* triangle = facesCamera ? new CTRIANGLE( aA, aB, aC )
+                                          : new CTRIANGLE( aA, aC, aB );
+
+        triangle->SetMaterial( &m_material );
+        m_container.Add( triangle );
+    }
+
+    ///> Traces the whole image with packets, returns the number of rays hitting the scene
+    unsigned int tracePackets( std::vector<HITINFO>* aHits = nullptr )
+    {
+        unsigned int hitCount = 0;
+
+        for( int y = 0; y < IMAGE_SIZE; y += RAYPACKET_DIM )
+        {
+            for( int x = 0; x < IMAGE_SIZE; x += RAYPACKET_DIM )
+            {
+                RAYPACKET packet( m_camera, SFVEC2I( x, y ) );
+                HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
+
+                initHitPacket( hitPacket );
+                m_bvh->Intersect( packet, hitPacket );
+
+                for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+                {
+                    hitCount += hitPacket[i].m_hitresult ? 1 : 0;
+
+                    if( aHits )
+                        aHits->push_back( hitPacket[i].m_HitInfo );
+                }
+            }
+        }
+
+        return hitCount;
+    }
+
+    CBLINN_PHONG_MATERIAL       m_material;
+    CCONTAINER                  m_container;
+    std::unique_ptr<CBVH_PBRT>  m_bvh;
+    CTRACK_BALL                 m_camera;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( RayPacket, RayPacketFixture )
+
+
+/**
+ * The vectorised kernels have to give exactly the same results as the scalar ones,
+ * and the packet traversal the same hits as tracing the rays one by one.
+ */
+BOOST_AUTO_TEST_CASE( PacketMatchesSingleRays )
+{
+    const RAYPACKET_SIMD bestLevel = RAYPACKET_GetSimdLevel();
+
+    RAYPACKET_SetSimdLevel( RAYPACKET_SIMD_SCALAR );
+
+    std::vector<HITINFO> expected;
+    const unsigned int hitCount = tracePackets( &expected );
+
+    BOOST_CHECK( hitCount > 0 );
+
+    for( int level = RAYPACKET_SIMD_SSE; level <= bestLevel; ++level )
+    {
+        BOOST_REQUIRE_EQUAL( RAYPACKET_SetSimdLevel( (RAYPACKET_SIMD) level ), level );
+
+        std::vector<HITINFO> found;
+        BOOST_CHECK_EQUAL( tracePackets( &found ), hitCount );
+        BOOST_REQUIRE_EQUAL( found.size(), expected.size() );
+
+        for( size_t i = 0; i < found.size(); ++i )
+        {
+            BOOST_REQUIRE( found[i].pHitObject == expected[i].pHitObject );
+            BOOST_REQUIRE_EQUAL( found[i].m_tHit, expected[i].m_tHit );
+        }
+    }
+
+    RAYPACKET_SetSimdLevel( bestLevel );
+
+    // Single ray traversal uses a different ray/box test, so the rays grazing
+    // the box corners may differ
+    unsigned int mismatches = 0;
+    size_t index = 0;
+
+    for( int y = 0; y < IMAGE_SIZE; y += RAYPACKET_DIM )
+    {
+        for( int x = 0; x < IMAGE_SIZE; x += RAYPACKET_DIM )
+        {
+            RAYPACKET packet( m_camera, SFVEC2I( x, y ) );
+
+            for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i, ++index )
+            {
+                HITINFO hit;
+                hit.m_tHit = std::numeric_limits<float>::infinity();
+                hit.pHitObject = NULL;
+
+                m_bvh->Intersect( packet.m_ray[i], hit );
+
+                if( hit.pHitObject != expected[index].pHitObject )
+                    ++mismatches;
+            }
+        }
+    }
+
+    BOOST_CHECK( mismatches <= expected.size() / 1000 );
+}
+
+
+/**
+ * Primary ray throughput of the packet traversal with each instruction set.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    const int frames = 10;
+    const RAYPACKET_SIMD bestLevel = RAYPACKET_GetSimdLevel();
+    const char* names[] = { "scalar", "SSE", "AVX2" };
+    double scalarTime = 0.0;
+
+    for( int level = RAYPACKET_SIMD_SCALAR; level <= bestLevel; ++level )
+    {
+        RAYPACKET_SetSimdLevel( (RAYPACKET_SIMD) level );
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for( int i = 0; i < frames; ++i )
+            tracePackets();
+
+        const double time = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start ).count();
+
+        if( level == RAYPACKET_SIMD_SCALAR )
+            scalarTime = time;
+
+        const double rays = (double) frames * IMAGE_SIZE * IMAGE_SIZE;
+
+        BOOST_TEST_MESSAGE( names[level] << ": " << time << " ms, "
+                            << rays / time / 1000.0 << " Mrays/s, speedup "
+                            << scalarTime / time );
+    }
+
+    RAYPACKET_SetSimdLevel( bestLevel );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
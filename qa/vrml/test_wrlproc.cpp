@@ -0,0 +1,296 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <wrlproc.h>
+#include <streamwrapper.h>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <chrono>
+#include <clocale>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <thread>
+
+
+/**
+ * The geometry of a generated model file.
+ */
+struct WRL_MODEL
+{
+    std::vector<WRLVEC3F>   m_points;
+    std::vector<int>        m_coordIndex;
+};
+
+
+/**
+ * Reads the "point" and "coordIndex" fields of a file and discards everything else.
+ */
+static bool readModel( const wxString& aFileName, WRL_MODEL& aModel )
+{
+    WRLPROC proc( aFileName );
+    std::string name;
+
+    if( proc.GetVRMLType() != VRML_V2 )
+        return false;
+
+    while( proc.ReadName( name ) )
+    {
+        std::vector<WRLVEC3F> points;
+        std::vector<int> coordIndex;
+
+        if( name == "point" )
+        {
+            if( !proc.ReadMFVec3f( points ) )
+                return false;
+
+            aModel.m_points.insert( aModel.m_points.end(), points.begin(), points.end() );
+        }
+        else if( name == "coordIndex" )
+        {
+            if( !proc.ReadMFInt( coordIndex ) )
+                return false;
+
+            aModel.m_coordIndex.insert( aModel.m_coordIndex.end(), coordIndex.begin(),
+                                        coordIndex.end() );
+        }
+
+        // skip the braces and the remaining fields
+        while( !proc.eof() && ( proc.Peek() == '{' || proc.Peek() == '}' ) )
+            proc.Pop();
+    }
+
+    return proc.eof();
+}
+
+
+/**
+ * A corpus of large generated VRML files, with the layouts written by the common
+ * exporters: one value per line, one triplet per line with commas, and long lines.
+ */
+struct WrlCorpusFixture
+{
+    WrlCorpusFixture() :
+        m_totalBytes( 0 )
+    {
+        std::mt19937 rng( 1 );
+        std::uniform_real_distribution<float> posDist( -10.0f, 10.0f );
+
+        for( int layout = 0; layout < 3; ++layout )
+        {
+            WRL_MODEL model;
+
+            for( int i = 0; i < 300000; ++i )
+            {
+                // Separate statements, so the random sequence does not depend on the compiler
+                const float x = posDist( rng );
+                const float y = posDist( rng );
+                const float z = posDist( rng );
+
+                model.m_points.push_back( WRLVEC3F( x, y, z ) );
+            }
+
+            for( int i = 0; i + 2 < (int) model.m_points.size(); i += 3 )
+            {
+                model.m_coordIndex.push_back( i );
+                model.m_coordIndex.push_back( i + 1 );
+                model.m_coordIndex.push_back( i + 2 );
+                model.m_coordIndex.push_back( -1 );
+            }
+
+            wxString fileName = wxFileName::CreateTempFileName( "qa_vrml" );
+
+            BOOST_REQUIRE( !fileName.empty() );
+            BOOST_REQUIRE( writeModel( fileName, model, layout ) );
+
+            m_totalBytes += wxFileName::GetSize( fileName ).GetValue();
+            m_files.push_back( fileName );
+            m_models.push_back( model );
+        }
+    }
+
+    ~WrlCorpusFixture()
+    {
+        for( const wxString& fileName : m_files )
+            wxRemoveFile( fileName );
+    }
+
+    bool writeModel( const wxString& aFileName, const WRL_MODEL& aModel, int aLayout )
+    {
+        FILE* fp = fopen( aFileName.mb_str(), "wb" );
+
+        if( !fp )
+            return false;
+
+        const char* separators[] = { "\n", ",\r\n", " " };
+        const char* sep = separators[aLayout];
+
+        fprintf( fp, "#VRML V2.0 utf8\n# generated for the parser tests\n" );
+        fprintf( fp, "Shape { geometry IndexedFaceSet {\n coord Coordinate { point [\n" );
+
+        // 9 significant digits, so the floats are read back exactly
+        for( const WRLVEC3F& p : aModel.m_points )
+            fprintf( fp, "%.9g %.9g %.9g%s", p.x, p.y, p.z, sep );
+
+        fprintf( fp, "] }\n coordIndex [\n" );
+
+        for( size_t i = 0; i < aModel.m_coordIndex.size(); ++i )
+            fprintf( fp, "%d,%s", aModel.m_coordIndex[i], ( i % 16 ) == 15 ? "\n" : " " );
+
+        fprintf( fp, "]\n} }\n" );
+
+        return fclose( fp ) == 0;
+    }
+
+    std::vector<wxString>   m_files;
+    std::vector<WRL_MODEL>  m_models;
+    size_t                  m_totalBytes;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( WrlProc, WrlCorpusFixture )
+
+
+/**
+ * The coordinates and indexes have to be read back exactly, whatever the layout.
+ */
+BOOST_AUTO_TEST_CASE( ReadsArrays )
+{
+    for( size_t i = 0; i < m_files.size(); ++i )
+    {
+        WRL_MODEL model;
+
+        BOOST_REQUIRE( readModel( m_files[i], model ) );
+        BOOST_REQUIRE_EQUAL( model.m_points.size(), m_models[i].m_points.size() );
+        BOOST_CHECK( model.m_coordIndex == m_models[i].m_coordIndex );
+
+        for( size_t j = 0; j < model.m_points.size(); ++j )
+            BOOST_REQUIRE( model.m_points[j] == m_models[i].m_points[j] );
+    }
+}
+
+
+/**
+ * Parse throughput of the corpus, reading the files one after the other and in
+ * parallel, as the 3D cache loads the models of a board.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for( const wxString& fileName : m_files )
+    {
+        WRL_MODEL model;
+        BOOST_REQUIRE( readModel( fileName, model ) );
+    }
+
+    const double serialTime = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start ).count();
+
+    start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    std::vector<WRL_MODEL> models( m_files.size() );
+    std::vector<int> results( m_files.size(), 0 );
+
+    for( size_t i = 0; i < m_files.size(); ++i )
+    {
+        threads.push_back( std::thread( [&, i]()
+        {
+            results[i] = readModel( m_files[i], models[i] ) ? 1 : 0;
+        } ) );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    const double parallelTime = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start ).count();
+
+    for( size_t i = 0; i < m_files.size(); ++i )
+    {
+        BOOST_CHECK( results[i] );
+        BOOST_CHECK( models[i].m_coordIndex == m_models[i].m_coordIndex );
+    }
+
+    const double megabytes = m_totalBytes / ( 1024.0 * 1024.0 );
+
+    BOOST_TEST_MESSAGE( m_files.size() << " files, " << megabytes << " MB" );
+    BOOST_TEST_MESSAGE( "serial: " << serialTime << " ms, "
+                        << megabytes / serialTime * 1000.0 << " MB/s" );
+    BOOST_TEST_MESSAGE( "parallel: " << parallelTime << " ms, "
+                        << megabytes / parallelTime * 1000.0 << " MB/s" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE( WrlProcFileName )
+
+
+/**
+ * A model in a directory with non-ASCII characters has to be read in the "C" locale
+ * set by the 3D cache while it loads the models.
+ */
+BOOST_AUTO_TEST_CASE( NonAsciiName )
+{
+    // "qa_vrml_" followed by e acute, a grave and omega
+    wxFileName fn( wxFileName::GetTempDir(),
+                   wxString::FromUTF8( "qa_vrml_\xc3\xa9\xc3\xa0\xce\xa9" ), "wrl" );
+    std::string fileName( fn.GetFullPath().ToUTF8() );
+
+    {
+        OPEN_OSTREAM( output, fileName.c_str() );
+        BOOST_REQUIRE( output.good() );
+
+        output << "#VRML V2.0 utf8\n";
+        output << "Shape { geometry IndexedFaceSet {\n coord Coordinate { point [\n";
+        output << "1 2 3\n4 5 6\n7 8 9\n] }\n coordIndex [\n0, 1, 2, -1,\n]\n} }\n";
+
+        CLOSE_STREAM( output );
+    }
+
+    std::string savedLocale = setlocale( LC_ALL, NULL );
+    setlocale( LC_ALL, "C" );
+
+    WRL_MODEL model;
+    bool ok = readModel( fn.GetFullPath(), model );
+
+    setlocale( LC_ALL, savedLocale.c_str() );
+
+#ifdef _WIN32
+    _wremove( fn.GetFullPath().wc_str() );
+#else
+    remove( fileName.c_str() );
+#endif
+
+    BOOST_REQUIRE( ok );
+    BOOST_CHECK_EQUAL( model.m_points.size(), 3u );
+    BOOST_CHECK_EQUAL( model.m_coordIndex.size(), 4u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
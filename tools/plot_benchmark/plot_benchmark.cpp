@@ -0,0 +1,327 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Plots a large synthetic schematic (sheets full of symbols, wires, texts and a
+ * logo bitmap) with the PDF, SVG and Postscript plotters, and reports the plot
+ * time and the size of the files. The PDF file has one page per sheet, the SVG
+ * and Postscript plotters write one file per sheet, as Eeschema does.
+ */
+
+#include <wx/wx.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <common.h>
+#include <plotter.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+
+using CLOCK = std::chrono::steady_clock;
+using TIME_PT = std::chrono::time_point<CLOCK>;
+
+
+struct BENCH_REPORT
+{
+    unsigned files;
+    wxULongLong bytes;
+    std::chrono::milliseconds benchDurMs;
+};
+
+
+using PLOTTER_FACTORY = std::function<PLOTTER*()>;
+
+struct BENCHMARK
+{
+    char triggerChar;
+    PLOTTER_FACTORY factory;
+    bool multiPage;     ///< true to plot all the sheets in one file
+    wxString name;
+};
+
+
+// Sizes in mils, the plot IUs (as in Eeschema)
+static const int SHEET_WIDTH = 16535;
+static const int SHEET_HEIGHT = 11700;
+static const int SYMBOL_COLS = 10;
+static const int SYMBOL_ROWS = 6;
+
+
+static void plotSymbol( PLOTTER* aPlotter, const wxPoint& aPos, int aIndex )
+{
+    const int pinLen = 100;
+    const wxSize bodySize( 400, 600 );
+
+    aPlotter->SetColor( COLOR4D( RED ) );
+    aPlotter->Rect( aPos, aPos + bodySize, FILLED_WITH_BG_BODYCOLOR, 10 );
+
+    for( int pin = 0; pin < 4; pin++ )
+    {
+        wxPoint left( aPos.x, aPos.y + 100 + pin * 130 );
+        wxPoint right( aPos.x + bodySize.x, left.y );
+
+        aPlotter->MoveTo( left );
+        aPlotter->FinishTo( left - wxPoint( pinLen, 0 ) );
+        aPlotter->MoveTo( right );
+        aPlotter->FinishTo( right + wxPoint( pinLen, 0 ) );
+        aPlotter->Circle( right + wxPoint( pinLen, 0 ), 20, NO_FILL, 6 );
+    }
+
+    const wxSize textSize( 50, 50 );
+
+    aPlotter->Text( aPos + wxPoint( 0, -60 ), COLOR4D( BLUE ),
+                    wxString::Format( "U%d", aIndex ), 0, textSize,
+                    GR_TEXT_HJUSTIFY_LEFT, GR_TEXT_VJUSTIFY_BOTTOM, 6, false, false );
+    aPlotter->Text( aPos + wxPoint( 0, bodySize.y + 60 ), COLOR4D( BLUE ),
+                    "74HC595", 0, textSize,
+                    GR_TEXT_HJUSTIFY_LEFT, GR_TEXT_VJUSTIFY_TOP, 6, false, false );
+}
+
+
+static void plotSheet( PLOTTER* aPlotter, int aSheet, const wxImage& aLogo )
+{
+    aPlotter->SetColor( COLOR4D( BLACK ) );
+    aPlotter->Rect( wxPoint( 200, 200 ), wxPoint( SHEET_WIDTH - 200, SHEET_HEIGHT - 200 ),
+                    NO_FILL, 10 );
+
+    for( int row = 0; row < SYMBOL_ROWS; row++ )
+    {
+        for( int col = 0; col < SYMBOL_COLS; col++ )
+        {
+            wxPoint pos( 800 + col * 1500, 800 + row * 1600 );
+
+            plotSymbol( aPlotter, pos, ( aSheet * SYMBOL_ROWS + row ) * SYMBOL_COLS + col );
+
+            // Wire to the next symbol
+            if( col + 1 < SYMBOL_COLS )
+            {
+                aPlotter->SetColor( COLOR4D( GREEN ) );
+                aPlotter->MoveTo( pos + wxPoint( 500, 100 ) );
+                aPlotter->LineTo( pos + wxPoint( 950, 100 ) );
+                aPlotter->LineTo( pos + wxPoint( 950, 490 ) );
+                aPlotter->FinishTo( pos + wxPoint( 1400, 490 ) );
+            }
+        }
+    }
+
+    aPlotter->PlotImage( aLogo, wxPoint( SHEET_WIDTH - 1500, SHEET_HEIGHT - 700 ), 5.0 );
+
+    aPlotter->Text( wxPoint( SHEET_WIDTH - 3000, SHEET_HEIGHT - 400 ), COLOR4D( BLACK ),
+                    wxString::Format( "Sheet %d", aSheet + 1 ), 0, wxSize( 80, 80 ),
+                    GR_TEXT_HJUSTIFY_LEFT, GR_TEXT_VJUSTIFY_CENTER, 12, false, true );
+}
+
+
+static void setupPage( PLOTTER* aPlotter )
+{
+    PAGE_INFO page( PAGE_INFO::A3 );
+
+    aPlotter->SetPageSettings( page );
+    aPlotter->SetViewport( wxPoint( 0, 0 ), 0.1, 1.0, false );
+}
+
+
+static bool plotSchematic( const BENCHMARK& aBenchmark, const wxString& aOutputDir,
+                           int aSheets, const wxImage& aLogo, BENCH_REPORT& aReport )
+{
+    std::unique_ptr<PLOTTER> plotter;
+    std::vector<wxString> files;
+
+    for( int sheet = 0; sheet < aSheets; sheet++ )
+    {
+        if( !plotter || !aBenchmark.multiPage )
+        {
+            if( plotter )
+                plotter->EndPlot();
+
+            wxFileName fn( aOutputDir, wxString::Format( "bench-%c-%d", aBenchmark.triggerChar,
+                                                         aBenchmark.multiPage ? 0 : sheet ) );
+
+            plotter.reset( aBenchmark.factory() );
+            fn.SetExt( GetDefaultPlotExtension( plotter->GetPlotterType() ) );
+            files.push_back( fn.GetFullPath() );
+
+            plotter->SetDefaultLineWidth( 6 );
+            plotter->SetColorMode( true );
+            plotter->SetCreator( "plot_benchmark" );
+
+            if( !plotter->OpenFile( fn.GetFullPath() ) )
+                return false;
+
+            setupPage( plotter.get() );
+            plotter->StartPlot();
+        }
+        else
+        {
+            PDF_PLOTTER* pdf = static_cast<PDF_PLOTTER*>( plotter.get() );
+
+            pdf->ClosePage();
+            setupPage( pdf );
+            pdf->StartPage();
+        }
+
+        plotSheet( plotter.get(), sheet, aLogo );
+    }
+
+    if( plotter )
+        plotter->EndPlot();
+
+    plotter.reset();
+
+    for( const wxString& file : files )
+    {
+        aReport.files++;
+        aReport.bytes += wxFileName::GetSize( file );
+        wxRemoveFile( file );
+    }
+
+    return true;
+}
+
+
+/**
+ * List of available benchmarks
+ */
+static std::vector<BENCHMARK> benchmarkList =
+{
+    { 'd', []() { return new PDF_PLOTTER; }, true, "PDF" },
+    { 's', []() { return new SVG_PLOTTER; }, false, "SVG" },
+    { 'p', []() { return new PS_PLOTTER; }, false, "Postscript" },
+};
+
+
+/**
+ * Construct string of all flags used for specifying benchmarks
+ * on the command line
+ */
+static wxString getBenchFlags()
+{
+    wxString flags;
+
+    for( auto& bmark : benchmarkList )
+    {
+        flags << bmark.triggerChar;
+    }
+
+    return flags;
+}
+
+
+/**
+ * Usage description of a benchmark spec
+ */
+static wxString getBenchDescriptions()
+{
+    wxString desc;
+
+    for( auto& bmark : benchmarkList )
+    {
+        desc << "    " << bmark.triggerChar << ": " << bmark.name << "\n";
+    }
+
+    return desc;
+}
+
+
+enum RET_CODES
+{
+    BAD_ARGS = 1,
+    PLOT_ERROR = 2,
+};
+
+
+int main( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 2 )
+    {
+        os << "Usage: " << argv[0] << " <OUTPUT_DIR> [SHEETS] [" << getBenchFlags() << "]\n\n";
+        os << "Default: 200 sheets, all the benchmarks\n";
+        os << "Benchmarks:\n";
+        os << getBenchDescriptions();
+        return BAD_ARGS;
+    }
+
+    wxString outputDir( argv[1] );
+
+    long sheets = 200;
+
+    if( argc >= 3 )
+        wxString( argv[2] ).ToLong( &sheets );
+
+    // get the benchmark to do, or all of them if nothing given
+    wxString bench;
+
+    if( argc >= 4 )
+        bench = argv[3];
+
+    // The same logo on every sheet
+    wxImage logo( 128, 64 );
+
+    for( int y = 0; y < logo.GetHeight(); y++ )
+    {
+        for( int x = 0; x < logo.GetWidth(); x++ )
+            logo.SetRGB( x, y, x * 2, y * 4, ( x ^ y ) & 0xFF );
+    }
+
+    LOCALE_IO toggle;
+
+    os << "Plot Bench Mark Util" << std::endl;
+    os << "  Sheets: " << (int) sheets << std::endl;
+    os << std::endl;
+
+    for( auto& bmark : benchmarkList )
+    {
+        if( bench.size() && !bench.Contains( bmark.triggerChar ) )
+            continue;
+
+        BENCH_REPORT report = {};
+
+        TIME_PT start = CLOCK::now();
+        bool ok = plotSchematic( bmark, outputDir, sheets, logo, report );
+        TIME_PT end = CLOCK::now();
+
+        if( !ok )
+        {
+            os << bmark.name << ": cannot create the plot files in " << outputDir << std::endl;
+            return PLOT_ERROR;
+        }
+
+        using std::chrono::milliseconds;
+        using std::chrono::duration_cast;
+
+        report.benchDurMs = duration_cast<milliseconds>( end - start );
+
+        os << wxString::Format( "%-12s %u files, %s bytes in %u ms",
+                bmark.name, report.files, report.bytes.ToString(),
+                (int) report.benchDurMs.count() )
+            << std::endl;
+    }
+
+    return 0;
+}